@@ -16,6 +16,10 @@ static struct {
 	int mDebug;
 	int mAllowDebugMode; // TODO (https://dev.azure.com/captdc/DogmaRnDA/_workitems/edit/407)
 	int mAllowDebugKeys; // TODO (https://dev.azure.com/captdc/DogmaRnDA/_workitems/edit/407)
+	int mIsRecordingTriggerProfile;
+	int mIsUsingTriggerProfile;
+	int mIsUsingExpressionCache;
+	int mIsLoadingStatesLazily;
 	int mSpeedup; // TODO (https://dev.azure.com/captdc/DogmaRnDA/_workitems/edit/407)
 	char mStartStage[200]; // TODO (https://dev.azure.com/captdc/DogmaRnDA/_workitems/edit/407)
 	int mDifficulty;
@@ -44,6 +48,10 @@ static void loadDebug(MugenDefScript* tScript) {
 	gConfigData.mAllowDebugMode = getMugenDefIntegerOrDefault(tScript, "Debug", "allowdebugmode", 1);
 	gConfigData.mAllowDebugKeys = getMugenDefIntegerOrDefault(tScript, "Debug", "allowdebugkeys", 0);
 	gConfigData.mSpeedup = getMugenDefIntegerOrDefault(tScript, "Debug", "speedup", 0);
+	gConfigData.mIsRecordingTriggerProfile = getMugenDefIntegerOrDefault(tScript, "Debug", "triggerprofilerecord", 0);
+	gConfigData.mIsUsingTriggerProfile = getMugenDefIntegerOrDefault(tScript, "Debug", "triggerprofileuse", 1);
+	gConfigData.mIsUsingExpressionCache = getMugenDefIntegerOrDefault(tScript, "Debug", "expressioncache", 0);
+	gConfigData.mIsLoadingStatesLazily = getMugenDefIntegerOrDefault(tScript, "Debug", "lazystates", 0);
 
 	char* text = getAllocatedMugenDefStringOrDefault(tScript, "Debug", "startstage", "stages/stage0.def");
 	strcpy(gConfigData.mStartStage, text);
@@ -99,6 +107,26 @@ int isMugenDebugActive()
 	return gConfigData.mDebug;
 }
 
+int isDreamTriggerProfileRecordingActive()
+{
+	return gConfigData.mIsRecordingTriggerProfile;
+}
+
+int isDreamTriggerProfileUseActive()
+{
+	return gConfigData.mIsUsingTriggerProfile;
+}
+
+int isDreamExpressionCacheActive()
+{
+	return gConfigData.mIsUsingExpressionCache;
+}
+
+int isDreamLazyStateLoadingActive()
+{
+	return gConfigData.mIsLoadingStatesLazily;
+}
+
 void setDefaultOptionVariables() {
 	gConfigData.mDifficulty = 4;
 	gConfigData.mLifeStartPercentageNumber = 100;
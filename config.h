@@ -11,6 +11,10 @@ double getDreamDefaultAttackDamageDoneToPowerMultiplier();
 double getDreamDefaultAttackDamageReceivedToPowerMultiplier();
 
 int isMugenDebugActive();
+int isDreamTriggerProfileRecordingActive();
+int isDreamTriggerProfileUseActive();
+int isDreamExpressionCacheActive();
+int isDreamLazyStateLoadingActive();
 
 void setDefaultOptionVariables();
 int getDifficulty();
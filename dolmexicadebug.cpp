@@ -1,7 +1,9 @@
 #include "dolmexicadebug.h"
 
 #include <sstream>
+#include <chrono>
 #include <prism/stlutil.h>
+#include <prism/file.h>
 #include <prism/debug.h>
 #include <prism/log.h>
 #include <prism/input.h>
@@ -14,6 +16,7 @@
 #include "fightdebug.h"
 #include "mugencommandhandler.h"
 #include "mugenassignmentevaluator.h"
+#include "mugenstateprofiler.h"
 #include "titlescreen.h"
 #include "storymode.h"
 #include "randomwatchmode.h"
@@ -235,6 +238,255 @@ static string evalCB(void* tCaller, string tCommand) {
 	return ret;
 }
 
+static Vector3D evaluateVectorThroughStringForBenchmark(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer) {
+	string test;
+	evaluateDreamAssignmentAndReturnAsString(test, tAssignment, tPlayer);
+
+	char tX[100], comma1[20], tY[100], comma2[20], tZ[100];
+	int items = sscanf(test.data(), "%99s %19s %99s %19s %99s", tX, comma1, tY, comma2, tZ);
+
+	double x = items >= 1 ? atof(tX) : 0;
+	double y = items >= 3 ? atof(tY) : 0;
+	double z = items >= 5 ? atof(tZ) : 0;
+	return makePosition(x, y, z);
+}
+
+static string evalvectorbenchCB(void* tCaller, string tCommand) {
+	(void)tCaller;
+	vector<string> words = splitCommandString(tCommand);
+	if (words.size() < 4) return "Too few arguments";
+	int id = atoi(words[1].data());
+	int iterations = max(1, atoi(words[2].data()));
+	DreamPlayer* p = getRootPlayer(id);
+
+	int n = tCommand.find(' ', tCommand.find(' ', tCommand.find(' ') + 1) + 1) + 1;
+	string assignmentString = tCommand.substr(n);
+	char buffer[1024];
+	strcpy(buffer, assignmentString.c_str());
+
+	auto assignment = parseDreamMugenAssignmentFromString(buffer);
+	compileDreamAssignmentProgram(&assignment);
+	Vector3D stringResult, nativeResult;
+
+	auto start = chrono::steady_clock::now();
+	for (int i = 0; i < iterations; i++) stringResult = evaluateVectorThroughStringForBenchmark(&assignment, p);
+	auto middle = chrono::steady_clock::now();
+	for (int i = 0; i < iterations; i++) nativeResult = evaluateDreamAssignmentAndReturnAsVector3D(&assignment, p);
+	auto end = chrono::steady_clock::now();
+	destroyDreamMugenAssignment(assignment);
+
+	ostringstream ss;
+	ss << "string: " << chrono::duration_cast<chrono::microseconds>(middle - start).count() << "us (" << stringResult.x << ", " << stringResult.y << ", " << stringResult.z << ")";
+	ss << " native: " << chrono::duration_cast<chrono::microseconds>(end - middle).count() << "us (" << nativeResult.x << ", " << nativeResult.y << ", " << nativeResult.z << ")";
+	return ss.str();
+}
+
+static string memoCB(void* tCaller, string tCommand) {
+	(void)tCaller;
+	vector<string> words = splitCommandString(tCommand);
+	if (words.size() >= 2) {
+		if (words[1] == "on") setDreamAssignmentMemoizationActive(1);
+		else if (words[1] == "off") setDreamAssignmentMemoizationActive(0);
+		else if (words[1] == "reset") resetDreamAssignmentMemoStatistics();
+		else return "Unknown memo option, use on, off or reset.";
+	}
+
+	uint32_t hits, misses;
+	getDreamAssignmentMemoStatistics(&hits, &misses);
+	uint32_t total = hits + misses;
+	ostringstream ss;
+	ss << "memo " << (isDreamAssignmentMemoizationActive() ? "on" : "off") << ": " << hits << " hits, " << misses << " misses";
+	if (total) ss << " (" << (100.0 * hits / total) << "% hit rate)";
+	return ss.str();
+}
+
+static string stateprofileCB(void* tCaller, string tCommand) {
+	(void)tCaller;
+	vector<string> words = splitCommandString(tCommand);
+	int amount = 10;
+	if (words.size() >= 2) {
+		if (words[1] == "on") setDreamStateProfilerActive(1);
+		else if (words[1] == "off") setDreamStateProfilerActive(0);
+		else if (words[1] == "reset") resetDreamStateProfiler();
+		else if (words[1] == "top" && words.size() >= 3) amount = atoi(words[2].data());
+		else if (words[1] == "write") {
+			string path = words.size() >= 3 ? words[2] : "debug/stateprofile.csv";
+			int entryAmount = writeDreamStateProfile(path.data());
+			if (!entryAmount) return "Nothing profiled, use stateprofile on and play first.";
+			return "Wrote " + to_string(entryAmount) + " state profile entries to " + path;
+		}
+		else return "Unknown stateprofile option, use on, off, reset, top <n> or write.";
+	}
+
+	return getDreamStateProfilerReport(amount);
+}
+
+typedef struct {
+	int mElementAmount;
+} ParseBenchmarkCaller;
+
+static void parsebenchElementCB(ParseBenchmarkCaller* tCaller, const string& tKey, MugenDefScriptGroupElement& tData) {
+	(void)tKey;
+	DreamMugenAssignment* assignment;
+	fetchDreamAssignmentFromGroupAsElement(&tData, &assignment);
+	destroyDreamMugenAssignment(assignment);
+	tCaller->mElementAmount++;
+}
+
+static void addParseBenchmarkScript(vector<MugenDefScript>& tScripts, const char* tPath) {
+	if (!isFile(tPath)) return;
+	MugenDefScript script;
+	loadMugenDefScript(&script, tPath);
+	tScripts.push_back(script);
+}
+
+static void loadCharacterBenchmarkScripts(vector<MugenDefScript>& tScripts, const char* tDefinitionPath) {
+	MugenDefScript defScript;
+	loadMugenDefScript(&defScript, tDefinitionPath);
+	char path[1024];
+	char file[200];
+	char scriptPath[1024];
+	char name[100];
+	getPathToFile(path, tDefinitionPath);
+
+	const char* fileNames[] = { "cmd", "cns", "st" };
+	for (int i = 0; i < 3; i++) {
+		getMugenDefStringOrDefault(file, &defScript, "Files", fileNames[i], "");
+		sprintf(scriptPath, "%s%s", path, file);
+		addParseBenchmarkScript(tScripts, scriptPath);
+	}
+	getMugenDefStringOrDefault(file, &defScript, "Files", "stcommon", "");
+	sprintf(scriptPath, "%s%s", path, file);
+	if (!isFile(scriptPath)) sprintf(scriptPath, "assets/data/%s", file);
+	addParseBenchmarkScript(tScripts, scriptPath);
+	for (int i = 0; i < 100; i++) {
+		sprintf(name, "st%d", i);
+		getMugenDefStringOrDefault(file, &defScript, "Files", name, "");
+		sprintf(scriptPath, "%s%s", path, file);
+		addParseBenchmarkScript(tScripts, scriptPath);
+	}
+	unloadMugenDefScript(defScript);
+}
+
+static string parsebenchCB(void* tCaller, string tCommand) {
+	(void)tCaller;
+	vector<string> words = splitCommandString(tCommand);
+	if (words.size() < 3) return "Too few arguments";
+	if (!isFile(words[1].data())) return "Unable to find character definition.";
+	int iterations = max(1, atoi(words[2].data()));
+
+	vector<MugenDefScript> scripts;
+	loadCharacterBenchmarkScripts(scripts, words[1].data());
+
+	ParseBenchmarkCaller caller;
+	caller.mElementAmount = 0;
+	auto start = chrono::steady_clock::now();
+	for (int i = 0; i < iterations; i++) {
+		for (auto& script : scripts) {
+			for (MugenDefScriptGroup* group = script.mFirstGroup; group; group = group->mNext) {
+				stl_string_map_map(group->mElements, parsebenchElementCB, &caller);
+			}
+		}
+	}
+	auto end = chrono::steady_clock::now();
+	for (auto& script : scripts) {
+		unloadMugenDefScript(script);
+	}
+
+	ostringstream ss;
+	ss << scripts.size() << " files, " << caller.mElementAmount / iterations << " assignments: " << chrono::duration_cast<chrono::microseconds>(end - start).count() / iterations << "us per load";
+	return ss.str();
+}
+
+typedef struct {
+	string mText;
+	DreamMugenAssignment* mAssignment;
+	DreamMugenAssignment* mTree; // owned by the compiled program in mAssignment
+	uint64_t mNanoseconds;
+} EvalBenchmarkExpression;
+
+typedef struct {
+	vector<EvalBenchmarkExpression> mExpressions;
+	int mSkippedAmount;
+} EvalBenchmarkCaller;
+
+static void evalbenchElementCB(EvalBenchmarkCaller* tCaller, const string& tKey, MugenDefScriptGroupElement& tData) {
+	if (tKey.compare(0, 7, "trigger")) return;
+
+	char* text = getAllocatedMugenDefStringVariableForAssignmentAsElement(&tData);
+	EvalBenchmarkExpression e;
+	e.mText = text;
+	e.mAssignment = parseDreamMugenAssignmentFromString(text);
+	freeMemory(text);
+	if (!isDreamAssignmentFreeOfSideEffects(e.mAssignment)) {
+		destroyDreamMugenAssignment(e.mAssignment);
+		tCaller->mSkippedAmount++;
+		return;
+	}
+	compileDreamAssignmentProgram(&e.mAssignment);
+	e.mTree = e.mAssignment->mType == MUGEN_ASSIGNMENT_TYPE_PROGRAM ? ((DreamMugenProgramAssignment*)e.mAssignment)->mTree : e.mAssignment;
+	tCaller->mExpressions.push_back(e);
+}
+
+static string evalbenchCB(void* tCaller, string tCommand) {
+	(void)tCaller;
+	vector<string> words = splitCommandString(tCommand);
+	if (words.size() < 4) return "Too few arguments";
+	DreamPlayer* p = getRootPlayer(atoi(words[1].data()));
+	if (!isFile(words[2].data())) return "Unable to find character definition.";
+	int iterations = max(1, atoi(words[3].data()));
+	string path = words.size() >= 5 ? words[4] : "debug/evalbench.txt";
+
+	vector<MugenDefScript> scripts;
+	loadCharacterBenchmarkScripts(scripts, words[2].data());
+	EvalBenchmarkCaller caller;
+	caller.mSkippedAmount = 0;
+	for (auto& script : scripts) {
+		for (MugenDefScriptGroup* group = script.mFirstGroup; group; group = group->mNext) {
+			stl_string_map_map(group->mElements, evalbenchElementCB, &caller);
+		}
+		unloadMugenDefScript(script);
+	}
+
+	uint64_t totalNanoseconds = 0;
+	for (auto& e : caller.mExpressions) {
+		auto start = chrono::steady_clock::now();
+		for (int i = 0; i < iterations; i++) {
+			evaluateDreamAssignment(&e.mAssignment, p);
+		}
+		auto end = chrono::steady_clock::now();
+		e.mNanoseconds = chrono::duration_cast<chrono::nanoseconds>(end - start).count() / iterations;
+		totalNanoseconds += e.mNanoseconds;
+	}
+
+	// one line per trigger, slowest first
+	stable_sort(caller.mExpressions.begin(), caller.mExpressions.end(), [](const EvalBenchmarkExpression& a, const EvalBenchmarkExpression& b) { return a.mNanoseconds > b.mNanoseconds; });
+	ostringstream file;
+	for (auto& e : caller.mExpressions) {
+		file << e.mNanoseconds << "ns\t" << getDreamMugenAssignmentTypeName(e.mTree->mType) << "\t" << e.mText << "\n";
+	}
+	string text = file.str();
+	bufferToFile(path.data(), makeBuffer((void*)text.c_str(), text.size()));
+
+	// only side effect free triggers are collected and nothing advances in between, so both evaluators see the same player snapshot
+	int mismatchAmount = 0;
+	for (auto& e : caller.mExpressions) {
+		string result, treeResult;
+		evaluateDreamAssignmentAndReturnAsString(result, &e.mAssignment, p);
+		DreamMugenAssignment* tree = e.mTree;
+		evaluateDreamAssignmentAndReturnAsString(treeResult, &tree, p);
+		destroyDreamMugenAssignment(e.mAssignment);
+		if (result != treeResult) {
+			logWarningFormat("evalbench mismatch for %s: tree returned %s, program returned %s", e.mText.data(), treeResult.data(), result.data());
+			mismatchAmount++;
+		}
+	}
+
+	ostringstream ss;
+	ss << caller.mExpressions.size() << " triggers (" << caller.mSkippedAmount << " skipped): " << totalNanoseconds << "ns per pass, " << mismatchAmount << " mismatches between tree and program, timings written to " << path;
+	return ss.str();
+}
+
 static string evalhelperCB(void* tCaller, string tCommand) {
 	(void)tCaller;
 	vector<string> words = splitCommandString(tCommand);
@@ -377,6 +629,11 @@ void initDolmexicaDebug()
 	addPrismDebugConsoleCommand("testcommandn", testcommandNumberCB);
 	addPrismDebugConsoleCommand("eval", evalCB);
 	addPrismDebugConsoleCommand("evalhelper", evalhelperCB);
+	addPrismDebugConsoleCommand("evalvectorbench", evalvectorbenchCB);
+	addPrismDebugConsoleCommand("parsebench", parsebenchCB);
+	addPrismDebugConsoleCommand("evalbench", evalbenchCB);
+	addPrismDebugConsoleCommand("memo", memoCB);
+	addPrismDebugConsoleCommand("stateprofile", stateprofileCB);
 	addPrismDebugConsoleCommand("trackvar", trackvarCB);
 	addPrismDebugConsoleCommand("untrackvar", untrackvarCB);
 	addPrismDebugConsoleCommand("state", stateCB);
@@ -26,6 +26,8 @@
 #include "mugenexplod.h"
 #include "gamelogic.h"
 #include "config.h"
+#include "mugentriggerprofile.h"
+#include "mugenstateprofiler.h"
 #include "playerhitdata.h"
 #include "titlescreen.h"
 #include "projectile.h"
@@ -64,6 +66,7 @@ static void setFightScreenGameSpeed() {
 }
 
 extern int gDebugAssignmentAmount;
+extern int gDebugSharedAssignmentAmount;
 extern int gDebugStateControllerAmount;
 extern int gDebugStringMapAmount;
 extern int gPruneAmount;
@@ -81,6 +84,7 @@ static void loadFightScreen() {
 	logg("init evaluators");
 	
 	gDebugAssignmentAmount = 0;
+	gDebugSharedAssignmentAmount = 0;
 	gDebugStateControllerAmount = 0;
 	gDebugStringMapAmount = 0;
 	gPruneAmount = 0;
@@ -155,6 +159,7 @@ static void loadFightScreen() {
 	logMemoryPlatform();
 
 	logFormat("assignments: %d", gDebugAssignmentAmount);
+	logFormat("shared assignments: %d", gDebugSharedAssignmentAmount);
 	logFormat("controllers: %d", gDebugStateControllerAmount);
 	logFormat("maps: %d", gDebugStringMapAmount);
 	logFormat("memory blocks: %d", getAllocatedMemoryBlockAmount());
@@ -163,6 +168,8 @@ static void loadFightScreen() {
 
 static void unloadFightScreen() {
 	unloadPlayers();
+	saveDreamMugenTriggerProfiles();
+	saveDreamStateProfile();
 	resetGameMode();
 	shutdownDreamMugenStateControllerHandler();
 	shutdownDreamAssignmentEvaluator();
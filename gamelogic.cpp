@@ -205,8 +205,18 @@ static void loadGameLogic(void* tData) {
 	startRound();
 }
 
+// states of lazily loaded characters are parsed a few at a time while the intro runs, so fewer of them are parsed mid fight
+#define INTRO_STATE_WARM_UP_AMOUNT 4
+
+static void warmUpPlayerStates() {
+	for (int i = 0; i < 2; i++) {
+		warmUpDreamMugenStates(&getRootPlayer(i)->mHeader->mFiles.mConstants.mStates, INTRO_STATE_WARM_UP_AMOUNT);
+	}
+}
+
 static void updateIntro() {
 	if (!gGameLogicData.mIsDisplayingIntro) return;
+	warmUpPlayerStates();
 	
 	if (gGameLogicData.mIsDisplayingIntro == 2) {
 		gGameLogicData.mIsDisplayingIntro--;
@@ -3,7 +3,9 @@
 #include <stdio.h>
 #include <string.h>
 #include <assert.h>
+#include <ctype.h>
 #include <math.h>
+#include <unordered_map>
 
 #include <prism/memoryhandler.h>
 #include <prism/log.h>
@@ -15,13 +17,50 @@
 #include "playerhitdata.h"
 #include "gamelogic.h"
 #include "mugencommandhandler.h"
+#include "mugenassignmentevaluator.h"
+#include "mugenassignmentcache.h"
 
 using namespace std;
 
 int gDebugAssignmentAmount;
+int gDebugSharedAssignmentAmount;
+
+typedef struct {
+	uint8_t mType;
+	uint8_t mFlags;
+	int mTextLength;
+	int64_t mValue;
+	const void* mPointer;
+	const char* mText;
+	DreamMugenAssignment* a;
+	DreamMugenAssignment* b;
+} MugenAssignmentInternKey;
+
+struct MugenAssignmentInternKeyHash {
+	size_t operator()(const MugenAssignmentInternKey& tKey) const {
+		uint64_t hash = 14695981039346656037ULL;
+		auto combine = [&](uint64_t tValue) { hash = (hash ^ tValue) * 1099511628211ULL; };
+		combine(tKey.mType);
+		combine(tKey.mFlags);
+		combine((uint64_t)tKey.mValue);
+		combine((uint64_t)(uintptr_t)tKey.mPointer);
+		combine((uint64_t)(uintptr_t)tKey.a);
+		combine((uint64_t)(uintptr_t)tKey.b);
+		for (int i = 0; i < tKey.mTextLength; i++) combine((uint8_t)tKey.mText[i]);
+		return (size_t)hash;
+	}
+};
+
+struct MugenAssignmentInternKeyEqual {
+	bool operator()(const MugenAssignmentInternKey& a, const MugenAssignmentInternKey& b) const {
+		return a.mType == b.mType && a.mFlags == b.mFlags && a.mValue == b.mValue && a.mPointer == b.mPointer && a.a == b.a && a.b == b.b
+			&& a.mTextLength == b.mTextLength && !memcmp(a.mText, b.mText, a.mTextLength);
+	}
+};
 
 static struct {
 	MemoryStack* mMemoryStack;
+	std::unordered_map<MugenAssignmentInternKey, DreamMugenAssignment*, MugenAssignmentInternKeyHash, MugenAssignmentInternKeyEqual> mInternedAssignments;
 
 	int mHasCommandHandlerEntryForLookup;
 	int mCommandHandlerID;
@@ -29,11 +68,13 @@ static struct {
 
 void setupDreamAssignmentReader(MemoryStack* tMemoryStack) {
 	gMugenAssignmentData.mMemoryStack = tMemoryStack;
+	gMugenAssignmentData.mInternedAssignments.clear();
 }
 
 void shutdownDreamAssignmentReader()
 {
 	gMugenAssignmentData.mMemoryStack = NULL;
+	gMugenAssignmentData.mInternedAssignments.clear();
 }
 
 void setDreamAssignmentCommandLookupID(int tID)
@@ -52,12 +93,46 @@ static void* allocMemoryOnMemoryStackOrMemory(uint32_t tSize) {
 	else return allocMemory(tSize);
 }
 
+// nodes are only shared while parsing onto a memory stack, those trees are never destroyed individually
+static MugenAssignmentInternKey makeMugenAssignmentInternKey(uint8_t tType) {
+	MugenAssignmentInternKey ret;
+	memset(&ret, 0, sizeof(MugenAssignmentInternKey));
+	ret.mType = tType;
+	return ret;
+}
+
+static DreamMugenAssignment* findInternedMugenAssignment(const MugenAssignmentInternKey& tKey) {
+	if (!gMugenAssignmentData.mMemoryStack) return NULL;
+
+	auto it = gMugenAssignmentData.mInternedAssignments.find(tKey);
+	if (it == gMugenAssignmentData.mInternedAssignments.end()) return NULL;
+	gDebugSharedAssignmentAmount++;
+	return it->second;
+}
+
+static DreamMugenAssignment* internMugenAssignment(const MugenAssignmentInternKey& tKey, DreamMugenAssignment* tAssignment) {
+	if (!gMugenAssignmentData.mMemoryStack) return tAssignment;
+
+	gMugenAssignmentData.mInternedAssignments[tKey] = tAssignment;
+	return tAssignment;
+}
+
+static DreamMugenAssignment* makeMugenFixedBooleanAssignment(DreamMugenAssignmentType tType, uint8_t tValue) {
+	MugenAssignmentInternKey key = makeMugenAssignmentInternKey(tType);
+	key.mValue = tValue;
+	DreamMugenAssignment* shared = findInternedMugenAssignment(key);
+	if (shared) return shared;
+
+	DreamMugenFixedBooleanAssignment* data = (DreamMugenFixedBooleanAssignment*)allocMemoryOnMemoryStackOrMemory(sizeof(DreamMugenFixedBooleanAssignment));
+	gDebugAssignmentAmount++;
+	data->mType = tType;
+	data->mValue = tValue;
+	return internMugenAssignment(key, (DreamMugenAssignment*)data);
+}
+
 DreamMugenAssignment * makeDreamTrueMugenAssignment()
 {
-	DreamMugenFixedBooleanAssignment* data = (DreamMugenFixedBooleanAssignment*)allocMemoryOnMemoryStackOrMemory(sizeof(DreamMugenFixedBooleanAssignment));
-	data->mType = MUGEN_ASSIGNMENT_TYPE_FIXED_BOOLEAN;
-	data->mValue = 1;
-	return (DreamMugenAssignment*)data;
+	return makeMugenFixedBooleanAssignment(MUGEN_ASSIGNMENT_TYPE_FIXED_BOOLEAN, 1);
 }
 
 void destroyDreamFalseMugenAssignment(DreamMugenAssignment* tAssignment) {
@@ -111,6 +186,40 @@ static void unloadDreamMugenAssignmentRawVariable(DreamMugenAssignment * tAssign
 	freeMemory(e->mName);
 }
 
+static void unloadDreamMugenAssignmentRedirect(DreamMugenAssignment * tAssignment) {
+	DreamMugenRedirectAssignment* e = (DreamMugenRedirectAssignment*)tAssignment;
+	if (e->mIndex) destroyDreamMugenAssignment(e->mIndex);
+}
+
+static void unloadDreamMugenAssignmentConditional(DreamMugenAssignment * tAssignment) {
+	DreamMugenConditionalAssignment* e = (DreamMugenConditionalAssignment*)tAssignment;
+	destroyDreamMugenAssignment(e->mCondition);
+	destroyDreamMugenAssignment(e->mTrue);
+	destroyDreamMugenAssignment(e->mFalse);
+}
+
+static void unloadDreamMugenAssignmentProgram(DreamMugenAssignment * tAssignment) {
+	DreamMugenProgramAssignment* e = (DreamMugenProgramAssignment*)tAssignment;
+	freeMemory(e->mInstructions);
+	if (e->mStatics) {
+		freeMemory(e->mStatics);
+	}
+	destroyDreamMugenAssignment(e->mTree);
+}
+
+static const char* gDreamMugenAssignmentTypeNames[] = {
+	"fixedboolean", "and", "or", "comparison", "inequality", "lessorequal", "greaterorequal", "vector", "range", "null",
+	"negation", "variable", "rawvariable", "number", "float", "string", "array", "less", "greater", "addition",
+	"multiplication", "modulo", "subtraction", "setvariable", "division", "exponentiation", "unaryminus", "operatorargument", "bitwiseand", "bitwiseor",
+	"static", "program", "trigger", "redirect", "flags", "conditional",
+};
+
+const char* getDreamMugenAssignmentTypeName(uint8_t tType)
+{
+	if (tType >= sizeof(gDreamMugenAssignmentTypeNames) / sizeof(gDreamMugenAssignmentTypeNames[0])) return "unknown";
+	return gDreamMugenAssignmentTypeNames[tType];
+}
+
 void destroyDreamMugenAssignment(DreamMugenAssignment * tAssignment)
 {
 	switch (tAssignment->mType) {
@@ -153,8 +262,18 @@ void destroyDreamMugenAssignment(DreamMugenAssignment * tAssignment)
 		unloadDreamMugenAssignmentVariable(tAssignment);
 		break;
 	case MUGEN_ASSIGNMENT_TYPE_RAW_VARIABLE:
+	case MUGEN_ASSIGNMENT_TYPE_TRIGGER:
 		unloadDreamMugenAssignmentRawVariable(tAssignment);
 		break;
+	case MUGEN_ASSIGNMENT_TYPE_REDIRECT:
+		unloadDreamMugenAssignmentRedirect(tAssignment);
+		break;
+	case MUGEN_ASSIGNMENT_TYPE_FLAGS:
+		unloadDreamMugenAssignmentFixedBoolean(tAssignment);
+		break;
+	case MUGEN_ASSIGNMENT_TYPE_CONDITIONAL:
+		unloadDreamMugenAssignmentConditional(tAssignment);
+		break;
 	case MUGEN_ASSIGNMENT_TYPE_NUMBER:
 		unloadDreamMugenAssignmentNumber(tAssignment);
 		break;
@@ -164,6 +283,9 @@ void destroyDreamMugenAssignment(DreamMugenAssignment * tAssignment)
 	case MUGEN_ASSIGNMENT_TYPE_STRING:
 		unloadDreamMugenAssignmentString(tAssignment);
 		break;	
+	case MUGEN_ASSIGNMENT_TYPE_PROGRAM:
+		unloadDreamMugenAssignmentProgram(tAssignment);
+		break;
 	default:
 		logWarningFormat("Unrecognized assignment format %d. Treating as NULL.\n", tAssignment->mType);
 		unloadDreamMugenAssignmentFixedBoolean(tAssignment);
@@ -175,95 +297,170 @@ void destroyDreamMugenAssignment(DreamMugenAssignment * tAssignment)
 
 DreamMugenAssignment * makeDreamFalseMugenAssignment()
 {
-	DreamMugenFixedBooleanAssignment* data = (DreamMugenFixedBooleanAssignment*)allocMemoryOnMemoryStackOrMemory(sizeof(DreamMugenFixedBooleanAssignment));
-	gDebugAssignmentAmount++;
-	data->mType = MUGEN_ASSIGNMENT_TYPE_FIXED_BOOLEAN;
-	data->mValue = 0;
-	return (DreamMugenAssignment*)data;
+	return makeMugenFixedBooleanAssignment(MUGEN_ASSIGNMENT_TYPE_FIXED_BOOLEAN, 0);
 }
 
 static DreamMugenAssignment * makeMugenOneElementAssignment(DreamMugenAssignmentType tType, DreamMugenAssignment * a) 
 {
+	MugenAssignmentInternKey key = makeMugenAssignmentInternKey(tType);
+	key.a = a;
+	DreamMugenAssignment* shared = findInternedMugenAssignment(key);
+	if (shared) return shared;
 
 	DreamMugenDependOnOneAssignment* data = (DreamMugenDependOnOneAssignment*)allocMemoryOnMemoryStackOrMemory(sizeof(DreamMugenDependOnOneAssignment));
 	gDebugAssignmentAmount++;
 	data->a = a;
 	data->mType = tType;
-	return (DreamMugenAssignment*)data;
+	return internMugenAssignment(key, (DreamMugenAssignment*)data);
 }
 
 
 static DreamMugenAssignment * makeMugenTwoElementAssignment(DreamMugenAssignmentType tType, DreamMugenAssignment * a, DreamMugenAssignment * b)
 {
+	MugenAssignmentInternKey key = makeMugenAssignmentInternKey(tType);
+	key.a = a;
+	key.b = b;
+	DreamMugenAssignment* shared = findInternedMugenAssignment(key);
+	if (shared) return shared;
+
 	DreamMugenDependOnTwoAssignment* data = (DreamMugenDependOnTwoAssignment*)allocMemoryOnMemoryStackOrMemory(sizeof(DreamMugenDependOnTwoAssignment));
 	gDebugAssignmentAmount++;
 	data->a = a;
 	data->b = b;
 	data->mType = tType;
-	return (DreamMugenAssignment*)data;
+	return internMugenAssignment(key, (DreamMugenAssignment*)data);
 }
 
-extern std::map<string, AssignmentReturnValue*(*)(DreamMugenAssignment**, DreamPlayer*, int*)>& getActiveMugenAssignmentArrayMap();
+extern void* findMugenAssignmentArrayFunction(const char* tName);
 
-static DreamMugenAssignment * makeMugenArrayAssignment(char* tName, DreamMugenAssignment * tIndex)
-{
-	std::map<string, AssignmentReturnValue*(*)(DreamMugenAssignment**, DreamPlayer*, int*)>& m = getActiveMugenAssignmentArrayMap();
+static DreamMugenAssignment* makeMugenConditionalNode(uint8_t tIsEager, DreamMugenAssignment* tCondition, DreamMugenAssignment* tTrue, DreamMugenAssignment* tFalse) {
+	MugenAssignmentInternKey key = makeMugenAssignmentInternKey(MUGEN_ASSIGNMENT_TYPE_CONDITIONAL);
+	key.mFlags = tIsEager;
+	key.mPointer = tCondition;
+	key.a = tTrue;
+	key.b = tFalse;
+	DreamMugenAssignment* shared = findInternedMugenAssignment(key);
+	if (shared) return shared;
 
-	string s = string(tName);
-	if (!stl_map_contains(m, s)) {
-		logWarningFormat("Unrecognized array %s\n. Defaulting to bottom.", tName);
-		DreamMugenAssignment* bottomReplacementReturn = makeDreamFalseMugenAssignment();
-		return bottomReplacementReturn;
+	DreamMugenConditionalAssignment* data = (DreamMugenConditionalAssignment*)allocMemoryOnMemoryStackOrMemory(sizeof(DreamMugenConditionalAssignment));
+	gDebugAssignmentAmount++;
+	data->mType = MUGEN_ASSIGNMENT_TYPE_CONDITIONAL;
+	data->mIsEager = tIsEager;
+	data->mCondition = tCondition;
+	data->mTrue = tTrue;
+	data->mFalse = tFalse;
+	return internMugenAssignment(key, (DreamMugenAssignment*)data);
+}
+
+// cond only ever evaluates the chosen branch, ifelse evaluates both like MUGEN unless neither branch has side effects
+static DreamMugenAssignment* makeMugenConditionalAssignment(int tIsLazy, DreamMugenAssignment* tIndex) {
+	if (tIndex->mType != MUGEN_ASSIGNMENT_TYPE_VECTOR) return NULL;
+	DreamMugenDependOnTwoAssignment* firstVector = (DreamMugenDependOnTwoAssignment*)tIndex;
+	if (firstVector->b->mType != MUGEN_ASSIGNMENT_TYPE_VECTOR) return NULL;
+	DreamMugenDependOnTwoAssignment* secondVector = (DreamMugenDependOnTwoAssignment*)firstVector->b;
+
+	DreamMugenAssignment* condition = firstVector->a;
+	DreamMugenAssignment* yes = secondVector->a;
+	DreamMugenAssignment* no = secondVector->b;
+	uint8_t isEager = !tIsLazy && (!isDreamAssignmentFreeOfSideEffects(yes) || !isDreamAssignmentFreeOfSideEffects(no));
+	DreamMugenAssignment* ret = makeMugenConditionalNode(isEager, condition, yes, no);
+
+	if (!gMugenAssignmentData.mMemoryStack) {
+		freeMemory(secondVector);
+		freeMemory(firstVector);
 	}
-	AssignmentReturnValue*(*func)(DreamMugenAssignment**, DreamPlayer*, int*) = m[s];
+	return ret;
+}
+
+static DreamMugenAssignment* makeMugenArrayFunctionAssignment(void* tFunc, DreamMugenAssignment* tIndex) {
+	MugenAssignmentInternKey key = makeMugenAssignmentInternKey(MUGEN_ASSIGNMENT_TYPE_ARRAY);
+	key.mPointer = tFunc;
+	key.a = tIndex;
+	DreamMugenAssignment* shared = findInternedMugenAssignment(key);
+	if (shared) return shared;
 
 	DreamMugenArrayAssignment* data = (DreamMugenArrayAssignment*)allocMemoryOnMemoryStackOrMemory(sizeof(DreamMugenArrayAssignment));
 	gDebugAssignmentAmount++;
-	data->mFunc = (void*)func;
+	data->mFunc = tFunc;
 	data->mIndex = tIndex;
 	data->mType = MUGEN_ASSIGNMENT_TYPE_ARRAY;
-	return (DreamMugenAssignment*)data;
+	return internMugenAssignment(key, (DreamMugenAssignment*)data);
+}
+
+static DreamMugenAssignment * makeMugenArrayAssignment(char* tName, DreamMugenAssignment * tIndex)
+{
+	void* func = findMugenAssignmentArrayFunction(tName);
+	if (!func) {
+		logWarningFormat("Unrecognized array %s\n. Defaulting to bottom.", tName);
+		DreamMugenAssignment* bottomReplacementReturn = makeDreamFalseMugenAssignment();
+		return bottomReplacementReturn;
+	}
+
+	string s = string(tName);
+
+	if (s == "cond" || s == "ifelse" || s == "sifelse") {
+		DreamMugenAssignment* conditional = makeMugenConditionalAssignment(s == "cond", tIndex);
+		if (conditional) return conditional;
+	}
+
+	return makeMugenArrayFunctionAssignment(func, tIndex);
 }
 
 DreamMugenAssignment * makeDreamNumberMugenAssignment(int tVal)
 {
+	MugenAssignmentInternKey key = makeMugenAssignmentInternKey(MUGEN_ASSIGNMENT_TYPE_NUMBER);
+	key.mValue = tVal;
+	DreamMugenAssignment* shared = findInternedMugenAssignment(key);
+	if (shared) return shared;
 
 	DreamMugenNumberAssignment* number = (DreamMugenNumberAssignment*)allocMemoryOnMemoryStackOrMemory(sizeof(DreamMugenNumberAssignment));
 	gDebugAssignmentAmount++;
 	number->mValue = tVal;
 	number->mType = MUGEN_ASSIGNMENT_TYPE_NUMBER;
-	return (DreamMugenAssignment*)number;
+	return internMugenAssignment(key, (DreamMugenAssignment*)number);
 }
 
 DreamMugenAssignment * makeDreamFloatMugenAssignment(double tVal)
 {
+	MugenAssignmentInternKey key = makeMugenAssignmentInternKey(MUGEN_ASSIGNMENT_TYPE_FLOAT);
+	memcpy(&key.mValue, &tVal, sizeof(double));
+	DreamMugenAssignment* shared = findInternedMugenAssignment(key);
+	if (shared) return shared;
+
 	DreamMugenFloatAssignment* f = (DreamMugenFloatAssignment*)allocMemoryOnMemoryStackOrMemory(sizeof(DreamMugenFloatAssignment));
 	gDebugAssignmentAmount++;
 	f->mValue = tVal;
 	f->mType = MUGEN_ASSIGNMENT_TYPE_FLOAT;
 
-	return (DreamMugenAssignment*)f;
+	return internMugenAssignment(key, (DreamMugenAssignment*)f);
 }
 
-DreamMugenAssignment * makeDreamStringMugenAssignment(const char * tVal)
-{
+static DreamMugenAssignment* makeMugenStringAssignment(const char* tText, int tLength) {
+	MugenAssignmentInternKey key = makeMugenAssignmentInternKey(MUGEN_ASSIGNMENT_TYPE_STRING);
+	key.mText = tText;
+	key.mTextLength = tLength;
+	DreamMugenAssignment* shared = findInternedMugenAssignment(key);
+	if (shared) return shared;
+
 	DreamMugenStringAssignment* s = (DreamMugenStringAssignment*)allocMemoryOnMemoryStackOrMemory(sizeof(DreamMugenStringAssignment));
 	gDebugAssignmentAmount++;
-	s->mValue = (char*)allocMemoryOnMemoryStackOrMemory(strlen(tVal) + 2);
-	strcpy(s->mValue, tVal);
+	s->mValue = (char*)allocMemoryOnMemoryStackOrMemory(tLength + 2);
+	memcpy(s->mValue, tText, tLength);
+	s->mValue[tLength] = '\0';
 	s->mType = MUGEN_ASSIGNMENT_TYPE_STRING;
 
-	return (DreamMugenAssignment*)s;
+	key.mText = s->mValue;
+	return internMugenAssignment(key, (DreamMugenAssignment*)s);
+}
+
+DreamMugenAssignment * makeDreamStringMugenAssignment(const char * tVal)
+{
+	return makeMugenStringAssignment(tVal, strlen(tVal));
 }
 
 DreamMugenAssignment * makeDream2DVectorMugenAssignment(Vector3D tVal)
 {
-	DreamMugenDependOnTwoAssignment* data = (DreamMugenDependOnTwoAssignment*)allocMemoryOnMemoryStackOrMemory(sizeof(DreamMugenDependOnTwoAssignment));
-	gDebugAssignmentAmount++;
-	data->a = makeDreamFloatMugenAssignment(tVal.x);
-	data->b = makeDreamFloatMugenAssignment(tVal.y);
-	data->mType = MUGEN_ASSIGNMENT_TYPE_VECTOR;
-	return (DreamMugenAssignment*)data;
+	return makeMugenTwoElementAssignment(MUGEN_ASSIGNMENT_TYPE_VECTOR, makeDreamFloatMugenAssignment(tVal.x), makeDreamFloatMugenAssignment(tVal.y));
 }
 
 DreamMugenAssignment * makeDreamAndMugenAssignment(DreamMugenAssignment * a, DreamMugenAssignment * b)
@@ -282,390 +479,401 @@ DreamMugenAssignment * makeDreamOrMugenAssignment(DreamMugenAssignment * a, Drea
 	return makeMugenTwoElementAssignment(MUGEN_ASSIGNMENT_TYPE_OR, a, b);
 }
 
-static int isEmpty(char* tChar) {
-	return !strcmp("", tChar);
-}
+extern int resolveMugenAssignmentTrigger(char* tName, int tIsOrdinal, uint8_t* oKind, void** oFunc, int* oProjectileID);
 
-static int isEmptyCharacter(char tChar) {
-	return tChar == ' ';
-}
+// takes over tName, which is never freed separately when nodes are interned
+static DreamMugenAssignment* makeMugenTriggerAssignment(char* tName, uint8_t tKind, int tProjectileID, void* tFunc) {
+	MugenAssignmentInternKey key = makeMugenAssignmentInternKey(MUGEN_ASSIGNMENT_TYPE_TRIGGER);
+	key.mFlags = tKind;
+	key.mValue = tProjectileID;
+	key.mPointer = tFunc;
+	key.mText = tName;
+	key.mTextLength = strlen(tName);
+	DreamMugenAssignment* shared = findInternedMugenAssignment(key);
+	if (shared) return shared;
 
-static int isOperatorCharacter(char tChar) {
-	return tChar == '-' || tChar == '+' || tChar == '|' || tChar == '&' || tChar == '*' || tChar == '/' || tChar == '!';
+	DreamMugenTriggerAssignment* data = (DreamMugenTriggerAssignment*)allocMemoryOnMemoryStackOrMemory(sizeof(DreamMugenTriggerAssignment));
+	gDebugAssignmentAmount++;
+	data->mType = MUGEN_ASSIGNMENT_TYPE_TRIGGER;
+	data->mName = tName;
+	data->mKind = tKind;
+	data->mProjectileID = tProjectileID;
+	data->mFunc = tFunc;
+	return internMugenAssignment(key, (DreamMugenAssignment*)data);
 }
 
-static int isBinaryOperator(char* tText, int tPosition) {
-	int p = tPosition - 1;
-	int poss = 0;
-	while (p >= 0) {
-		if (isEmptyCharacter(tText[p])) p--;
-		else if (isOperatorCharacter(tText[p])) return 0;
-		else {
-			poss = 1;
-			break;
-		}
-	}
+static DreamMugenAssignment* resolveMugenTriggerVariable(DreamMugenAssignment* tAssignment, int tIsOrdinal) {
+	if (tAssignment->mType != MUGEN_ASSIGNMENT_TYPE_RAW_VARIABLE) return tAssignment;
+	DreamMugenRawVariableAssignment* variable = (DreamMugenRawVariableAssignment*)tAssignment;
 
-	if (!poss) return 0;
+	uint8_t kind;
+	void* func;
+	int projectileID;
+	if (!resolveMugenAssignmentTrigger(variable->mName, tIsOrdinal, &kind, &func, &projectileID)) return tAssignment;
 
-	int n = strlen(tText);
-	p = tPosition + 1;
-	poss = 0;
-	while (p < n) {
-		if (isEmptyCharacter(tText[p])) p++;
-		else if (isOperatorCharacter(tText[p])) return 0;
-		else {
-			poss = 1;
-			break;
-		}
-	}
+	DreamMugenAssignment* ret = makeMugenTriggerAssignment(variable->mName, kind, projectileID, func);
+	if (!gMugenAssignmentData.mMemoryStack) freeMemory(variable);
+	return ret;
+}
 
-	return poss;
+// interned nodes may be shared, so resolved children go into a fresh parent instead of being patched in
+static DreamMugenAssignment* replaceMugenOneElementAssignment(DreamMugenAssignment* tAssignment, DreamMugenAssignment* a) {
+	DreamMugenAssignment* ret = makeMugenOneElementAssignment((DreamMugenAssignmentType)tAssignment->mType, a);
+	if (!gMugenAssignmentData.mMemoryStack) freeMemory(tAssignment);
+	return ret;
 }
 
-static int isOnHighestLevelWithStartPosition(char* tText, const char* tPattern, int* tOptionalPosition, int tStart, int isBinary) {
-	int n = strlen(tText);
-	int m = strlen(tPattern);
+static DreamMugenAssignment* replaceMugenTwoElementAssignment(DreamMugenAssignment* tAssignment, DreamMugenAssignment* a, DreamMugenAssignment* b) {
+	DreamMugenAssignment* ret = makeMugenTwoElementAssignment((DreamMugenAssignmentType)tAssignment->mType, a, b);
+	if (!gMugenAssignmentData.mMemoryStack) freeMemory(tAssignment);
+	return ret;
+}
 
-	int depth1 = 0;
-	int depth2 = 0;
-	int depth3 = 0;
-	int i;
-	for (i = tStart; i < n - m + 1; i++) {
-		if (tText[i] == '(') depth1++;
-		if (tText[i] == ')') depth1--;
-		if (tText[i] == '[') depth2++;
-		if (tText[i] == ']') depth2--;
-		if (tText[i] == '"') depth3 ^= 1;
-
-		if (depth1 || depth2 || depth3) continue;
-
-		int isSame = 1;
-		int j;
-		for (j = 0; j < m; j++) {
-			if (tText[i + j] != tPattern[j]) {
-				isSame = 0;
-				break;
+static DreamMugenAssignment* resolveMugenComparisonTriggers(DreamMugenAssignmentType tType, DreamMugenAssignment* a) {
+	switch (tType) {
+	case MUGEN_ASSIGNMENT_TYPE_COMPARISON:
+	case MUGEN_ASSIGNMENT_TYPE_INEQUALITY:
+		if (a->mType == MUGEN_ASSIGNMENT_TYPE_NEGATION) {
+			DreamMugenDependOnOneAssignment* neg = (DreamMugenDependOnOneAssignment*)a;
+			DreamMugenAssignment* resolved = resolveMugenTriggerVariable(neg->a, 0);
+			if (resolved != neg->a) a = replaceMugenOneElementAssignment(a, resolved);
+		}
+		else if (a->mType == MUGEN_ASSIGNMENT_TYPE_VECTOR) {
+			DreamMugenDependOnTwoAssignment* vector = (DreamMugenDependOnTwoAssignment*)a;
+			if (vector->a->mType == MUGEN_ASSIGNMENT_TYPE_REDIRECT) {
+				DreamMugenAssignment* resolved = resolveMugenComparisonTriggers(tType, vector->b);
+				if (resolved != vector->b) a = replaceMugenTwoElementAssignment(a, vector->a, resolved);
 			}
 		}
-
-		if (isSame && (!isBinary || isBinaryOperator(tText, i))) {
-			if (tOptionalPosition) *tOptionalPosition = i;
-			return 1;
+		else {
+			a = resolveMugenTriggerVariable(a, 0);
 		}
+		return a;
+	case MUGEN_ASSIGNMENT_TYPE_LESS:
+	case MUGEN_ASSIGNMENT_TYPE_LESS_OR_EQUAL:
+	case MUGEN_ASSIGNMENT_TYPE_GREATER:
+	case MUGEN_ASSIGNMENT_TYPE_GREATER_OR_EQUAL:
+		return resolveMugenTriggerVariable(a, 1);
+	default:
+		return a;
 	}
-
-	return 0;
 }
 
-static int isOnHighestLevel(char* tText, const char* tPattern, int* tOptionalPosition) {
-	return isOnHighestLevelWithStartPosition(tText, tPattern, tOptionalPosition, 0, 0);
-}
+typedef struct {
+	uint8_t mIsFloat;
+	int mNumber;
+	double mFloat;
+} MugenAssignmentConstant;
 
-static int isOnHighestLevelBinary(char* tText, const char* tPattern, int* tOptionalPosition) {
-	return isOnHighestLevelWithStartPosition(tText, tPattern, tOptionalPosition, 0, 1);
-}
-
-static DreamMugenAssignment* parseOneElementMugenAssignmentFromString(char* tText, DreamMugenAssignmentType tType) {
-	
-	DreamMugenAssignment* a = parseDreamMugenAssignmentFromString(tText);
-
-	return makeMugenOneElementAssignment(tType, a);
-}
-
-static DreamMugenAssignment* parseTwoElementMugenAssignmentFromStringWithFixedPosition(char* tText, DreamMugenAssignmentType tType, const char* tPattern, int tPosition) {
-	int n = strlen(tText);
-	int m = strlen(tPattern);
-
-	assert(tPosition != -1);
-	if (tPosition >= n - m) {
-		logWarningFormat("Parsing error: Incorrect two element assignment: text %s with pattern %s", tText, tPattern);
+static int getMugenAssignmentConstant(DreamMugenAssignment* tAssignment, MugenAssignmentConstant* oConstant) {
+	oConstant->mIsFloat = 0;
+	switch (tAssignment->mType) {
+	case MUGEN_ASSIGNMENT_TYPE_NUMBER:
+		oConstant->mNumber = ((DreamMugenNumberAssignment*)tAssignment)->mValue;
+		oConstant->mFloat = oConstant->mNumber;
+		return 1;
+	case MUGEN_ASSIGNMENT_TYPE_FIXED_BOOLEAN:
+		oConstant->mNumber = ((DreamMugenFixedBooleanAssignment*)tAssignment)->mValue;
+		oConstant->mFloat = oConstant->mNumber;
+		return 1;
+	case MUGEN_ASSIGNMENT_TYPE_FLOAT:
+		oConstant->mIsFloat = 1;
+		oConstant->mFloat = ((DreamMugenFloatAssignment*)tAssignment)->mValue;
+		oConstant->mNumber = (int)oConstant->mFloat;
+		return 1;
+	default:
+		return 0;
 	}
-
-	int start = tPosition;
-	int end = tPosition + m;
-
-	char text1[MUGEN_DEF_STRING_LENGTH];
-	char text2[MUGEN_DEF_STRING_LENGTH];
-
-	strcpy(text1, tText);
-	text1[start] = '\0';
-
-	strcpy(text2, &tText[end]);
-
-	DreamMugenAssignment* a = parseDreamMugenAssignmentFromString(text1);
-	DreamMugenAssignment* b = parseDreamMugenAssignmentFromString(text2);
-
-	return makeMugenTwoElementAssignment(tType, a, b);
 }
 
-static DreamMugenAssignment* parseTwoElementMugenAssignmentFromString(char* tText, DreamMugenAssignmentType tType, const char* tPattern) {
-	int pos = -1;
-	isOnHighestLevel(tText, tPattern, &pos);
-	return parseTwoElementMugenAssignmentFromStringWithFixedPosition(tText, tType, tPattern, pos);
+static void discardFoldedMugenAssignment(DreamMugenAssignment* tAssignment) {
+	if (gMugenAssignmentData.mMemoryStack) return;
+	destroyDreamMugenAssignment(tAssignment);
 }
 
-static DreamMugenAssignment* parseBinaryTwoElementMugenAssignmentFromString(char* tText, DreamMugenAssignmentType tType, const char* tPattern) {
-	int pos = -1;
-	isOnHighestLevelBinary(tText, tPattern, &pos);
-	return parseTwoElementMugenAssignmentFromStringWithFixedPosition(tText, tType, tPattern, pos);
+static DreamMugenAssignment* makeFoldedMugenBooleanAssignment(int tValue) {
+	return makeMugenFixedBooleanAssignment(MUGEN_ASSIGNMENT_TYPE_FIXED_BOOLEAN, (uint8_t)tValue);
 }
 
-
-static DreamMugenAssignment* parseMugenNullFromString() {
-	DreamMugenFixedBooleanAssignment* data = (DreamMugenFixedBooleanAssignment*)allocMemoryOnMemoryStackOrMemory(sizeof(DreamMugenFixedBooleanAssignment));
-	gDebugAssignmentAmount++;
-	data->mValue = 0;
-	data->mType = MUGEN_ASSIGNMENT_TYPE_NULL;
-	return (DreamMugenAssignment*)data;
-}
-
-
-
-static int isInBraces(char* tText) {
-	int n = strlen(tText);
-	if (tText[0] != '(' || tText[n - 1] != ')') return 0;
-
-	int depth = 0;
-	int i;
-	for (i = 0; i < n - 1; i++) {
-		if (tText[i] == '(') depth++;
-		if (tText[i] == ')') depth--;
-
-		if (!depth) return 0;
+static int foldMugenComparisonConstants(DreamMugenAssignmentType tType, const MugenAssignmentConstant& a, const MugenAssignmentConstant& b) {
+	if (a.mIsFloat || b.mIsFloat) {
+		switch (tType) {
+		case MUGEN_ASSIGNMENT_TYPE_COMPARISON: return a.mFloat == b.mFloat;
+		case MUGEN_ASSIGNMENT_TYPE_INEQUALITY: return a.mFloat != b.mFloat;
+		case MUGEN_ASSIGNMENT_TYPE_LESS: return a.mFloat < b.mFloat;
+		case MUGEN_ASSIGNMENT_TYPE_LESS_OR_EQUAL: return a.mFloat <= b.mFloat;
+		case MUGEN_ASSIGNMENT_TYPE_GREATER: return a.mFloat > b.mFloat;
+		default: return a.mFloat >= b.mFloat;
+		}
+	}
+	else {
+		switch (tType) {
+		case MUGEN_ASSIGNMENT_TYPE_COMPARISON: return a.mNumber == b.mNumber;
+		case MUGEN_ASSIGNMENT_TYPE_INEQUALITY: return a.mNumber != b.mNumber;
+		case MUGEN_ASSIGNMENT_TYPE_LESS: return a.mNumber < b.mNumber;
+		case MUGEN_ASSIGNMENT_TYPE_LESS_OR_EQUAL: return a.mNumber <= b.mNumber;
+		case MUGEN_ASSIGNMENT_TYPE_GREATER: return a.mNumber > b.mNumber;
+		default: return a.mNumber >= b.mNumber;
+		}
 	}
-
-	return 1;
-}
-
-static DreamMugenAssignment* parseMugenAssignmentStringInBraces(char* tText) {
-	int n = strlen(tText);
-	tText[n - 1] = '\0';
-	tText++;
-
-	return parseDreamMugenAssignmentFromString(tText);
-}
-
-static int isNegation(char* tText) {
-	return (tText[0] == '!');
-}
-
-static DreamMugenAssignment* parseMugenNegationFromString(char* tText) {
-	tText++;
-	return parseOneElementMugenAssignmentFromString(tText, MUGEN_ASSIGNMENT_TYPE_NEGATION);
-}
-
-static int isUnaryMinus(char* tText) {
-	return (tText[0] == '-');
-}
-
-static DreamMugenAssignment* parseMugenUnaryMinusFromString(char* tText) {
-	tText++;
-	return parseOneElementMugenAssignmentFromString(tText, MUGEN_ASSIGNMENT_TYPE_UNARY_MINUS);
 }
 
-static int isRange(char* tText) {
-	int n = strlen(tText);
-	if ((tText[0] != '[' && tText[0] != '(') || (tText[n - 1] != ']' && tText[n - 1] != ')')) return 0;
-
-	int depth = 0;
-	int i;
-	for (i = 0; i < n - 1; i++) {
-		if (tText[i] == '(' || tText[i] == '[') depth++;
-		if (tText[i] == ')' || tText[i] == ']') depth--;
-
-		if (!depth) return 0;
+static DreamMugenAssignment* foldMugenTwoElementConstants(DreamMugenAssignmentType tType, const MugenAssignmentConstant& a, const MugenAssignmentConstant& b) {
+	int isFloat = a.mIsFloat || b.mIsFloat;
+	switch (tType) {
+	case MUGEN_ASSIGNMENT_TYPE_COMPARISON:
+	case MUGEN_ASSIGNMENT_TYPE_INEQUALITY:
+	case MUGEN_ASSIGNMENT_TYPE_LESS:
+	case MUGEN_ASSIGNMENT_TYPE_LESS_OR_EQUAL:
+	case MUGEN_ASSIGNMENT_TYPE_GREATER:
+	case MUGEN_ASSIGNMENT_TYPE_GREATER_OR_EQUAL:
+		return makeFoldedMugenBooleanAssignment(foldMugenComparisonConstants(tType, a, b));
+	case MUGEN_ASSIGNMENT_TYPE_AND:
+	case MUGEN_ASSIGNMENT_TYPE_OR:
+	{
+		int value;
+		if (tType == MUGEN_ASSIGNMENT_TYPE_AND) value = a.mNumber ? b.mNumber : 0;
+		else value = a.mNumber ? a.mNumber : b.mNumber;
+		if (value < 0 || value > 255) return NULL;
+		return makeFoldedMugenBooleanAssignment(value);
+	}
+	case MUGEN_ASSIGNMENT_TYPE_BITWISE_AND:
+		return makeDreamNumberMugenAssignment(a.mNumber & b.mNumber);
+	case MUGEN_ASSIGNMENT_TYPE_BITWISE_OR:
+		return makeDreamNumberMugenAssignment(a.mNumber | b.mNumber);
+	case MUGEN_ASSIGNMENT_TYPE_ADDITION:
+		return isFloat ? makeDreamFloatMugenAssignment(a.mFloat + b.mFloat) : makeDreamNumberMugenAssignment(a.mNumber + b.mNumber);
+	case MUGEN_ASSIGNMENT_TYPE_SUBTRACTION:
+		return isFloat ? makeDreamFloatMugenAssignment(a.mFloat - b.mFloat) : makeDreamNumberMugenAssignment(a.mNumber - b.mNumber);
+	case MUGEN_ASSIGNMENT_TYPE_MULTIPLICATION:
+		return isFloat ? makeDreamFloatMugenAssignment(a.mFloat * b.mFloat) : makeDreamNumberMugenAssignment(a.mNumber * b.mNumber);
+	case MUGEN_ASSIGNMENT_TYPE_DIVISION:
+		if (isFloat) return makeDreamFloatMugenAssignment(a.mFloat / b.mFloat);
+		if (!b.mNumber) return NULL;
+		return makeDreamNumberMugenAssignment(a.mNumber / b.mNumber);
+	case MUGEN_ASSIGNMENT_TYPE_MODULO:
+		if (isFloat || !b.mNumber) return NULL;
+		return makeDreamNumberMugenAssignment(a.mNumber % b.mNumber);
+	case MUGEN_ASSIGNMENT_TYPE_EXPONENTIATION:
+		if (!isFloat && b.mNumber >= 0) return NULL;
+		return makeDreamFloatMugenAssignment(pow(a.mFloat, b.mFloat));
+	default:
+		return NULL;
 	}
-
-	return 1;
 }
 
-static DreamMugenAssignment* parseMugenRangeFromString(char* tText) {
-	DreamMugenRangeAssignment* e = (DreamMugenRangeAssignment*)allocMemoryOnMemoryStackOrMemory(sizeof(DreamMugenRangeAssignment));
-	gDebugAssignmentAmount++;
-	int n = strlen(tText);
-	e->mExcludeLeft = tText[0] == '(';
-	e->mExcludeRight = tText[n - 1] == ')';
-	
-	tText[n - 1] = '\0';
-	tText++;
-
-	e->a = parseDreamMugenAssignmentFromString(tText);
-	e->mType = MUGEN_ASSIGNMENT_TYPE_RANGE;
-	return (DreamMugenAssignment*)e;
-}
+extern int resolveMugenAssignmentRedirect(DreamMugenAssignment* tAssignment, uint8_t* oTarget);
 
+static DreamMugenAssignment* makeMugenRedirectAssignment(uint8_t tTarget, DreamMugenAssignment* tIndex) {
+	MugenAssignmentInternKey key = makeMugenAssignmentInternKey(MUGEN_ASSIGNMENT_TYPE_REDIRECT);
+	key.mFlags = tTarget;
+	key.a = tIndex;
+	DreamMugenAssignment* shared = findInternedMugenAssignment(key);
+	if (shared) return shared;
 
-static int isInequality(char* tText) {
-	return isOnHighestLevel(tText, "!=", NULL);
+	DreamMugenRedirectAssignment* data = (DreamMugenRedirectAssignment*)allocMemoryOnMemoryStackOrMemory(sizeof(DreamMugenRedirectAssignment));
+	gDebugAssignmentAmount++;
+	data->mType = MUGEN_ASSIGNMENT_TYPE_REDIRECT;
+	data->mTarget = tTarget;
+	data->mIndex = tIndex;
+	return internMugenAssignment(key, (DreamMugenAssignment*)data);
 }
 
-static DreamMugenAssignment* parseMugenInequalityFromString(char* tText) {
-	return parseTwoElementMugenAssignmentFromString(tText, MUGEN_ASSIGNMENT_TYPE_INEQUALITY, "!=");
-}
+static DreamMugenAssignment* resolveMugenRedirect(DreamMugenAssignment* tAssignment) {
+	uint8_t target;
+	if (!resolveMugenAssignmentRedirect(tAssignment, &target)) return tAssignment;
 
-static int isVariableSet(char* tText) {
-	return isOnHighestLevel(tText, ":=", NULL);
-}
+	DreamMugenAssignment* index = tAssignment->mType == MUGEN_ASSIGNMENT_TYPE_ARRAY ? ((DreamMugenArrayAssignment*)tAssignment)->mIndex : NULL;
+	DreamMugenAssignment* ret = makeMugenRedirectAssignment(target, index);
 
-static DreamMugenAssignment* parseMugenVariableSetFromString(char* tText) {
-	return parseTwoElementMugenAssignmentFromString(tText, MUGEN_ASSIGNMENT_TYPE_SET_VARIABLE, ":=");
+	if (index) {
+		if (!gMugenAssignmentData.mMemoryStack) freeMemory(tAssignment);
+	}
+	else {
+		discardFoldedMugenAssignment(tAssignment);
+	}
+	return ret;
 }
 
-static int isComparison(char* tText) {
-	int position;
+static int getMugenFlagsTriggerKind(DreamMugenAssignment* tAssignment, uint8_t* oKind, uint8_t* oIsP2) {
+	if (tAssignment->mType != MUGEN_ASSIGNMENT_TYPE_TRIGGER) return 0;
+	DreamMugenTriggerAssignment* trigger = (DreamMugenTriggerAssignment*)tAssignment;
+	if (trigger->mKind != MUGEN_TRIGGER_KIND_COMPARISON) return 0;
 
-	if(!isOnHighestLevel(tText, "=", &position)) return 0;
-	if (position == 0) return 0;
-	if (tText[position - 1] == '!') return 0;
-	if (tText[position - 1] == '<') return 0;
-	if (tText[position - 1] == '>') return 0;
-	if (tText[position - 1] == ':') return 0;
+	const char* name = trigger->mName;
+	*oIsP2 = !strncmp(name, "p2", 2);
+	if (*oIsP2) name += 2;
 
+	if (!strcmp("statetype", name)) *oKind = MUGEN_FLAGS_KIND_STATE_TYPE;
+	else if (!strcmp("movetype", name)) *oKind = MUGEN_FLAGS_KIND_MOVE_TYPE;
+	else if (!strcmp("hitdefattr", name) && !*oIsP2) *oKind = MUGEN_FLAGS_KIND_HIT_DEF_ATTRIBUTE;
+	else return 0;
 	return 1;
 }
 
-static DreamMugenAssignment* parseMugenComparisonFromString(char* tText) {
-	return parseTwoElementMugenAssignmentFromString(tText, MUGEN_ASSIGNMENT_TYPE_COMPARISON, "=");
-}
-
-static int isAnd(char* tText) {
-	return isOnHighestLevel(tText, "&&", NULL);
-}
-
-static DreamMugenAssignment* parseMugenAndFromString(char* tText) {
-	return parseTwoElementMugenAssignmentFromString(tText, MUGEN_ASSIGNMENT_TYPE_AND, "&&");
-}
+static int addMugenFlagsLiterals(DreamMugenAssignment* tAssignment, vector<string>& oLiterals) {
+	if (tAssignment->mType == MUGEN_ASSIGNMENT_TYPE_VECTOR) {
+		DreamMugenDependOnTwoAssignment* vector = (DreamMugenDependOnTwoAssignment*)tAssignment;
+		return addMugenFlagsLiterals(vector->a, oLiterals) && addMugenFlagsLiterals(vector->b, oLiterals);
+	}
 
-static int isOr(char* tText) {
-	return isOnHighestLevel(tText, "||", NULL);
-}
+	const char* text;
+	if (tAssignment->mType == MUGEN_ASSIGNMENT_TYPE_RAW_VARIABLE) text = ((DreamMugenRawVariableAssignment*)tAssignment)->mName;
+	else if (tAssignment->mType == MUGEN_ASSIGNMENT_TYPE_STRING) text = ((DreamMugenStringAssignment*)tAssignment)->mValue;
+	else return 0;
 
-static DreamMugenAssignment* parseMugenOrFromString(char* tText) {
-	return parseTwoElementMugenAssignmentFromString(tText, MUGEN_ASSIGNMENT_TYPE_OR, "||");
+	if (!*text) return 0;
+	for (const char* c = text; *c; c++) {
+		if (!isalpha((unsigned char)*c)) return 0;
+	}
+	oLiterals.push_back(text);
+	return 1;
 }
 
-static int isBitwiseAnd(char* tText) {
-	return isOnHighestLevel(tText, "&", NULL);
+static uint32_t getMugenStateTypeFlagsMask(const string& tText) {
+	uint32_t mask = 0;
+	if (tText.find('s') != tText.npos) mask |= 1u << MUGEN_STATE_TYPE_STANDING;
+	if (tText.find('a') != tText.npos) mask |= 1u << MUGEN_STATE_TYPE_AIR;
+	if (tText.find('c') != tText.npos) mask |= 1u << MUGEN_STATE_TYPE_CROUCHING;
+	if (tText.find('l') != tText.npos) mask |= 1u << MUGEN_STATE_TYPE_LYING;
+	return mask;
 }
 
-static DreamMugenAssignment* parseMugenBitwiseAndFromString(char* tText) {
-	return parseTwoElementMugenAssignmentFromString(tText, MUGEN_ASSIGNMENT_TYPE_BITWISE_AND, "&");
+static uint32_t getMugenMoveTypeFlagsMask(const string& tText) {
+	uint32_t mask = 0;
+	if (tText.find('a') != tText.npos) mask |= 1u << MUGEN_STATE_MOVE_TYPE_ATTACK;
+	if (tText.find('h') != tText.npos) mask |= 1u << MUGEN_STATE_MOVE_TYPE_BEING_HIT;
+	if (tText.find('i') != tText.npos) mask |= 1u << MUGEN_STATE_MOVE_TYPE_IDLE;
+	return mask;
 }
 
-static int isBitwiseOr(char* tText) {
-	return isOnHighestLevel(tText, "|", NULL);
+static string getMugenFlagsLiteralLowercase(const string& tText) {
+	string ret = tText;
+	for (size_t i = 0; i < ret.size(); i++) ret[i] = (char)tolower((unsigned char)ret[i]);
+	return ret;
 }
 
-static DreamMugenAssignment* parseMugenBitwiseOrFromString(char* tText) {
-	return parseTwoElementMugenAssignmentFromString(tText, MUGEN_ASSIGNMENT_TYPE_BITWISE_OR, "|");
-}
+static int getMugenHitDefAttributeFlagsMask(vector<string>& tLiterals, uint32_t* oMask) {
+	string state = getMugenFlagsLiteralLowercase(tLiterals[0]);
+	uint32_t mask = 0;
+	if (state.find('s') != state.npos) mask |= 1u << MUGEN_STATE_TYPE_STANDING;
+	if (state.find('c') != state.npos) mask |= 1u << MUGEN_STATE_TYPE_CROUCHING;
+	if (state.find('a') != state.npos) mask |= 1u << MUGEN_STATE_TYPE_AIR;
 
-static int isLessOrEqualThan(char* tText) {
-	int position;
-	if (!isOnHighestLevel(tText, "<=", &position)) return 0;
-	if (position == 0) return 0;
+	for (size_t i = 1; i < tLiterals.size(); i++) {
+		string attack = getMugenFlagsLiteralLowercase(tLiterals[i]);
+		if (attack.size() != 2 || !strchr("nsh", attack[0]) || !strchr("atp", attack[1])) return 0;
 
-	return 1;
-}
-
-static DreamMugenAssignment* parseMugenLessOrEqualFromString(char* tText) {
-	return parseTwoElementMugenAssignmentFromString(tText, MUGEN_ASSIGNMENT_TYPE_LESS_OR_EQUAL, "<=");
-}
-
-static int isLessThan(char* tText) {
-	int position;
-	if (!isOnHighestLevel(tText, "<", &position)) return 0;
-	if (position == 0) return 0;
+		int attackClass = attack[0] == 'n' ? MUGEN_ATTACK_CLASS_NORMAL : (attack[0] == 's' ? MUGEN_ATTACK_CLASS_SPECIAL : MUGEN_ATTACK_CLASS_HYPER);
+		int attackType = attack[1] == 'a' ? MUGEN_ATTACK_TYPE_ATTACK : (attack[1] == 't' ? MUGEN_ATTACK_TYPE_THROW : MUGEN_ATTACK_TYPE_PROJECTILE);
+		mask |= MUGEN_FLAGS_HIT_DEF_ATTRIBUTE_HAS_ATTACKS | (1u << (MUGEN_FLAGS_HIT_DEF_ATTRIBUTE_ATTACK_SHIFT + attackClass * 3 + attackType));
+	}
 
+	*oMask = mask;
 	return 1;
 }
 
-static DreamMugenAssignment* parseMugenLessFromString(char* tText) {
-	return parseTwoElementMugenAssignmentFromString(tText, MUGEN_ASSIGNMENT_TYPE_LESS, "<");
-}
-
-static int isGreaterOrEqualThan(char* tText) {
-	int position;
-	if (!isOnHighestLevel(tText, ">=", &position)) return 0;
-	if (position == 0) return 0;
+static DreamMugenAssignment* makeMugenFlagsNode(uint8_t tKind, uint8_t tIsP2, uint32_t tMask) {
+	MugenAssignmentInternKey key = makeMugenAssignmentInternKey(MUGEN_ASSIGNMENT_TYPE_FLAGS);
+	key.mFlags = uint8_t(tKind | (tIsP2 << 4));
+	key.mValue = tMask;
+	DreamMugenAssignment* shared = findInternedMugenAssignment(key);
+	if (shared) return shared;
 
-	return 1;
-}
+	DreamMugenFlagsAssignment* data = (DreamMugenFlagsAssignment*)allocMemoryOnMemoryStackOrMemory(sizeof(DreamMugenFlagsAssignment));
+	gDebugAssignmentAmount++;
+	data->mType = MUGEN_ASSIGNMENT_TYPE_FLAGS;
+	data->mKind = tKind;
+	data->mIsP2 = tIsP2;
+	data->mMask = tMask;
+	return internMugenAssignment(key, (DreamMugenAssignment*)data);
+}
+
+// statetype, movetype and hitdefattr literals are turned into a bitmask once instead of being matched as strings on every evaluation
+static DreamMugenAssignment* makeMugenFlagsAssignment(DreamMugenAssignmentType tType, DreamMugenAssignment* a, DreamMugenAssignment* b) {
+	if (tType != MUGEN_ASSIGNMENT_TYPE_COMPARISON && tType != MUGEN_ASSIGNMENT_TYPE_INEQUALITY) return NULL;
+
+	int isNegated = tType == MUGEN_ASSIGNMENT_TYPE_INEQUALITY;
+	DreamMugenAssignment* trigger = a;
+	if (trigger->mType == MUGEN_ASSIGNMENT_TYPE_NEGATION) {
+		trigger = ((DreamMugenDependOnOneAssignment*)trigger)->a;
+		isNegated = !isNegated;
+	}
 
-static DreamMugenAssignment* parseMugenGreaterOrEqualFromString(char* tText) {
-	return parseTwoElementMugenAssignmentFromString(tText, MUGEN_ASSIGNMENT_TYPE_GREATER_OR_EQUAL, ">=");
-}
+	uint8_t kind, isP2;
+	if (!getMugenFlagsTriggerKind(trigger, &kind, &isP2)) return NULL;
 
-static int isGreaterThan(char* tText) {
-	int position;
-	if(!isOnHighestLevel(tText, ">", &position)) return 0;
-	if (position == 0) return 0;
+	vector<string> literals;
+	if (!addMugenFlagsLiterals(b, literals)) return NULL;
 
-	return 1;
-}
+	uint32_t mask;
+	if (kind == MUGEN_FLAGS_KIND_HIT_DEF_ATTRIBUTE) {
+		if (!getMugenHitDefAttributeFlagsMask(literals, &mask)) return NULL;
+	}
+	else {
+		if (literals.size() != 1) return NULL;
+		mask = kind == MUGEN_FLAGS_KIND_STATE_TYPE ? getMugenStateTypeFlagsMask(literals[0]) : getMugenMoveTypeFlagsMask(literals[0]);
+	}
 
-static DreamMugenAssignment* parseMugenGreaterFromString(char* tText) {
-	return parseTwoElementMugenAssignmentFromString(tText, MUGEN_ASSIGNMENT_TYPE_GREATER, ">");
-}
+	DreamMugenAssignment* ret = makeMugenFlagsNode(kind, isP2, mask);
 
-static int isExponentiation(char* tText) {
-	return isOnHighestLevel(tText, "**", NULL);
+	discardFoldedMugenAssignment(a);
+	discardFoldedMugenAssignment(b);
+	if (isNegated) ret = makeMugenOneElementAssignment(MUGEN_ASSIGNMENT_TYPE_NEGATION, ret);
+	return ret;
 }
 
-static DreamMugenAssignment* parseMugenExponentiationFromString(char* tText) {
-	return parseTwoElementMugenAssignmentFromString(tText, MUGEN_ASSIGNMENT_TYPE_EXPONENTIATION, "**");
-}
+static DreamMugenAssignment* makeFoldedMugenTwoElementAssignment(DreamMugenAssignmentType tType, DreamMugenAssignment* a, DreamMugenAssignment* b) {
+	if (tType == MUGEN_ASSIGNMENT_TYPE_VECTOR) a = resolveMugenRedirect(a);
+	a = resolveMugenComparisonTriggers(tType, a);
 
-static int isAddition(char* tText) {
-	int plusPosition;
-	if(!isOnHighestLevel(tText, "+", &plusPosition)) return 0;
-	int len = strlen(tText);
-	return plusPosition < len -1;
-}
+	DreamMugenAssignment* flags = makeMugenFlagsAssignment(tType, a, b);
+	if (flags) return flags;
 
-static DreamMugenAssignment* parseMugenAdditionFromString(char* tText) {
-	return parseTwoElementMugenAssignmentFromString(tText, MUGEN_ASSIGNMENT_TYPE_ADDITION, "+");
-}
+	MugenAssignmentConstant constantA, constantB;
+	if (!getMugenAssignmentConstant(a, &constantA)) return makeMugenTwoElementAssignment(tType, a, b);
 
-static int isSubtraction(char* tText) {
-	return isOnHighestLevelBinary(tText, "-", NULL);
-}
+	DreamMugenAssignment* ret = NULL;
+	if (tType == MUGEN_ASSIGNMENT_TYPE_AND && !constantA.mNumber) {
+		ret = makeFoldedMugenBooleanAssignment(0);
+	}
+	else if (tType == MUGEN_ASSIGNMENT_TYPE_OR && constantA.mNumber && constantA.mNumber >= 0 && constantA.mNumber <= 255) {
+		ret = makeFoldedMugenBooleanAssignment(constantA.mNumber);
+	}
+	else if (getMugenAssignmentConstant(b, &constantB)) {
+		ret = foldMugenTwoElementConstants(tType, constantA, constantB);
+	}
+	if (!ret) return makeMugenTwoElementAssignment(tType, a, b);
 
-static DreamMugenAssignment* parseMugenSubtractionFromString(char* tText) {
-	return parseBinaryTwoElementMugenAssignmentFromString(tText, MUGEN_ASSIGNMENT_TYPE_SUBTRACTION, "-");
+	discardFoldedMugenAssignment(a);
+	discardFoldedMugenAssignment(b);
+	return ret;
 }
 
-static int isMultiplication(char* tText) {
-	int position = 0;
-	int n = strlen(tText);
-
-	if (!isOnHighestLevel(tText, "*", &position)) return 0;
-	if (position == 0) return 0;
-	if (position < n-1 && tText[position + 1] == '*') return 0;
+static DreamMugenAssignment* makeFoldedMugenOneElementAssignment(DreamMugenAssignmentType tType, DreamMugenAssignment* a) {
+	MugenAssignmentConstant constant;
+	if (!getMugenAssignmentConstant(a, &constant)) return makeMugenOneElementAssignment(tType, a);
 
-	return 1;
-}
-
-static DreamMugenAssignment* parseMugenMultiplicationFromString(char* tText) {
-	return parseTwoElementMugenAssignmentFromString(tText, MUGEN_ASSIGNMENT_TYPE_MULTIPLICATION, "*");
-}
+	DreamMugenAssignment* ret;
+	if (tType == MUGEN_ASSIGNMENT_TYPE_NEGATION) {
+		ret = makeFoldedMugenBooleanAssignment(!constant.mNumber);
+	}
+	else if (tType == MUGEN_ASSIGNMENT_TYPE_UNARY_MINUS) {
+		ret = constant.mIsFloat ? makeDreamFloatMugenAssignment(-constant.mFloat) : makeDreamNumberMugenAssignment(-constant.mNumber);
+	}
+	else {
+		return makeMugenOneElementAssignment(tType, a);
+	}
 
-static int isDivision(char* tText) {
-	return isOnHighestLevel(tText, "/", NULL);
+	discardFoldedMugenAssignment(a);
+	return ret;
 }
 
-static DreamMugenAssignment* parseMugenDivisionFromString(char* tText) {
-	return parseTwoElementMugenAssignmentFromString(tText, MUGEN_ASSIGNMENT_TYPE_DIVISION, "/");
+static DreamMugenAssignment* parseMugenNullFromString() {
+	return makeMugenFixedBooleanAssignment(MUGEN_ASSIGNMENT_TYPE_NULL, 0);
 }
 
-static int isModulo(char* tText) {
-	return isOnHighestLevel(tText, "%", NULL);
-}
 
-static DreamMugenAssignment* parseMugenModuloFromString(char* tText) {
-	return parseTwoElementMugenAssignmentFromString(tText, MUGEN_ASSIGNMENT_TYPE_MODULO, "%");
-}
 
 static int isNumericalConstant(char* tText) {
 	if (*tText == '-') tText++;
@@ -713,29 +921,16 @@ static DreamMugenAssignment* parseFloatConstantFromString(char* tText) {
 	return makeDreamFloatMugenAssignment(f);
 }
 
-static int isStringConstant(char* tText) {
-	int n = strlen(tText);
-	if (n == 0) return 0;
-	return tText[0] == '"' && tText[n - 1] == '"';
-}
-
-static DreamMugenAssignment* parseStringConstantFromString(char* tText) {
+static DreamMugenAssignment* parseStringConstantFromString(const char* tText, int tLength) {
 	if (gMugenAssignmentData.mHasCommandHandlerEntryForLookup) {
-		string potentialCommand(tText + 1, strlen(tText + 1) - 1);
+		string potentialCommand(tText, tLength);
 		int potentialCommandIndex;
 		if (isDreamCommandForLookup(gMugenAssignmentData.mCommandHandlerID, potentialCommand.data(), &potentialCommandIndex)) {
 			return makeDreamNumberMugenAssignment(potentialCommandIndex);
 		}
 	}
 
-	DreamMugenStringAssignment* s = (DreamMugenStringAssignment*)allocMemoryOnMemoryStackOrMemory(sizeof(DreamMugenStringAssignment));
-	gDebugAssignmentAmount++;
-	s->mValue = (char*)allocMemoryOnMemoryStackOrMemory(strlen(tText + 1) + 10);
-	strcpy(s->mValue, tText+1);
-	s->mValue[strlen(s->mValue) - 1] = '\0';
-
-	s->mType = MUGEN_ASSIGNMENT_TYPE_STRING;
-	return (DreamMugenAssignment*)s;
+	return makeMugenStringAssignment(tText, tLength);
 }
 
 int doDreamAssignmentStringsBeginsWithPattern(const char* tPattern, char* tText) {
@@ -751,414 +946,696 @@ int doDreamAssignmentStringsBeginsWithPattern(const char* tPattern, char* tText)
 	return 1;
 }
 
-extern std::map<std::string, AssignmentReturnValue*(*)(DreamPlayer*)>& getActiveMugenAssignmentVariableMap();
+extern void* findMugenAssignmentVariableFunction(const char* tName);
+extern uint8_t getMugenAssignmentVariableMemoSymbol(void* tFunc);
 
-static int isMugenVariable(char* tText) {
-	char* text = (char*)allocMemory(strlen(tText) + 2);
-	strcpy(text, tText);
-	turnStringLowercase(text);
+static DreamMugenAssignment* parseMugenRawVariableFromString(char* tLowercaseText) {
+	MugenAssignmentInternKey key = makeMugenAssignmentInternKey(MUGEN_ASSIGNMENT_TYPE_RAW_VARIABLE);
+	key.mText = tLowercaseText;
+	key.mTextLength = strlen(tLowercaseText);
+	DreamMugenAssignment* shared = findInternedMugenAssignment(key);
+	if (shared) return shared;
 
-	auto m = getActiveMugenAssignmentVariableMap();
-	
-	int ret = m.find(text) != m.end();
-	freeMemory(text);
+	DreamMugenRawVariableAssignment* data = (DreamMugenRawVariableAssignment*)allocMemoryOnMemoryStackOrMemory(sizeof(DreamMugenRawVariableAssignment));
+	gDebugAssignmentAmount++;
+	data->mName = (char*)allocMemoryOnMemoryStackOrMemory(key.mTextLength + 2);
+	strcpy(data->mName, tLowercaseText);
+	data->mType = MUGEN_ASSIGNMENT_TYPE_RAW_VARIABLE;
 
-	return ret;
+	key.mText = data->mName;
+	return internMugenAssignment(key, (DreamMugenAssignment*)data);
 }
 
-static DreamMugenAssignment* parseMugenVariableFromString(char* tText) {
-	char* text = (char*)allocMemory(strlen(tText) + 2);
-	strcpy(text, tText);
-	turnStringLowercase(text);
-	
+static DreamMugenAssignment* makeMugenVariableAssignment(void* tFunc) {
+	MugenAssignmentInternKey key = makeMugenAssignmentInternKey(MUGEN_ASSIGNMENT_TYPE_VARIABLE);
+	key.mPointer = tFunc;
+	DreamMugenAssignment* shared = findInternedMugenAssignment(key);
+	if (shared) return shared;
+
 	DreamMugenVariableAssignment* data = (DreamMugenVariableAssignment*)allocMemoryOnMemoryStackOrMemory(sizeof(DreamMugenVariableAssignment));
 	gDebugAssignmentAmount++;
-	auto m = getActiveMugenAssignmentVariableMap();
-	data->mFunc = (void*)m[text];
+	data->mFunc = tFunc;
+	data->mMemoSymbol = getMugenAssignmentVariableMemoSymbol(data->mFunc);
 	data->mType = MUGEN_ASSIGNMENT_TYPE_VARIABLE;
-	freeMemory(text);
-	return (DreamMugenAssignment*)data;
+	return internMugenAssignment(key, (DreamMugenAssignment*)data);
 }
 
-static DreamMugenAssignment* parseMugenRawVariableFromString(char* tText) {
-	DreamMugenRawVariableAssignment* data = (DreamMugenRawVariableAssignment*)allocMemoryOnMemoryStackOrMemory(sizeof(DreamMugenRawVariableAssignment));
-	gDebugAssignmentAmount++;
-	data->mName = (char*)allocMemoryOnMemoryStackOrMemory(strlen(tText) + 2);
-	strcpy(data->mName, tText);
-	turnStringLowercase(data->mName);
-	data->mType = MUGEN_ASSIGNMENT_TYPE_RAW_VARIABLE;
-	return (DreamMugenAssignment*)data;
+static DreamMugenAssignment* parseMugenVariableOrRawVariableFromString(char* tLowercaseText) {
+	void* func = findMugenAssignmentVariableFunction(tLowercaseText);
+	if (!func) {
+		return parseMugenRawVariableFromString(tLowercaseText);
+	}
+
+	return makeMugenVariableAssignment(func);
+}
+
+typedef enum {
+	MUGEN_TOKEN_END,
+	MUGEN_TOKEN_WORD,
+	MUGEN_TOKEN_STRING,
+	MUGEN_TOKEN_OPEN_PARENTHESIS,
+	MUGEN_TOKEN_CLOSE_PARENTHESIS,
+	MUGEN_TOKEN_OPEN_BRACKET,
+	MUGEN_TOKEN_CLOSE_BRACKET,
+	MUGEN_TOKEN_COMMA,
+	MUGEN_TOKEN_NEGATION,
+
+	MUGEN_TOKEN_OR,
+	MUGEN_TOKEN_AND,
+	MUGEN_TOKEN_BITWISE_OR,
+	MUGEN_TOKEN_BITWISE_AND,
+	MUGEN_TOKEN_SET_VARIABLE,
+	MUGEN_TOKEN_INEQUALITY,
+	MUGEN_TOKEN_COMPARISON,
+	MUGEN_TOKEN_GREATER_OR_EQUAL,
+	MUGEN_TOKEN_LESS_OR_EQUAL,
+	MUGEN_TOKEN_LESS,
+	MUGEN_TOKEN_GREATER,
+	MUGEN_TOKEN_ADDITION,
+	MUGEN_TOKEN_SUBTRACTION,
+	MUGEN_TOKEN_MODULO,
+	MUGEN_TOKEN_MULTIPLICATION,
+	MUGEN_TOKEN_DIVISION,
+	MUGEN_TOKEN_EXPONENTIATION,
+} MugenAssignmentTokenType;
+
+// binary operators bind tighter the later they appear in the token enum, operator arguments like ">= 3" sit just above vectors
+#define MUGEN_OPERATOR_ARGUMENT_LEVEL 1
+
+static const DreamMugenAssignmentType gMugenBinaryTokenAssignmentTypes[] = {
+	MUGEN_ASSIGNMENT_TYPE_OR,
+	MUGEN_ASSIGNMENT_TYPE_AND,
+	MUGEN_ASSIGNMENT_TYPE_BITWISE_OR,
+	MUGEN_ASSIGNMENT_TYPE_BITWISE_AND,
+	MUGEN_ASSIGNMENT_TYPE_SET_VARIABLE,
+	MUGEN_ASSIGNMENT_TYPE_INEQUALITY,
+	MUGEN_ASSIGNMENT_TYPE_COMPARISON,
+	MUGEN_ASSIGNMENT_TYPE_GREATER_OR_EQUAL,
+	MUGEN_ASSIGNMENT_TYPE_LESS_OR_EQUAL,
+	MUGEN_ASSIGNMENT_TYPE_LESS,
+	MUGEN_ASSIGNMENT_TYPE_GREATER,
+	MUGEN_ASSIGNMENT_TYPE_ADDITION,
+	MUGEN_ASSIGNMENT_TYPE_SUBTRACTION,
+	MUGEN_ASSIGNMENT_TYPE_MODULO,
+	MUGEN_ASSIGNMENT_TYPE_MULTIPLICATION,
+	MUGEN_ASSIGNMENT_TYPE_DIVISION,
+	MUGEN_ASSIGNMENT_TYPE_EXPONENTIATION,
+};
+
+typedef struct {
+	const char* mText;
+	const char* mPosition;
+
+	MugenAssignmentTokenType mToken;
+	const char* mTokenStart;
+	int mTokenLength;
+
+	const char* mLastWord;
+	int mLastWordLength;
+} MugenAssignmentParser;
+
+static int isMugenAssignmentSpace(char tChar) {
+	return tChar == ' ' || tChar == '\t';
+}
+
+static int isMugenAssignmentWordCharacter(const char* tPosition) {
+	switch (*tPosition) {
+	case '\0':
+	case '(':
+	case ')':
+	case '[':
+	case ']':
+	case ',':
+	case '"':
+	case '=':
+	case '!':
+	case '<':
+	case '>':
+	case '&':
+	case '|':
+	case '+':
+	case '-':
+	case '*':
+	case '/':
+	case '%':
+		return 0;
+	case ':':
+		return tPosition[1] != '=';
+	default:
+		return 1;
+	}
 }
 
-static void sanitizeTextFront(char** tText) {
-	int n = strlen(*tText);
-	int i;
-	for (i = 0; i < n; i++) {
-		if (**tText != ' ' && **tText != '\t') {
-			return;
-		}
+static void setMugenAssignmentToken(MugenAssignmentParser* tParser, MugenAssignmentTokenType tToken, int tLength) {
+	tParser->mToken = tToken;
+	tParser->mTokenLength = tLength;
+	tParser->mPosition += tLength;
+}
+
+static void readNextMugenAssignmentToken(MugenAssignmentParser* tParser) {
+	while (isMugenAssignmentSpace(*tParser->mPosition)) tParser->mPosition++;
+
+	const char* p = tParser->mPosition;
+	tParser->mTokenStart = p;
+	switch (*p) {
+	case '\0': setMugenAssignmentToken(tParser, MUGEN_TOKEN_END, 0); return;
+	case '(': setMugenAssignmentToken(tParser, MUGEN_TOKEN_OPEN_PARENTHESIS, 1); return;
+	case ')': setMugenAssignmentToken(tParser, MUGEN_TOKEN_CLOSE_PARENTHESIS, 1); return;
+	case '[': setMugenAssignmentToken(tParser, MUGEN_TOKEN_OPEN_BRACKET, 1); return;
+	case ']': setMugenAssignmentToken(tParser, MUGEN_TOKEN_CLOSE_BRACKET, 1); return;
+	case ',': setMugenAssignmentToken(tParser, MUGEN_TOKEN_COMMA, 1); return;
+	case '=': setMugenAssignmentToken(tParser, MUGEN_TOKEN_COMPARISON, 1); return;
+	case '+': setMugenAssignmentToken(tParser, MUGEN_TOKEN_ADDITION, 1); return;
+	case '-': setMugenAssignmentToken(tParser, MUGEN_TOKEN_SUBTRACTION, 1); return;
+	case '%': setMugenAssignmentToken(tParser, MUGEN_TOKEN_MODULO, 1); return;
+	case '/': setMugenAssignmentToken(tParser, MUGEN_TOKEN_DIVISION, 1); return;
+	case '!':
+		if (p[1] == '=') setMugenAssignmentToken(tParser, MUGEN_TOKEN_INEQUALITY, 2);
+		else setMugenAssignmentToken(tParser, MUGEN_TOKEN_NEGATION, 1);
+		return;
+	case '<':
+		if (p[1] == '=') setMugenAssignmentToken(tParser, MUGEN_TOKEN_LESS_OR_EQUAL, 2);
+		else setMugenAssignmentToken(tParser, MUGEN_TOKEN_LESS, 1);
+		return;
+	case '>':
+		if (p[1] == '=') setMugenAssignmentToken(tParser, MUGEN_TOKEN_GREATER_OR_EQUAL, 2);
+		else setMugenAssignmentToken(tParser, MUGEN_TOKEN_GREATER, 1);
+		return;
+	case '&':
+		if (p[1] == '&') setMugenAssignmentToken(tParser, MUGEN_TOKEN_AND, 2);
+		else setMugenAssignmentToken(tParser, MUGEN_TOKEN_BITWISE_AND, 1);
+		return;
+	case '|':
+		if (p[1] == '|') setMugenAssignmentToken(tParser, MUGEN_TOKEN_OR, 2);
+		else setMugenAssignmentToken(tParser, MUGEN_TOKEN_BITWISE_OR, 1);
+		return;
+	case '*':
+		if (p[1] == '*') setMugenAssignmentToken(tParser, MUGEN_TOKEN_EXPONENTIATION, 2);
+		else setMugenAssignmentToken(tParser, MUGEN_TOKEN_MULTIPLICATION, 1);
+		return;
+	case ':':
+		if (p[1] != '=') break;
+		setMugenAssignmentToken(tParser, MUGEN_TOKEN_SET_VARIABLE, 2);
+		return;
+	case '"':
+		p++;
+		while (*p && *p != '"') p++;
+		setMugenAssignmentToken(tParser, MUGEN_TOKEN_STRING, int(p - tParser->mPosition) + (*p == '"'));
+		return;
+	default:
+		break;
+	}
 
-		(*tText)++;
+	const char* end = p;
+	while (isMugenAssignmentWordCharacter(p)) {
+		p++;
+		if (!isMugenAssignmentSpace(p[-1])) end = p;
 	}
+	setMugenAssignmentToken(tParser, MUGEN_TOKEN_WORD, int(end - tParser->mPosition));
+	tParser->mPosition = p;
 }
 
-static void sanitizeTextBack(char* tText) {
-	int n = strlen(tText);
+static int getMugenStringTokenContentLength(MugenAssignmentParser* tParser) {
+	int length = tParser->mTokenLength - 1;
+	if (length > 0 && tParser->mTokenStart[tParser->mTokenLength - 1] == '"') length--;
+	return length;
+}
 
-	int i;
-	for (i = n - 1; i >= 0; i--) {
-		if (tText[i] == ' ' || tText[i] == '\t') tText[i] = '\0';
-		else if (tText[i] == ',') tText[i] = '\0';
-		else return;
-	}
+static int isMugenBinaryToken(MugenAssignmentTokenType tToken) {
+	return tToken >= MUGEN_TOKEN_OR;
 }
 
-static void sanitizeText(char** tText) {
-	sanitizeTextFront(tText);
-	sanitizeTextBack(*tText);
+static int getMugenBinaryTokenLevel(MugenAssignmentTokenType tToken) {
+	return MUGEN_OPERATOR_ARGUMENT_LEVEL + 1 + (tToken - MUGEN_TOKEN_OR);
 }
 
+static int isMugenOperatorArgumentToken(MugenAssignmentTokenType tToken) {
+	return tToken == MUGEN_TOKEN_COMPARISON || tToken == MUGEN_TOKEN_GREATER_OR_EQUAL || tToken == MUGEN_TOKEN_LESS_OR_EQUAL || tToken == MUGEN_TOKEN_LESS || tToken == MUGEN_TOKEN_GREATER;
+}
 
-static int isArray(char* tText) {
+static int isMugenExpressionEndToken(MugenAssignmentTokenType tToken) {
+	return tToken == MUGEN_TOKEN_END || tToken == MUGEN_TOKEN_CLOSE_PARENTHESIS || tToken == MUGEN_TOKEN_CLOSE_BRACKET;
+}
 
-	int n = strlen(tText);
-	char* open = strchr(tText, '(');
-	char* close = strrchr(tText, ')');
+static void copyMugenAssignmentTokenText(char* tDst, const char* tStart, int tLength) {
+	tLength = min(tLength, MUGEN_DEF_STRING_LENGTH - 1);
+	memcpy(tDst, tStart, tLength);
+	tDst[tLength] = '\0';
+}
 
-	return open != NULL && close != NULL && close > open && open != tText && close == (tText + n - 1);
+static int doesMugenWordBeginWithPattern(const char* tWord, int tLength, const char* tPattern) {
+	int i;
+	for (i = 0; tPattern[i]; i++) {
+		if (i >= tLength || tolower(tWord[i]) != tPattern[i]) return 0;
+	}
+	return 1;
 }
 
-static DreamMugenAssignment* parseArrayFromString(char* tText) {
-	int posOpen = -1;
-	posOpen = strchr(tText, '(') - tText;
-	assert(posOpen >= 0);
-	assert((strrchr(tText, ')') - tText) >= 0);
+static int isMugenRedirectWord(const char* tWord, int tLength) {
+	const char* lastSpace = tWord;
+	int i;
+	for (i = 0; i < tLength; i++) {
+		if (isMugenAssignmentSpace(tWord[i])) lastSpace = tWord + i + 1;
+	}
+	tLength -= int(lastSpace - tWord);
+	tWord = lastSpace;
 
-	char text1[MUGEN_DEF_STRING_LENGTH];
-	char text2[MUGEN_DEF_STRING_LENGTH];
+	return doesMugenWordBeginWithPattern(tWord, tLength, "target")
+		|| doesMugenWordBeginWithPattern(tWord, tLength, "p1")
+		|| doesMugenWordBeginWithPattern(tWord, tLength, "p2")
+		|| doesMugenWordBeginWithPattern(tWord, tLength, "helper")
+		|| doesMugenWordBeginWithPattern(tWord, tLength, "enemy")
+		|| doesMugenWordBeginWithPattern(tWord, tLength, "root")
+		|| doesMugenWordBeginWithPattern(tWord, tLength, "playerid")
+		|| doesMugenWordBeginWithPattern(tWord, tLength, "parent");
+}
 
-	strcpy(text1, tText);
-	text1[posOpen] = '\0';
+static int isMugenVectorComparisonWord(const char* tWord, int tLength) {
+	if (!tWord) return 0;
 
-	char* saneText1 = text1;
-	sanitizeText(&saneText1);
-	turnStringLowercase(saneText1);
+	return doesMugenWordBeginWithPattern(tWord, tLength, "animelem")
+		|| doesMugenWordBeginWithPattern(tWord, tLength, "timemod")
+		|| doesMugenWordBeginWithPattern(tWord, tLength, "hitdefattr");
+}
 
-	strcpy(text2, &tText[posOpen+1]);
-	char* text2End = strrchr(text2, ')');
-	*text2End = '\0';
+static DreamMugenAssignment* parseMugenAssignmentExpression(MugenAssignmentParser* tParser, int tMinimumLevel, int tAllowsVector);
+static DreamMugenAssignment* parseMugenAssignmentUnary(MugenAssignmentParser* tParser, int tMinimumLevel);
 
-	DreamMugenAssignment* b = parseDreamMugenAssignmentFromString(text2);
-	return makeMugenArrayAssignment(saneText1, b);
+static DreamMugenAssignment* makeMugenRangeAssignment(uint8_t tExcludeLeft, uint8_t tExcludeRight, DreamMugenAssignment* a) {
+	MugenAssignmentInternKey key = makeMugenAssignmentInternKey(MUGEN_ASSIGNMENT_TYPE_RANGE);
+	key.mFlags = tExcludeLeft | (tExcludeRight << 1);
+	key.a = a;
+	DreamMugenAssignment* shared = findInternedMugenAssignment(key);
+	if (shared) return shared;
+
+	DreamMugenRangeAssignment* e = (DreamMugenRangeAssignment*)allocMemoryOnMemoryStackOrMemory(sizeof(DreamMugenRangeAssignment));
+	gDebugAssignmentAmount++;
+	e->mExcludeLeft = tExcludeLeft;
+	e->mExcludeRight = tExcludeRight;
+	e->a = a;
+	e->mType = MUGEN_ASSIGNMENT_TYPE_RANGE;
+	return internMugenAssignment(key, (DreamMugenAssignment*)e);
 }
 
-static int isVectorAssignment(char* tText, int tPotentialCommaPosition) {
-	int endPosition = -1;
-	while (endPosition < tPotentialCommaPosition) {
-		int newPosition;
-		if (!isOnHighestLevelWithStartPosition(tText, "=", &newPosition, endPosition + 1, 1)) break;
-		if (newPosition >= tPotentialCommaPosition) break;
-		endPosition = newPosition;
-	}
-	endPosition--;
-	while (endPosition >= 0 && isEmptyCharacter(tText[endPosition])) {
-		endPosition--;
+static DreamMugenAssignment* parseMugenAssignmentBracketsFromTokens(MugenAssignmentParser* tParser) {
+	MugenAssignmentTokenType open = tParser->mToken;
+	readNextMugenAssignmentToken(tParser);
+	DreamMugenAssignment* a = parseMugenAssignmentExpression(tParser, 0, 1);
+
+	MugenAssignmentTokenType close = tParser->mToken;
+	if (close == MUGEN_TOKEN_CLOSE_PARENTHESIS || close == MUGEN_TOKEN_CLOSE_BRACKET) {
+		readNextMugenAssignmentToken(tParser);
 	}
-	if (endPosition <= 0) return 0;
-	int startPosition = endPosition;
-	while (startPosition > 0 && !isEmptyCharacter(tText[startPosition])) {
-		startPosition--;
+	else {
+		logWarningFormat("Parsing error: Unclosed bracket in assignment %s", tParser->mText);
+		close = open == MUGEN_TOKEN_OPEN_PARENTHESIS ? MUGEN_TOKEN_CLOSE_PARENTHESIS : MUGEN_TOKEN_CLOSE_BRACKET;
 	}
-	if (isEmptyCharacter(tText[startPosition])) startPosition++;
-
-	const char* textArea = tText + startPosition;
-	char* text = (char*)allocMemory(strlen(textArea) + 2);
-	strcpy(text, textArea);
-	turnStringLowercase(text);
+	tParser->mLastWord = NULL;
 
-	int ret;
-	if (doDreamAssignmentStringsBeginsWithPattern("animelem", text)) ret = 1;
-	else if (doDreamAssignmentStringsBeginsWithPattern("timemod", text)) ret = 1;
-	else if (doDreamAssignmentStringsBeginsWithPattern("hitdefattr", text)) ret = 1;
-	else ret = 0;
+	if (open == MUGEN_TOKEN_OPEN_PARENTHESIS && close == MUGEN_TOKEN_CLOSE_PARENTHESIS) {
+		return a;
+	}
 
-	freeMemory(text);
-	return ret;
+	return makeMugenRangeAssignment(open == MUGEN_TOKEN_OPEN_PARENTHESIS, close == MUGEN_TOKEN_CLOSE_PARENTHESIS, a);
 }
 
-static int isVectorTarget(char* tText) {
-	char* text = (char*)allocMemory(strlen(tText) + 2);
-	strcpy(text, tText);
-	turnStringLowercase(text);
+static DreamMugenAssignment* parseMugenAssignmentWordFromTokens(MugenAssignmentParser* tParser) {
+	char word[MUGEN_DEF_STRING_LENGTH];
+	const char* wordStart = tParser->mTokenStart;
+	int wordLength = tParser->mTokenLength;
+	copyMugenAssignmentTokenText(word, wordStart, wordLength);
+	readNextMugenAssignmentToken(tParser);
 
-	int ret;
-	if (doDreamAssignmentStringsBeginsWithPattern("target", text)) ret = 1;
-	else if (doDreamAssignmentStringsBeginsWithPattern("p1", text)) ret = 1;
-	else if (doDreamAssignmentStringsBeginsWithPattern("p2", text)) ret = 1;
-	else if (doDreamAssignmentStringsBeginsWithPattern("helper", text)) ret = 1;
-	else if (doDreamAssignmentStringsBeginsWithPattern("enemy", text)) ret = 1;
-	else if (doDreamAssignmentStringsBeginsWithPattern("enemynear", text)) ret = 1;
-	else if (doDreamAssignmentStringsBeginsWithPattern("root", text)) ret = 1;
-	else if (doDreamAssignmentStringsBeginsWithPattern("playerid", text)) ret = 1;
-	else if (doDreamAssignmentStringsBeginsWithPattern("parent", text)) ret = 1;
-	else ret = 0;
+	DreamMugenAssignment* ret;
+	if (tParser->mToken == MUGEN_TOKEN_OPEN_PARENTHESIS) {
+		readNextMugenAssignmentToken(tParser);
+		DreamMugenAssignment* index = parseMugenAssignmentExpression(tParser, 0, 1);
+		if (tParser->mToken == MUGEN_TOKEN_CLOSE_PARENTHESIS) {
+			readNextMugenAssignmentToken(tParser);
+		}
+		else {
+			logWarningFormat("Parsing error: Unclosed array access in assignment %s", tParser->mText);
+		}
+		turnStringLowercase(word);
+		ret = makeMugenArrayAssignment(word, index);
+	}
+	else if (isNumericalConstant(word)) {
+		ret = parseNumericalConstantFromString(word);
+	}
+	else if (isFloatConstant(word)) {
+		ret = parseFloatConstantFromString(word);
+	}
+	else {
+		turnStringLowercase(word);
+		ret = parseMugenVariableOrRawVariableFromString(word);
+	}
+	tParser->mLastWord = wordStart;
+	tParser->mLastWordLength = wordLength;
+
+	if (tParser->mToken == MUGEN_TOKEN_COMMA && isMugenRedirectWord(wordStart, wordLength)) {
+		readNextMugenAssignmentToken(tParser);
+		if (isMugenExpressionEndToken(tParser->mToken)) return ret;
+		DreamMugenAssignment* b = parseMugenAssignmentUnary(tParser, MUGEN_OPERATOR_ARGUMENT_LEVEL);
+		ret = makeFoldedMugenTwoElementAssignment(MUGEN_ASSIGNMENT_TYPE_VECTOR, ret, b);
+	}
 
-	freeMemory(text);
 	return ret;
 }
 
-static int isCommaContextFree(char* tText, int tPosition) {
-	assert(tText[tPosition] == ',');
-	tPosition--;
-	while (tPosition >= 0 && isEmptyCharacter(tText[tPosition])) tPosition--;
-	int end = tPosition+1;
+static DreamMugenAssignment* parseMugenAssignmentUnary(MugenAssignmentParser* tParser, int tMinimumLevel) {
+	DreamMugenAssignment* a;
+	char operatorText[3];
+	switch (tParser->mToken) {
+	case MUGEN_TOKEN_NEGATION:
+		readNextMugenAssignmentToken(tParser);
+		a = parseMugenAssignmentUnary(tParser, tMinimumLevel);
+		return makeFoldedMugenOneElementAssignment(MUGEN_ASSIGNMENT_TYPE_NEGATION, a);
+	case MUGEN_TOKEN_SUBTRACTION:
+		readNextMugenAssignmentToken(tParser);
+		a = parseMugenAssignmentUnary(tParser, tMinimumLevel);
+		return makeFoldedMugenOneElementAssignment(MUGEN_ASSIGNMENT_TYPE_UNARY_MINUS, a);
+	case MUGEN_TOKEN_ADDITION:
+		readNextMugenAssignmentToken(tParser);
+		return parseMugenAssignmentUnary(tParser, tMinimumLevel);
+	case MUGEN_TOKEN_COMPARISON:
+	case MUGEN_TOKEN_GREATER_OR_EQUAL:
+	case MUGEN_TOKEN_LESS_OR_EQUAL:
+	case MUGEN_TOKEN_LESS:
+	case MUGEN_TOKEN_GREATER:
+		copyMugenAssignmentTokenText(operatorText, tParser->mTokenStart, tParser->mTokenLength);
+		readNextMugenAssignmentToken(tParser);
+		a = parseMugenAssignmentExpression(tParser, max(tMinimumLevel, MUGEN_OPERATOR_ARGUMENT_LEVEL), 0);
+		return makeFoldedMugenTwoElementAssignment(MUGEN_ASSIGNMENT_TYPE_OPERATOR_ARGUMENT, parseMugenRawVariableFromString(operatorText), a);
+	case MUGEN_TOKEN_STRING:
+		a = parseStringConstantFromString(tParser->mTokenStart + 1, getMugenStringTokenContentLength(tParser));
+		readNextMugenAssignmentToken(tParser);
+		tParser->mLastWord = NULL;
+		return a;
+	case MUGEN_TOKEN_OPEN_PARENTHESIS:
+	case MUGEN_TOKEN_OPEN_BRACKET:
+		return parseMugenAssignmentBracketsFromTokens(tParser);
+	case MUGEN_TOKEN_WORD:
+		return parseMugenAssignmentWordFromTokens(tParser);
+	default:
+		return parseMugenNullFromString();
+	}
+}
 
-	int depth1 = 0;
-	int depth2 = 0;
-	while (tPosition >= 0) {
-		if (tText[tPosition] == ')') depth1++;
-		if (tText[tPosition] == '(') {
-			if (!depth1) break;
-			else depth1--;
-		}
-		if (tText[tPosition] == ']') depth2++;
-		if (tText[tPosition] == '[') {
-			if (!depth2) break;
-			else depth2--;
-		}
+static DreamMugenAssignment* parseMugenAssignmentExpression(MugenAssignmentParser* tParser, int tMinimumLevel, int tAllowsVector) {
+	DreamMugenAssignment* a = parseMugenAssignmentUnary(tParser, tMinimumLevel);
 
-		if (!depth1 && !depth2 && (tText[tPosition] == ',' || isEmptyCharacter(tText[tPosition]) || isOperatorCharacter(tText[tPosition]))) break;
-		tPosition--;
+	while (isMugenBinaryToken(tParser->mToken)) {
+		MugenAssignmentTokenType token = tParser->mToken;
+		int level = getMugenBinaryTokenLevel(token);
+		if (level < tMinimumLevel) break;
+
+		int isVectorComparison = (token == MUGEN_TOKEN_COMPARISON || token == MUGEN_TOKEN_INEQUALITY) && isMugenVectorComparisonWord(tParser->mLastWord, tParser->mLastWordLength);
+		readNextMugenAssignmentToken(tParser);
+		DreamMugenAssignment* b = parseMugenAssignmentExpression(tParser, level, isVectorComparison);
+		a = makeFoldedMugenTwoElementAssignment(gMugenBinaryTokenAssignmentTypes[token - MUGEN_TOKEN_OR], a, b);
 	}
-	assert(tPosition >= -1);
-	int start = tPosition + 1;
 
-	char* prevWord = (char*)allocMemory(strlen(&tText[start]) + 2);
-	strcpy(prevWord, &tText[start]);
-	int length = end - start;
-	prevWord[length] = '\0';
+	if (!tAllowsVector || tParser->mToken != MUGEN_TOKEN_COMMA) return a;
+	readNextMugenAssignmentToken(tParser);
+	if (isMugenExpressionEndToken(tParser->mToken)) return a;
 
-	int ret = !isVectorTarget(prevWord);
-	freeMemory(prevWord);
-	return ret;
+	DreamMugenAssignment* b = parseMugenAssignmentExpression(tParser, tMinimumLevel, 1);
+	return makeFoldedMugenTwoElementAssignment(MUGEN_ASSIGNMENT_TYPE_VECTOR, a, b);
 }
 
-static int hasContextFreeComma(char* tText, int* tPosition) {
-	int isRunning = 1;
-	int position = 0;
-	while (isRunning) {
-		if (!isOnHighestLevelWithStartPosition(tText, ",", &position, position, 0)) return 0;
-		if (isCommaContextFree(tText, position)) {
-			if (tPosition) *tPosition = position;
-			return 1;
-		}
+DreamMugenAssignment * parseDreamMugenAssignmentFromString(char * tText)
+{
+	DreamMugenAssignment* cached = findDreamAssignmentCacheEntry(tText);
+	if (cached) {
+		checkDreamAssignmentTypes(cached, tText);
+		return cached;
+	}
 
-		position++;
+	MugenAssignmentParser parser;
+	parser.mText = tText;
+	parser.mPosition = tText;
+	parser.mLastWord = NULL;
+	parser.mLastWordLength = 0;
+	readNextMugenAssignmentToken(&parser);
+
+	DreamMugenAssignment* ret = parseMugenAssignmentExpression(&parser, 0, 1);
+	if (parser.mToken != MUGEN_TOKEN_END) {
+		logWarningFormat("Parsing error: Unexpected trailing text %s in assignment %s", parser.mTokenStart, tText);
 	}
+	checkDreamAssignmentTypes(ret, tText);
+	addDreamAssignmentCacheEntry(tText, ret);
 
-	return 0;
+	return ret;
 }
 
-static int isVector(char* tText) {
-	int position;
-	return hasContextFreeComma(tText, &position) && !isVectorAssignment(tText, position);
+DreamMugenAssignment*  parseDreamMugenAssignmentFromString(const char* tText) {
+	char evalText[1024];
+	strcpy(evalText, tText);
+	return parseDreamMugenAssignmentFromString(evalText);
 }
 
-static DreamMugenAssignment* parseMugenContextFreeVectorFromString(char* tText) {
-	int position;
-	hasContextFreeComma(tText, &position);
+uint8_t fetchDreamAssignmentFromGroupAndReturnWhetherItExists(const char* tName, MugenDefScriptGroup* tGroup, DreamMugenAssignment** tOutput) {
+	if (!stl_string_map_contains_array(tGroup->mElements, tName)) {
+		*tOutput = NULL;
+		return 0;
+	}
+	MugenDefScriptGroupElement* e = &tGroup->mElements[tName];
+	fetchDreamAssignmentFromGroupAsElement(e, tOutput);
 
-	return parseTwoElementMugenAssignmentFromStringWithFixedPosition(tText, MUGEN_ASSIGNMENT_TYPE_VECTOR, ",", position);
+	return 1;
 }
 
-static int isVectorInsideAssignmentOrTargetAccess(char* tText) {
-	return isOnHighestLevel(tText, ",", NULL);
+void fetchDreamAssignmentFromGroupAsElement(MugenDefScriptGroupElement * tElement, DreamMugenAssignment ** tOutput)
+{
+	char* text = getAllocatedMugenDefStringVariableForAssignmentAsElement(tElement);
+	*tOutput = parseDreamMugenAssignmentFromString(text);
+	compileDreamAssignmentProgram(tOutput);
+	freeMemory(text);
 }
 
-static DreamMugenAssignment* parseMugenVectorFromString(char* tText) {
-	return parseTwoElementMugenAssignmentFromString(tText, MUGEN_ASSIGNMENT_TYPE_VECTOR, ",");
+
+extern const char* findMugenAssignmentVariableName(void* tFunc);
+extern const char* findMugenAssignmentArrayName(void* tFunc);
+
+static void writeMugenAssignmentBytes(vector<uint8_t>& oBuffer, const void* tData, size_t tSize) {
+	const uint8_t* data = (const uint8_t*)tData;
+	oBuffer.insert(oBuffer.end(), data, data + tSize);
 }
 
-static int isOperatorAndReturnType(char* tText, char* tDst) {
-	int position;
-	int isThere;
-	int isDifferent;
+static int writeMugenAssignmentName(vector<uint8_t>& oBuffer, const char* tName) {
+	if (!tName) return 0;
+	uint16_t length = (uint16_t)strlen(tName);
+	writeMugenAssignmentBytes(oBuffer, &length, sizeof(uint16_t));
+	writeMugenAssignmentBytes(oBuffer, tName, length);
+	return 1;
+}
 
-	isThere = isOnHighestLevel(tText, ">=", &position);
-	isDifferent = strcmp(">=", tText);
-	if (isThere && isDifferent && position == 0) {
-		strcpy(tDst, ">=");
+// static and program nodes only wrap trees after they are compiled, so they are never written
+int serializeDreamMugenAssignment(vector<uint8_t>& oBuffer, DreamMugenAssignment* tAssignment) {
+	oBuffer.push_back(tAssignment->mType);
+	switch (tAssignment->mType) {
+	case MUGEN_ASSIGNMENT_TYPE_FIXED_BOOLEAN:
+	case MUGEN_ASSIGNMENT_TYPE_NULL:
+		oBuffer.push_back(((DreamMugenFixedBooleanAssignment*)tAssignment)->mValue);
 		return 1;
+	case MUGEN_ASSIGNMENT_TYPE_NEGATION:
+	case MUGEN_ASSIGNMENT_TYPE_UNARY_MINUS:
+		return serializeDreamMugenAssignment(oBuffer, ((DreamMugenDependOnOneAssignment*)tAssignment)->a);
+	case MUGEN_ASSIGNMENT_TYPE_RANGE: {
+		DreamMugenRangeAssignment* range = (DreamMugenRangeAssignment*)tAssignment;
+		oBuffer.push_back(range->mExcludeLeft | (range->mExcludeRight << 1));
+		return serializeDreamMugenAssignment(oBuffer, range->a);
 	}
-
-	isThere = isOnHighestLevel(tText, "<=", &position);
-	isDifferent = strcmp("<=", tText);
-	if (isThere && isDifferent && position == 0) {
-		strcpy(tDst, "<=");
+	case MUGEN_ASSIGNMENT_TYPE_VARIABLE:
+		return writeMugenAssignmentName(oBuffer, findMugenAssignmentVariableName(((DreamMugenVariableAssignment*)tAssignment)->mFunc));
+	case MUGEN_ASSIGNMENT_TYPE_RAW_VARIABLE:
+		return writeMugenAssignmentName(oBuffer, ((DreamMugenRawVariableAssignment*)tAssignment)->mName);
+	case MUGEN_ASSIGNMENT_TYPE_ARRAY: {
+		DreamMugenArrayAssignment* array = (DreamMugenArrayAssignment*)tAssignment;
+		if (!writeMugenAssignmentName(oBuffer, findMugenAssignmentArrayName(array->mFunc))) return 0;
+		return serializeDreamMugenAssignment(oBuffer, array->mIndex);
+	}
+	case MUGEN_ASSIGNMENT_TYPE_TRIGGER: {
+		DreamMugenTriggerAssignment* trigger = (DreamMugenTriggerAssignment*)tAssignment;
+		if (!writeMugenAssignmentName(oBuffer, trigger->mName)) return 0;
+		oBuffer.push_back(trigger->mKind);
 		return 1;
 	}
-
-	isThere = isOnHighestLevel(tText, "=", &position);
-	isDifferent = strcmp("=", tText);
-	if (isThere && isDifferent && position == 0) {
-		strcpy(tDst, "=");
+	case MUGEN_ASSIGNMENT_TYPE_REDIRECT: {
+		DreamMugenRedirectAssignment* redirect = (DreamMugenRedirectAssignment*)tAssignment;
+		oBuffer.push_back(redirect->mTarget);
+		oBuffer.push_back(redirect->mIndex != NULL);
+		return !redirect->mIndex || serializeDreamMugenAssignment(oBuffer, redirect->mIndex);
+	}
+	case MUGEN_ASSIGNMENT_TYPE_FLAGS: {
+		DreamMugenFlagsAssignment* flags = (DreamMugenFlagsAssignment*)tAssignment;
+		oBuffer.push_back(flags->mKind);
+		oBuffer.push_back(flags->mIsP2);
+		writeMugenAssignmentBytes(oBuffer, &flags->mMask, sizeof(uint32_t));
 		return 1;
 	}
-
-	isThere = isOnHighestLevel(tText, "<", &position);
-	isDifferent = strcmp("<", tText);
-	if (isThere && isDifferent && position == 0 && tText[1] != '=') {
-		strcpy(tDst, "<");
+	case MUGEN_ASSIGNMENT_TYPE_CONDITIONAL: {
+		DreamMugenConditionalAssignment* conditional = (DreamMugenConditionalAssignment*)tAssignment;
+		oBuffer.push_back(conditional->mIsEager);
+		return serializeDreamMugenAssignment(oBuffer, conditional->mCondition) && serializeDreamMugenAssignment(oBuffer, conditional->mTrue) && serializeDreamMugenAssignment(oBuffer, conditional->mFalse);
+	}
+	case MUGEN_ASSIGNMENT_TYPE_NUMBER: {
+		int32_t value = ((DreamMugenNumberAssignment*)tAssignment)->mValue;
+		writeMugenAssignmentBytes(oBuffer, &value, sizeof(int32_t));
 		return 1;
 	}
-
-	isThere = isOnHighestLevel(tText, ">", &position);
-	isDifferent = strcmp(">", tText);
-	if (isThere && isDifferent && position == 0 && tText[1] != '=') {
-		strcpy(tDst, ">");
+	case MUGEN_ASSIGNMENT_TYPE_FLOAT:
+		writeMugenAssignmentBytes(oBuffer, &((DreamMugenFloatAssignment*)tAssignment)->mValue, sizeof(double));
 		return 1;
+	case MUGEN_ASSIGNMENT_TYPE_STRING:
+		return writeMugenAssignmentName(oBuffer, ((DreamMugenStringAssignment*)tAssignment)->mValue);
+	case MUGEN_ASSIGNMENT_TYPE_STATIC:
+	case MUGEN_ASSIGNMENT_TYPE_PROGRAM:
+	case MUGEN_ASSIGNMENT_TYPE_AMOUNT:
+		return 0;
+	default: {
+		DreamMugenDependOnTwoAssignment* two = (DreamMugenDependOnTwoAssignment*)tAssignment;
+		return serializeDreamMugenAssignment(oBuffer, two->a) && serializeDreamMugenAssignment(oBuffer, two->b);
+	}
 	}
-
-	return 0;
 }
 
-static int isOperatorArgument(char* tText) {
-	char dst[10];
+typedef struct {
+	const uint8_t* mPosition;
+	const uint8_t* mEnd;
+} MugenAssignmentReader;
 
-	int ret = isOperatorAndReturnType(tText, dst);
-	return ret;
+static int readMugenAssignmentBytes(MugenAssignmentReader* tReader, void* oData, size_t tSize) {
+	if (size_t(tReader->mEnd - tReader->mPosition) < tSize) return 0;
+	memcpy(oData, tReader->mPosition, tSize);
+	tReader->mPosition += tSize;
+	return 1;
 }
 
-static DreamMugenAssignment* parseMugenOperatorArgumentFromString(char* tText) {
-	char dst[10];
-	char text[200];
-	isOperatorAndReturnType(tText, dst);
+static int readMugenAssignmentByte(MugenAssignmentReader* tReader, uint8_t* oValue) {
+	return readMugenAssignmentBytes(tReader, oValue, 1);
+}
 
-	sprintf(text, "%s $$ %s", dst, tText + strlen(dst));
-	return parseTwoElementMugenAssignmentFromString(text, MUGEN_ASSIGNMENT_TYPE_OPERATOR_ARGUMENT, "$$");
+static int readMugenAssignmentName(MugenAssignmentReader* tReader, char* oName, int tBufferSize) {
+	uint16_t length;
+	if (!readMugenAssignmentBytes(tReader, &length, sizeof(uint16_t)) || length >= tBufferSize) return 0;
+	if (!readMugenAssignmentBytes(tReader, oName, length)) return 0;
+	oName[length] = '\0';
+	return 1;
 }
 
-DreamMugenAssignment * parseDreamMugenAssignmentFromString(char * tText)
-{
-	sanitizeText(&tText);
+static DreamMugenAssignment* readMugenAssignment(MugenAssignmentReader* tReader);
 
-	if (isEmpty(tText)) {
-		return parseMugenNullFromString();
-	}
-	else if (isVector(tText)) {
-		return parseMugenContextFreeVectorFromString(tText);
-	}
-	else if (isOperatorArgument(tText)) {
-		return parseMugenOperatorArgumentFromString(tText);
-	}
-	else if (isOr(tText)) {
-		return parseMugenOrFromString(tText);
-	}
-	else if (isAnd(tText)) {
-		return parseMugenAndFromString(tText);
-	}
-	else if (isBitwiseOr(tText)) {
-		return parseMugenBitwiseOrFromString(tText);
-	}
-	else if (isBitwiseAnd(tText)) {
-		return parseMugenBitwiseAndFromString(tText);
-	}
-	else if (isVariableSet(tText)) {
-		return parseMugenVariableSetFromString(tText);
-	}
-	else if (isInequality(tText)) {
-		return parseMugenInequalityFromString(tText);
-	}
-	else if (isComparison(tText)) {
-		return parseMugenComparisonFromString(tText);
-	}
-	else if (isGreaterOrEqualThan(tText)) {
-		return parseMugenGreaterOrEqualFromString(tText);
-	}
-	else if (isLessOrEqualThan(tText)) {
-		return parseMugenLessOrEqualFromString(tText);
-	}
-	else if (isLessThan(tText)) {
-		return parseMugenLessFromString(tText);
-	}
-	else if (isGreaterThan(tText)) {
-		return parseMugenGreaterFromString(tText);
+static int readMugenAssignmentChildren(MugenAssignmentReader* tReader, DreamMugenAssignment** oChildren, int tAmount) {
+	for (int i = 0; i < tAmount; i++) {
+		oChildren[i] = readMugenAssignment(tReader);
+		if (!oChildren[i]) {
+			for (int j = 0; j < i; j++) discardFoldedMugenAssignment(oChildren[j]);
+			return 0;
+		}
 	}
+	return 1;
+}
 
-	else if (isAddition(tText)) {
-		return parseMugenAdditionFromString(tText);
-	}
-	else if (isSubtraction(tText)) {
-		return parseMugenSubtractionFromString(tText);
-	}
-	else if (isModulo(tText)) {
-		return parseMugenModuloFromString(tText);
-	}
-	else if (isMultiplication(tText)) {
-		return parseMugenMultiplicationFromString(tText);
-	}
-	else if (isDivision(tText)) {
-		return parseMugenDivisionFromString(tText);
-	}
-	else if (isExponentiation(tText)) {
-		return parseMugenExponentiationFromString(tText);
-	}
-	else if (isNegation(tText)) {
-		return parseMugenNegationFromString(tText);
-	}
-	else if (isUnaryMinus(tText)) {
-		return parseMugenUnaryMinusFromString(tText);
-	}
-	else if (isInBraces(tText)) {
-		return parseMugenAssignmentStringInBraces(tText);
+static DreamMugenAssignment* readMugenTriggerAssignment(MugenAssignmentReader* tReader) {
+	char name[1024];
+	uint8_t storedKind;
+	if (!readMugenAssignmentName(tReader, name, sizeof(name)) || !readMugenAssignmentByte(tReader, &storedKind)) return NULL;
+
+	uint8_t kind;
+	void* func;
+	int projectileID;
+	if (!resolveMugenAssignmentTrigger(name, storedKind == MUGEN_TRIGGER_KIND_ORDINAL, &kind, &func, &projectileID) || kind != storedKind) return NULL;
+
+	char* ownedName = (char*)allocMemoryOnMemoryStackOrMemory(strlen(name) + 2);
+	strcpy(ownedName, name);
+	return makeMugenTriggerAssignment(ownedName, kind, projectileID, func);
+}
+
+static DreamMugenAssignment* readMugenAssignment(MugenAssignmentReader* tReader) {
+	uint8_t type;
+	if (!readMugenAssignmentByte(tReader, &type)) return NULL;
+
+	char name[1024];
+	DreamMugenAssignment* children[3];
+	switch (type) {
+	case MUGEN_ASSIGNMENT_TYPE_FIXED_BOOLEAN:
+	case MUGEN_ASSIGNMENT_TYPE_NULL: {
+		uint8_t value;
+		if (!readMugenAssignmentByte(tReader, &value)) return NULL;
+		return makeMugenFixedBooleanAssignment((DreamMugenAssignmentType)type, value);
 	}
-	else if (isRange(tText)) {
-		return parseMugenRangeFromString(tText);
+	case MUGEN_ASSIGNMENT_TYPE_NEGATION:
+	case MUGEN_ASSIGNMENT_TYPE_UNARY_MINUS:
+		if (!readMugenAssignmentChildren(tReader, children, 1)) return NULL;
+		return makeMugenOneElementAssignment((DreamMugenAssignmentType)type, children[0]);
+	case MUGEN_ASSIGNMENT_TYPE_RANGE: {
+		uint8_t flags;
+		if (!readMugenAssignmentByte(tReader, &flags) || !readMugenAssignmentChildren(tReader, children, 1)) return NULL;
+		return makeMugenRangeAssignment(flags & 1, (flags >> 1) & 1, children[0]);
 	}
-	else if (isNumericalConstant(tText)) {
-		return parseNumericalConstantFromString(tText);
+	case MUGEN_ASSIGNMENT_TYPE_VARIABLE: {
+		if (!readMugenAssignmentName(tReader, name, sizeof(name))) return NULL;
+		void* func = findMugenAssignmentVariableFunction(name);
+		if (!func) return NULL;
+		return makeMugenVariableAssignment(func);
 	}
-	else if (isFloatConstant(tText)) {
-		return parseFloatConstantFromString(tText);
+	case MUGEN_ASSIGNMENT_TYPE_RAW_VARIABLE:
+		if (!readMugenAssignmentName(tReader, name, sizeof(name))) return NULL;
+		return parseMugenRawVariableFromString(name);
+	case MUGEN_ASSIGNMENT_TYPE_ARRAY: {
+		if (!readMugenAssignmentName(tReader, name, sizeof(name))) return NULL;
+		void* func = findMugenAssignmentArrayFunction(name);
+		if (!func || !readMugenAssignmentChildren(tReader, children, 1)) return NULL;
+		return makeMugenArrayFunctionAssignment(func, children[0]);
 	}
-	else if (isStringConstant(tText)) {
-		return parseStringConstantFromString(tText);
+	case MUGEN_ASSIGNMENT_TYPE_TRIGGER:
+		return readMugenTriggerAssignment(tReader);
+	case MUGEN_ASSIGNMENT_TYPE_REDIRECT: {
+		uint8_t target, hasIndex;
+		if (!readMugenAssignmentByte(tReader, &target) || !readMugenAssignmentByte(tReader, &hasIndex)) return NULL;
+		children[0] = NULL;
+		if (hasIndex && !readMugenAssignmentChildren(tReader, children, 1)) return NULL;
+		return makeMugenRedirectAssignment(target, children[0]);
 	}
-	else if (isVectorInsideAssignmentOrTargetAccess(tText)) {
-		return parseMugenVectorFromString(tText);
+	case MUGEN_ASSIGNMENT_TYPE_FLAGS: {
+		uint8_t kind, isP2;
+		uint32_t mask;
+		if (!readMugenAssignmentByte(tReader, &kind) || !readMugenAssignmentByte(tReader, &isP2) || !readMugenAssignmentBytes(tReader, &mask, sizeof(uint32_t))) return NULL;
+		return makeMugenFlagsNode(kind, isP2, mask);
 	}
-	else if (isMugenVariable(tText)) {
-		return parseMugenVariableFromString(tText);
+	case MUGEN_ASSIGNMENT_TYPE_CONDITIONAL: {
+		uint8_t isEager;
+		if (!readMugenAssignmentByte(tReader, &isEager) || !readMugenAssignmentChildren(tReader, children, 3)) return NULL;
+		return makeMugenConditionalNode(isEager, children[0], children[1], children[2]);
 	}
-	else if (isArray(tText)) {
-		return parseArrayFromString(tText);
+	case MUGEN_ASSIGNMENT_TYPE_NUMBER: {
+		int32_t value;
+		if (!readMugenAssignmentBytes(tReader, &value, sizeof(int32_t))) return NULL;
+		return makeDreamNumberMugenAssignment(value);
 	}
-	else {
-		return parseMugenRawVariableFromString(tText);
+	case MUGEN_ASSIGNMENT_TYPE_FLOAT: {
+		double value;
+		if (!readMugenAssignmentBytes(tReader, &value, sizeof(double))) return NULL;
+		return makeDreamFloatMugenAssignment(value);
 	}
-}
-
-DreamMugenAssignment*  parseDreamMugenAssignmentFromString(const char* tText) {
-	char evalText[1024];
-	strcpy(evalText, tText);
-	return parseDreamMugenAssignmentFromString(evalText);
-}
-
-uint8_t fetchDreamAssignmentFromGroupAndReturnWhetherItExists(const char* tName, MugenDefScriptGroup* tGroup, DreamMugenAssignment** tOutput) {
-	if (!stl_string_map_contains_array(tGroup->mElements, tName)) {
-		*tOutput = NULL;
-		return 0;
+	case MUGEN_ASSIGNMENT_TYPE_STRING:
+		if (!readMugenAssignmentName(tReader, name, sizeof(name))) return NULL;
+		return makeMugenStringAssignment(name, strlen(name));
+	case MUGEN_ASSIGNMENT_TYPE_STATIC:
+	case MUGEN_ASSIGNMENT_TYPE_PROGRAM:
+		return NULL;
+	default:
+		if (type >= MUGEN_ASSIGNMENT_TYPE_AMOUNT || !readMugenAssignmentChildren(tReader, children, 2)) return NULL;
+		return makeMugenTwoElementAssignment((DreamMugenAssignmentType)type, children[0], children[1]);
 	}
-	MugenDefScriptGroupElement* e = &tGroup->mElements[tName];
-	fetchDreamAssignmentFromGroupAsElement(e, tOutput);
-
-	return 1;
 }
 
-void fetchDreamAssignmentFromGroupAsElement(MugenDefScriptGroupElement * tElement, DreamMugenAssignment ** tOutput)
-{
-	char* text = getAllocatedMugenDefStringVariableForAssignmentAsElement(tElement);
-	*tOutput = parseDreamMugenAssignmentFromString(text);
-	freeMemory(text);
+DreamMugenAssignment* deserializeDreamMugenAssignment(const uint8_t** tPosition, const uint8_t* tEnd) {
+	MugenAssignmentReader reader;
+	reader.mPosition = *tPosition;
+	reader.mEnd = tEnd;
+	DreamMugenAssignment* ret = readMugenAssignment(&reader);
+	*tPosition = reader.mPosition;
+	return ret;
 }
-
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 #include <prism/geometry.h>
 
 #include <prism/mugendefreader.h>
@@ -19,7 +21,16 @@ typedef enum {
 
 typedef struct {
 	AssignmentReturnType mType;
-	char mData[200];
+	union {
+		int mNumber;
+		int mBoolean;
+		double mFloat;
+		const char* mString;
+		struct {
+			uint32_t a;
+			uint32_t b;
+		} mVector;
+	};
 } AssignmentReturnValue;
 
 enum DreamMugenAssignmentType : uint8_t {
@@ -54,6 +65,11 @@ enum DreamMugenAssignmentType : uint8_t {
 	MUGEN_ASSIGNMENT_TYPE_BITWISE_AND,
 	MUGEN_ASSIGNMENT_TYPE_BITWISE_OR,
 	MUGEN_ASSIGNMENT_TYPE_STATIC,
+	MUGEN_ASSIGNMENT_TYPE_PROGRAM,
+	MUGEN_ASSIGNMENT_TYPE_TRIGGER,
+	MUGEN_ASSIGNMENT_TYPE_REDIRECT,
+	MUGEN_ASSIGNMENT_TYPE_FLAGS,
+	MUGEN_ASSIGNMENT_TYPE_CONDITIONAL,
 	MUGEN_ASSIGNMENT_TYPE_AMOUNT
 };
 
@@ -78,6 +94,7 @@ typedef struct {
 
 typedef struct {
 	uint8_t mType;
+	uint8_t mMemoSymbol;
 	void* mFunc;
 } DreamMugenVariableAssignment;
 
@@ -86,6 +103,19 @@ typedef struct {
 	char* mName;
 } DreamMugenRawVariableAssignment;
 
+typedef enum : uint8_t {
+	MUGEN_TRIGGER_KIND_COMPARISON,
+	MUGEN_TRIGGER_KIND_ORDINAL,
+	MUGEN_TRIGGER_KIND_PROJECTILE,
+} DreamMugenTriggerKind;
+
+typedef struct {
+	uint8_t mType;
+	char* mName;
+	uint8_t mKind;
+	int mProjectileID;
+	void* mFunc;
+} DreamMugenTriggerAssignment;
 
 typedef struct {
 	uint8_t mType;
@@ -116,6 +146,75 @@ typedef struct {
 	DreamMugenAssignment* mIndex;
 } DreamMugenArrayAssignment;
 
+typedef enum : uint8_t {
+	MUGEN_REDIRECT_TARGET_P1,
+	MUGEN_REDIRECT_TARGET_P2,
+	MUGEN_REDIRECT_TARGET_TARGET,
+	MUGEN_REDIRECT_TARGET_ENEMY,
+	MUGEN_REDIRECT_TARGET_ENEMYNEAR,
+	MUGEN_REDIRECT_TARGET_ROOT,
+	MUGEN_REDIRECT_TARGET_PARENT,
+	MUGEN_REDIRECT_TARGET_HELPER,
+	MUGEN_REDIRECT_TARGET_PLAYERID,
+} DreamMugenRedirectTarget;
+
+typedef struct {
+	uint8_t mType;
+	uint8_t mTarget;
+	DreamMugenAssignment* mIndex;
+} DreamMugenRedirectAssignment;
+
+typedef enum : uint8_t {
+	MUGEN_FLAGS_KIND_STATE_TYPE,
+	MUGEN_FLAGS_KIND_MOVE_TYPE,
+	MUGEN_FLAGS_KIND_HIT_DEF_ATTRIBUTE,
+} DreamMugenFlagsKind;
+
+// hitdefattr masks hold the state types in the low bits and the attack class/type pairs from this shift on
+#define MUGEN_FLAGS_HIT_DEF_ATTRIBUTE_ATTACK_SHIFT 8
+#define MUGEN_FLAGS_HIT_DEF_ATTRIBUTE_HAS_ATTACKS (1u << 31)
+
+typedef struct {
+	uint8_t mType;
+	uint8_t mKind;
+	uint8_t mIsP2;
+	uint32_t mMask;
+} DreamMugenFlagsAssignment;
+
+typedef struct {
+	uint8_t mType;
+	uint8_t mIsEager;
+	DreamMugenAssignment* mCondition;
+	DreamMugenAssignment* mTrue;
+	DreamMugenAssignment* mFalse;
+} DreamMugenConditionalAssignment;
+
+#define MUGEN_ASSIGNMENT_STATIC_ENTRY_AMOUNT 4
+
+typedef struct {
+	uint32_t mGeneration;
+	void* mPlayer;
+	AssignmentReturnValue mValue;
+} DreamMugenStaticAssignmentEntry;
+
+// owned by a program, the original subtree stays untouched so it can be shared
+typedef struct {
+	uint8_t mType;
+	uint8_t mNextEntry;
+	DreamMugenStaticAssignmentEntry mEntries[MUGEN_ASSIGNMENT_STATIC_ENTRY_AMOUNT];
+	DreamMugenAssignment* mOriginal;
+} DreamMugenStaticAssignment;
+
+typedef struct {
+	uint8_t mType;
+	uint16_t mStackSize;
+	uint16_t mInstructionAmount;
+	uint16_t mStaticAmount;
+	void* mInstructions;
+	DreamMugenStaticAssignment* mStatics;
+	DreamMugenAssignment* mTree;
+} DreamMugenProgramAssignment;
+
 void setupDreamAssignmentReader(MemoryStack* tMemoryStack);
 void shutdownDreamAssignmentReader();
 void setDreamAssignmentCommandLookupID(int tID);
@@ -126,6 +225,7 @@ DreamMugenAssignment* makeDreamTrueMugenAssignment();
 DreamMugenAssignment* makeDreamFalseMugenAssignment();
 void destroyDreamFalseMugenAssignment(DreamMugenAssignment* tAssignment);
 void destroyDreamMugenAssignment(DreamMugenAssignment* tAssignment);
+const char* getDreamMugenAssignmentTypeName(uint8_t tType);
 
 DreamMugenAssignment* makeDreamNumberMugenAssignment(int tVal);
 DreamMugenAssignment * makeDreamFloatMugenAssignment(double tVal);
@@ -137,6 +237,9 @@ DreamMugenAssignment* makeDreamOrMugenAssignment(DreamMugenAssignment* a, DreamM
 DreamMugenAssignment*  parseDreamMugenAssignmentFromString(char* tText);
 DreamMugenAssignment*  parseDreamMugenAssignmentFromString(const char* tText);
 
+int serializeDreamMugenAssignment(std::vector<uint8_t>& oBuffer, DreamMugenAssignment* tAssignment);
+DreamMugenAssignment* deserializeDreamMugenAssignment(const uint8_t** tPosition, const uint8_t* tEnd);
+
 uint8_t fetchDreamAssignmentFromGroupAndReturnWhetherItExists(const char* tName, MugenDefScriptGroup* tGroup, DreamMugenAssignment** tOutput);
 void fetchDreamAssignmentFromGroupAsElement(MugenDefScriptGroupElement* tElement, DreamMugenAssignment** tOutput);
 
@@ -0,0 +1,235 @@
+#include "mugenassignmentcache.h"
+
+#include <map>
+#include <string>
+#include <vector>
+#include <string.h>
+
+#include <prism/file.h>
+#include <prism/log.h>
+#include <prism/system.h>
+
+#include "config.h"
+
+using namespace std;
+
+// expression parse cache: folded assignment trees per character, keyed by expression text and source file
+#define ASSIGNMENT_CACHE_MAGIC 0x48434144
+// bump whenever the tree serialization in mugenassignment.cpp or the entry key layout changes, new assignment types invalidate old files on their own
+#define ASSIGNMENT_CACHE_FORMAT_VERSION 2
+#define ASSIGNMENT_CACHE_VERSION ((ASSIGNMENT_CACHE_FORMAT_VERSION << 16) | MUGEN_ASSIGNMENT_TYPE_AMOUNT)
+
+typedef struct {
+	uint32_t mMagic;
+	uint32_t mVersion;
+	uint32_t mCommandSize;
+	uint32_t mEntryAmount;
+	uint64_t mCommandHash;
+} AssignmentCacheHeader;
+
+typedef struct {
+	vector<uint8_t> mData;
+	int mIsUsed;
+} AssignmentCacheEntry;
+
+static struct {
+	int mIsActive;
+	string mPath;
+	uint32_t mCommandSize;
+	uint64_t mCommandHash;
+	string mSourceKey;
+	map<string, AssignmentCacheEntry> mEntries;
+	uint32_t mLoadedAmount;
+	uint32_t mReusedAmount;
+	int mHasChanged;
+
+	uint32_t mHits;
+	uint32_t mMisses;
+} gAssignmentCacheData;
+
+static string getAssignmentCachePath(const char* tDefinitionPath) {
+	string path = tDefinitionPath;
+	size_t dot = path.find_last_of('.');
+	size_t slash = path.find_last_of("/\\");
+	if (dot != string::npos && (slash == string::npos || dot > slash)) {
+		path = path.substr(0, dot);
+	}
+	return path + ".acache";
+}
+
+static uint64_t hashAssignmentCacheData(const uint8_t* tData, size_t tSize) {
+	uint64_t hash = 14695981039346656037ull;
+	for (size_t i = 0; i < tSize; i++) {
+		hash ^= tData[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+// command lookup indices inside the trees depend on the command file, so it is part of the key of the whole cache
+static void loadAssignmentCacheCommandKey(const char* tCommandPath) {
+	gAssignmentCacheData.mCommandSize = 0;
+	gAssignmentCacheData.mCommandHash = 0;
+	if (!isFile(tCommandPath)) return;
+
+	Buffer b = fileToBuffer(tCommandPath);
+	gAssignmentCacheData.mCommandSize = b.mLength;
+	gAssignmentCacheData.mCommandHash = hashAssignmentCacheData((const uint8_t*)b.mData, b.mLength);
+	freeBuffer(b);
+}
+
+// entries are keyed by the hash of the file they were parsed from, so editing a state file drops its stale trees
+void setDreamAssignmentCacheSource(const void* tData, uint32_t tLength)
+{
+	gAssignmentCacheData.mSourceKey.clear();
+	if (!gAssignmentCacheData.mIsActive) return;
+
+	char key[40];
+	sprintf(key, "%08x%016llx ", tLength, (unsigned long long)hashAssignmentCacheData((const uint8_t*)tData, tLength));
+	gAssignmentCacheData.mSourceKey = key;
+}
+
+static int readAssignmentCacheBytes(const uint8_t** tPosition, const uint8_t* tEnd, void* oData, size_t tSize) {
+	if (size_t(tEnd - *tPosition) < tSize) return 0;
+	memcpy(oData, *tPosition, tSize);
+	*tPosition += tSize;
+	return 1;
+}
+
+static void loadAssignmentCacheFile() {
+	if (!isFile(gAssignmentCacheData.mPath.data())) return;
+
+	Buffer b = fileToBuffer(gAssignmentCacheData.mPath.data());
+	const uint8_t* position = (const uint8_t*)b.mData;
+	const uint8_t* end = position + b.mLength;
+
+	AssignmentCacheHeader header;
+	if (!readAssignmentCacheBytes(&position, end, &header, sizeof(AssignmentCacheHeader)) || header.mMagic != ASSIGNMENT_CACHE_MAGIC || header.mVersion != ASSIGNMENT_CACHE_VERSION) {
+		logWarningFormat("Ignoring invalid expression parse cache %s.", gAssignmentCacheData.mPath.data());
+		freeBuffer(b);
+		return;
+	}
+	if (header.mCommandSize != gAssignmentCacheData.mCommandSize || header.mCommandHash != gAssignmentCacheData.mCommandHash) {
+		logFormat("Command file changed, discarding expression parse cache %s.", gAssignmentCacheData.mPath.data());
+		freeBuffer(b);
+		return;
+	}
+
+	for (uint32_t i = 0; i < header.mEntryAmount; i++) {
+		uint16_t textLength;
+		uint32_t dataLength;
+		if (!readAssignmentCacheBytes(&position, end, &textLength, sizeof(uint16_t)) || size_t(end - position) < textLength) break;
+		string text((const char*)position, textLength);
+		position += textLength;
+		if (!readAssignmentCacheBytes(&position, end, &dataLength, sizeof(uint32_t)) || size_t(end - position) < dataLength) break;
+
+		AssignmentCacheEntry& e = gAssignmentCacheData.mEntries[text];
+		e.mData.assign(position, position + dataLength);
+		e.mIsUsed = 0;
+		position += dataLength;
+	}
+	gAssignmentCacheData.mLoadedAmount = uint32_t(gAssignmentCacheData.mEntries.size());
+	freeBuffer(b);
+}
+
+void setDreamAssignmentCacheCharacter(const char* tDefinitionPath, const char* tCommandPath)
+{
+	if (!isDreamExpressionCacheActive()) return;
+
+	gAssignmentCacheData.mPath = getAssignmentCachePath(tDefinitionPath);
+	gAssignmentCacheData.mEntries.clear();
+	gAssignmentCacheData.mLoadedAmount = 0;
+	gAssignmentCacheData.mReusedAmount = 0;
+	gAssignmentCacheData.mHasChanged = 0;
+	gAssignmentCacheData.mHits = 0;
+	gAssignmentCacheData.mMisses = 0;
+	loadAssignmentCacheCommandKey(tCommandPath);
+	loadAssignmentCacheFile();
+	gAssignmentCacheData.mIsActive = 1;
+}
+
+static void appendAssignmentCacheBytes(vector<uint8_t>& oBuffer, const void* tData, size_t tSize) {
+	const uint8_t* data = (const uint8_t*)tData;
+	oBuffer.insert(oBuffer.end(), data, data + tSize);
+}
+
+// only entries used by this load are written back, so stale expressions drop out of the file on their own
+static void saveAssignmentCacheFile() {
+	vector<uint8_t> file;
+	AssignmentCacheHeader header;
+	header.mMagic = ASSIGNMENT_CACHE_MAGIC;
+	header.mVersion = ASSIGNMENT_CACHE_VERSION;
+	header.mCommandSize = gAssignmentCacheData.mCommandSize;
+	header.mCommandHash = gAssignmentCacheData.mCommandHash;
+	header.mEntryAmount = 0;
+	appendAssignmentCacheBytes(file, &header, sizeof(AssignmentCacheHeader));
+
+	for (auto& entry : gAssignmentCacheData.mEntries) {
+		if (!entry.second.mIsUsed || entry.first.size() > 0xFFFF) continue;
+		uint16_t textLength = uint16_t(entry.first.size());
+		uint32_t dataLength = uint32_t(entry.second.mData.size());
+		appendAssignmentCacheBytes(file, &textLength, sizeof(uint16_t));
+		appendAssignmentCacheBytes(file, entry.first.data(), textLength);
+		appendAssignmentCacheBytes(file, &dataLength, sizeof(uint32_t));
+		appendAssignmentCacheBytes(file, entry.second.mData.data(), dataLength);
+		header.mEntryAmount++;
+	}
+	memcpy(file.data(), &header, sizeof(AssignmentCacheHeader));
+
+	bufferToFile(gAssignmentCacheData.mPath.data(), makeBuffer((void*)file.data(), file.size()));
+}
+
+void resetDreamAssignmentCacheCharacter()
+{
+	if (!gAssignmentCacheData.mIsActive) return;
+	gAssignmentCacheData.mIsActive = 0;
+	gAssignmentCacheData.mSourceKey.clear();
+
+	logFormat("Expression parse cache %s: %u hits, %u misses.", gAssignmentCacheData.mPath.data(), gAssignmentCacheData.mHits, gAssignmentCacheData.mMisses);
+	if (!isOnDreamcast() && (gAssignmentCacheData.mHasChanged || gAssignmentCacheData.mReusedAmount < gAssignmentCacheData.mLoadedAmount)) {
+		saveAssignmentCacheFile();
+	}
+	gAssignmentCacheData.mEntries.clear();
+}
+
+int isDreamAssignmentCacheActive()
+{
+	return gAssignmentCacheData.mIsActive;
+}
+
+DreamMugenAssignment* findDreamAssignmentCacheEntry(const char* tText)
+{
+	if (!gAssignmentCacheData.mIsActive || gAssignmentCacheData.mSourceKey.empty()) return NULL;
+
+	auto it = gAssignmentCacheData.mEntries.find(gAssignmentCacheData.mSourceKey + tText);
+	if (it == gAssignmentCacheData.mEntries.end()) {
+		gAssignmentCacheData.mMisses++;
+		return NULL;
+	}
+
+	AssignmentCacheEntry& e = it->second;
+	const uint8_t* position = e.mData.data();
+	DreamMugenAssignment* ret = deserializeDreamMugenAssignment(&position, position + e.mData.size());
+	if (!ret) {
+		gAssignmentCacheData.mEntries.erase(it);
+		gAssignmentCacheData.mHasChanged = 1;
+		gAssignmentCacheData.mMisses++;
+		return NULL;
+	}
+
+	if (!e.mIsUsed) gAssignmentCacheData.mReusedAmount++;
+	e.mIsUsed = 1;
+	gAssignmentCacheData.mHits++;
+	return ret;
+}
+
+void addDreamAssignmentCacheEntry(const char* tText, DreamMugenAssignment* tAssignment)
+{
+	if (!gAssignmentCacheData.mIsActive || gAssignmentCacheData.mSourceKey.empty() || !tAssignment) return;
+
+	AssignmentCacheEntry e;
+	if (!serializeDreamMugenAssignment(e.mData, tAssignment)) return;
+	e.mIsUsed = 1;
+	gAssignmentCacheData.mEntries[gAssignmentCacheData.mSourceKey + tText] = e;
+	gAssignmentCacheData.mHasChanged = 1;
+}
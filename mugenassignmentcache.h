@@ -0,0 +1,11 @@
+#pragma once
+
+#include "mugenassignment.h"
+
+void setDreamAssignmentCacheCharacter(const char* tDefinitionPath, const char* tCommandPath);
+void resetDreamAssignmentCacheCharacter();
+void setDreamAssignmentCacheSource(const void* tData, uint32_t tLength);
+
+int isDreamAssignmentCacheActive();
+DreamMugenAssignment* findDreamAssignmentCacheEntry(const char* tText);
+void addDreamAssignmentCacheEntry(const char* tText, DreamMugenAssignment* tAssignment);
@@ -3,14 +3,18 @@
 #include "mugenassignmentevaluator.h"
 
 #include <assert.h>
+#include <algorithm>
+#include <set>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 
 #define _USE_MATH_DEFINES
 #include <math.h>
 
 #define LOGGER_WARNINGS_DISABLED
 
+#include <prism/file.h>
 #include <prism/log.h>
 #include <prism/system.h>
 #include <prism/math.h>
@@ -25,59 +29,100 @@
 
 using namespace std;
 
-typedef struct {
-	AssignmentReturnType mType;
-	char mString[100];
-} AssignmentReturnString;
-
-typedef struct {
-	AssignmentReturnType mType;
-	int mNumber;
-} AssignmentReturnNumber;
-
-typedef struct {
-	AssignmentReturnType mType;
-	double mFloat;
-} AssignmentReturnFloat;
-
-typedef struct {
-	AssignmentReturnType mType;
-	int mBoolean;
-} AssignmentReturnBoolean;
-
-typedef struct {
-	AssignmentReturnType mType;
-	AssignmentReturnValue* a;
-	AssignmentReturnValue* b;
-} AssignmentReturnVector;
+#define REGULAR_STACK_SIZE 500
+#define MAXIMUM_INTERNED_STRING_AMOUNT 4096
 
-typedef struct {
-	AssignmentReturnType mType;
-} AssignmentReturnBottom;
+struct AssignmentStringHash {
+	size_t operator()(const char* tString) const {
+		size_t hash = 2166136261u;
+		while (*tString) {
+			hash = (hash ^ (uint8_t)*tString++) * 16777619u;
+		}
+		return hash;
+	}
+};
 
-#define REGULAR_STACK_SIZE 500
+struct AssignmentStringEqual {
+	bool operator()(const char* a, const char* b) const {
+		return !strcmp(a, b);
+	}
+};
 
 static struct {
-	int mStackSize;
 	AssignmentReturnValue mStack[REGULAR_STACK_SIZE];
-	std::list<AssignmentReturnValue> mEmergencyStack;
-	int mFreePointer;
+	vector<AssignmentReturnValue*> mOverflowBlocks;
+	uint32_t mFreePointer;
+
+	unordered_map<const char*, uint32_t, AssignmentStringHash, AssignmentStringEqual> mStringTable;
+	vector<char*> mStrings;
 
+	uint32_t mStaticGeneration;
 } gAssignmentEvaluator;
 
+static void clearEvaluationStrings() {
+	for (auto string : gAssignmentEvaluator.mStrings) {
+		freeMemory(string);
+	}
+	gAssignmentEvaluator.mStrings.clear();
+	gAssignmentEvaluator.mStringTable.clear();
+}
+
+static void clearEvaluationStack() {
+	for (auto block : gAssignmentEvaluator.mOverflowBlocks) {
+		freeMemory(block);
+	}
+	gAssignmentEvaluator.mOverflowBlocks.clear();
+	gAssignmentEvaluator.mFreePointer = 0;
+	clearEvaluationStrings();
+}
+
 static void initEvaluationStack() {
-	gAssignmentEvaluator.mStackSize = REGULAR_STACK_SIZE;
-	gAssignmentEvaluator.mEmergencyStack.clear();
+	clearEvaluationStack();
+	gAssignmentEvaluator.mStaticGeneration++;
+}
+
+static AssignmentReturnValue* getAssignmentReturnValueFromIndex(uint32_t tIndex) {
+	if (tIndex < REGULAR_STACK_SIZE) return &gAssignmentEvaluator.mStack[tIndex];
+
+	tIndex -= REGULAR_STACK_SIZE;
+	return &gAssignmentEvaluator.mOverflowBlocks[tIndex / REGULAR_STACK_SIZE][tIndex % REGULAR_STACK_SIZE];
 }
 
 static AssignmentReturnValue* getFreeAssignmentReturnValue() {
-	if (gAssignmentEvaluator.mFreePointer >= gAssignmentEvaluator.mStackSize) {
-		gAssignmentEvaluator.mEmergencyStack.push_back(AssignmentReturnValue());
-		return &gAssignmentEvaluator.mEmergencyStack.back();
+	uint32_t index = gAssignmentEvaluator.mFreePointer++;
+	if (index >= REGULAR_STACK_SIZE * (1 + gAssignmentEvaluator.mOverflowBlocks.size())) {
+		gAssignmentEvaluator.mOverflowBlocks.push_back((AssignmentReturnValue*)allocMemory(sizeof(AssignmentReturnValue) * REGULAR_STACK_SIZE));
 	}
-	else {
-		return &gAssignmentEvaluator.mStack[gAssignmentEvaluator.mFreePointer++];
+	return getAssignmentReturnValueFromIndex(index);
+}
+
+static uint32_t getAssignmentReturnValueIndex(AssignmentReturnValue* tValue) {
+	if (tValue >= gAssignmentEvaluator.mStack && tValue < gAssignmentEvaluator.mStack + REGULAR_STACK_SIZE) {
+		return uint32_t(tValue - gAssignmentEvaluator.mStack);
+	}
+	for (size_t i = 0; i < gAssignmentEvaluator.mOverflowBlocks.size(); i++) {
+		AssignmentReturnValue* block = gAssignmentEvaluator.mOverflowBlocks[i];
+		if (tValue >= block && tValue < block + REGULAR_STACK_SIZE) {
+			return uint32_t(REGULAR_STACK_SIZE * (i + 1) + (tValue - block));
+		}
 	}
+
+	// values living outside the stack (e.g. static nodes) are copied so vectors only reference the stack
+	AssignmentReturnValue* copy = getFreeAssignmentReturnValue();
+	*copy = *tValue;
+	return gAssignmentEvaluator.mFreePointer - 1;
+}
+
+static const char* internAssignmentReturnString(const char* tValue) {
+	auto it = gAssignmentEvaluator.mStringTable.find(tValue);
+	if (it != gAssignmentEvaluator.mStringTable.end()) return gAssignmentEvaluator.mStrings[it->second];
+
+	char* string = (char*)allocMemory(strlen(tValue) + 1);
+	strcpy(string, tValue);
+	uint32_t id = uint32_t(gAssignmentEvaluator.mStrings.size());
+	gAssignmentEvaluator.mStrings.push_back(string);
+	gAssignmentEvaluator.mStringTable[string] = id;
+	return string;
 }
 
 typedef AssignmentReturnValue*(*VariableFunction)(DreamPlayer*);
@@ -85,19 +130,128 @@ typedef AssignmentReturnValue*(*ArrayFunction)(DreamMugenAssignment**, DreamPlay
 typedef AssignmentReturnValue*(*ComparisonFunction)(AssignmentReturnValue*, DreamPlayer*, int*);
 typedef AssignmentReturnValue*(*OrdinalFunction)(AssignmentReturnValue*, DreamPlayer*, int*, int(*tCompare)(int, int));
 
+typedef struct {
+	const char* mName;
+	void* mFunc;
+} AssignmentSymbol;
+
+#define ASSIGNMENT_SYMBOL_EMPTY_SLOT 0xFFFF
+
+// perfect hash over a fixed symbol set, seeds and slots are built from the symbol arrays during setup
+typedef struct {
+	const AssignmentSymbol* mSymbols;
+	uint16_t mAmount;
+	vector<uint16_t> mSeeds;
+	uint16_t mBucketMask;
+	vector<uint16_t> mSlots;
+	uint16_t mSlotMask;
+} AssignmentSymbolTable;
+
+typedef struct {
+	AssignmentSymbolTable mVariables;
+	AssignmentSymbolTable mArrays;
+	AssignmentSymbolTable mComparisons;
+	AssignmentSymbolTable mOrdinals;
+} AssignmentSymbolTables;
+
 static struct {
-	map<string, VariableFunction> mVariables;
-	map<string, ArrayFunction> mArrays;
-	map<string, ComparisonFunction> mComparisons;
-	map<string, OrdinalFunction> mOrdinals;
+	const AssignmentSymbolTables* mSymbols;
+	map<VariableFunction, uint8_t> mMemoSymbols;
 } gVariableHandler;
 
-std::map<string, AssignmentReturnValue*(*)(DreamPlayer*)>& getActiveMugenAssignmentVariableMap() {
-	return gVariableHandler.mVariables;
+static uint32_t hashAssignmentSymbolName(const char* tName, uint32_t tSeed) {
+	uint32_t hash = 2166136261u ^ tSeed;
+	for (; *tName; tName++) {
+		hash ^= uint8_t(*tName);
+		hash *= 16777619u;
+	}
+	return hash ^ (hash >> 16);
+}
+
+static int findAssignmentSymbolIndex(const AssignmentSymbolTable* tTable, const char* tName) {
+	if (!tTable->mAmount) return -1;
+	uint16_t seed = tTable->mSeeds[hashAssignmentSymbolName(tName, 0) & tTable->mBucketMask];
+	uint16_t index = tTable->mSlots[hashAssignmentSymbolName(tName, seed) & tTable->mSlotMask];
+	if (index == ASSIGNMENT_SYMBOL_EMPTY_SLOT || strcmp(tTable->mSymbols[index].mName, tName)) return -1;
+	return index;
+}
+
+static void* findAssignmentSymbol(const AssignmentSymbolTable* tTable, const char* tName) {
+	int index = findAssignmentSymbolIndex(tTable, tName);
+	return index == -1 ? NULL : tTable->mSymbols[index].mFunc;
+}
+
+#define ASSIGNMENT_MEMO_SIZE 512
+
+typedef struct {
+	DreamPlayer* mPlayer;
+	uint32_t mGeneration;
+	uint8_t mSymbol;
+	AssignmentReturnValue mValue;
+} AssignmentMemoEntry;
+
+static struct {
+	int mIsActive;
+	int mScopeDepth;
+	uint32_t mGeneration = 1;
+	AssignmentMemoEntry mEntries[ASSIGNMENT_MEMO_SIZE];
+
+	uint32_t mHits;
+	uint32_t mMisses;
+} gAssignmentMemo;
+
+uint8_t getMugenAssignmentVariableMemoSymbol(void* tFunc) {
+	auto it = gVariableHandler.mMemoSymbols.find((VariableFunction)tFunc);
+	if (it == gVariableHandler.mMemoSymbols.end()) return 0;
+	return it->second;
+}
+
+static AssignmentReturnValue* callVariableFunction(VariableFunction tFunc, uint8_t tMemoSymbol, DreamPlayer* tPlayer) {
+	if (!tMemoSymbol || !gAssignmentMemo.mIsActive || !gAssignmentMemo.mScopeDepth) return tFunc(tPlayer);
+
+	AssignmentMemoEntry* e = &gAssignmentMemo.mEntries[((uintptr_t(tPlayer) >> 4) * 31 + tMemoSymbol) & (ASSIGNMENT_MEMO_SIZE - 1)];
+	if (e->mGeneration == gAssignmentMemo.mGeneration && e->mPlayer == tPlayer && e->mSymbol == tMemoSymbol) {
+		gAssignmentMemo.mHits++;
+		AssignmentReturnValue* ret = getFreeAssignmentReturnValue();
+		*ret = e->mValue;
+		return ret;
+	}
+
+	gAssignmentMemo.mMisses++;
+	AssignmentReturnValue* ret = tFunc(tPlayer);
+	if (ret->mType == MUGEN_ASSIGNMENT_RETURN_TYPE_VECTOR || ret->mType == MUGEN_ASSIGNMENT_RETURN_TYPE_RANGE) return ret;
+	e->mPlayer = tPlayer;
+	e->mGeneration = gAssignmentMemo.mGeneration;
+	e->mSymbol = tMemoSymbol;
+	e->mValue = *ret;
+	return ret;
+}
+
+void* findMugenAssignmentVariableFunction(const char* tName) {
+	if (!gVariableHandler.mSymbols) return NULL;
+	return findAssignmentSymbol(&gVariableHandler.mSymbols->mVariables, tName);
 }
 
-std::map<string, AssignmentReturnValue*(*)(DreamMugenAssignment**, DreamPlayer*, int*)>& getActiveMugenAssignmentArrayMap() {
-	return gVariableHandler.mArrays;
+void* findMugenAssignmentArrayFunction(const char* tName) {
+	if (!gVariableHandler.mSymbols) return NULL;
+	return findAssignmentSymbol(&gVariableHandler.mSymbols->mArrays, tName);
+}
+
+static const char* findAssignmentSymbolName(const AssignmentSymbolTable* tTable, void* tFunc) {
+	for (int i = 0; i < tTable->mAmount; i++) {
+		if (tTable->mSymbols[i].mFunc == tFunc) return tTable->mSymbols[i].mName;
+	}
+	return NULL;
+}
+
+const char* findMugenAssignmentVariableName(void* tFunc) {
+	if (!gVariableHandler.mSymbols) return NULL;
+	return findAssignmentSymbolName(&gVariableHandler.mSymbols->mVariables, tFunc);
+}
+
+const char* findMugenAssignmentArrayName(void* tFunc) {
+	if (!gVariableHandler.mSymbols) return NULL;
+	return findAssignmentSymbolName(&gVariableHandler.mSymbols->mArrays, tFunc);
 }
 
 static AssignmentReturnValue* evaluateAssignmentInternal(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer, int* oIsStatic);
@@ -116,33 +270,27 @@ static void destroyAssignmentReturn(AssignmentReturnValue* tAssignmentReturn) {
 }
 
 static char* getStringAssignmentReturnValue(AssignmentReturnValue* tAssignmentReturn) {
-	AssignmentReturnString* string = (AssignmentReturnString*)tAssignmentReturn;
-	return string->mString;
+	return (char*)tAssignmentReturn->mString;
 }
 
 static int getNumberAssignmentReturnValue(AssignmentReturnValue* tAssignmentReturn) {
-	AssignmentReturnNumber* number = (AssignmentReturnNumber*)tAssignmentReturn;
-	return number->mNumber;
+	return tAssignmentReturn->mNumber;
 }
 
 static double getFloatAssignmentReturnValue(AssignmentReturnValue* tAssignmentReturn) {
-	AssignmentReturnFloat* f = (AssignmentReturnFloat*)tAssignmentReturn;
-	return f->mFloat;
+	return tAssignmentReturn->mFloat;
 }
 
 static int getBooleanAssignmentReturnValue(AssignmentReturnValue* tAssignmentReturn) {
-	AssignmentReturnBoolean* boolean = (AssignmentReturnBoolean*)tAssignmentReturn;
-	return boolean->mBoolean;
+	return tAssignmentReturn->mBoolean;
 }
 
 static AssignmentReturnValue* getVectorAssignmentReturnFirstDependency(AssignmentReturnValue* tAssignmentReturn) {
-	AssignmentReturnVector* vector = (AssignmentReturnVector*)tAssignmentReturn;
-	return vector->a;
+	return getAssignmentReturnValueFromIndex(tAssignmentReturn->mVector.a);
 }
 
 static AssignmentReturnValue* getVectorAssignmentReturnSecondDependency(AssignmentReturnValue* tAssignmentReturn) {
-	AssignmentReturnVector* vector = (AssignmentReturnVector*)tAssignmentReturn;
-	return vector->b;
+	return getAssignmentReturnValueFromIndex(tAssignmentReturn->mVector.b);
 }
 
 static AssignmentReturnValue* makeBooleanAssignmentReturn(int tValue);
@@ -310,58 +458,59 @@ static double convertAssignmentReturnToFloat(AssignmentReturnValue* tAssignmentR
 
 static AssignmentReturnValue* makeBooleanAssignmentReturn(int tValue) {
 	AssignmentReturnValue* val = getFreeAssignmentReturnValue();
-	AssignmentReturnBoolean* ret = (AssignmentReturnBoolean*)val;
-	ret->mType = MUGEN_ASSIGNMENT_RETURN_TYPE_BOOLEAN;
-	ret->mBoolean = tValue;
+	val->mType = MUGEN_ASSIGNMENT_RETURN_TYPE_BOOLEAN;
+	val->mBoolean = tValue;
 	return val;
 }
 
 static AssignmentReturnValue* makeNumberAssignmentReturn(int tValue) {
 	AssignmentReturnValue* val = getFreeAssignmentReturnValue();
-	AssignmentReturnNumber* ret = (AssignmentReturnNumber*)val;
-	ret->mType = MUGEN_ASSIGNMENT_RETURN_TYPE_NUMBER;
-	ret->mNumber = tValue;
+	val->mType = MUGEN_ASSIGNMENT_RETURN_TYPE_NUMBER;
+	val->mNumber = tValue;
 	return val;
 }
 
 static AssignmentReturnValue* makeFloatAssignmentReturn(double tValue) {
 	AssignmentReturnValue* val = getFreeAssignmentReturnValue();
-	AssignmentReturnFloat* ret = (AssignmentReturnFloat*)val;
-	ret->mType = MUGEN_ASSIGNMENT_RETURN_TYPE_FLOAT;
-	ret->mFloat = tValue;
+	val->mType = MUGEN_ASSIGNMENT_RETURN_TYPE_FLOAT;
+	val->mFloat = tValue;
 	return val;
 }
 
 static AssignmentReturnValue* makeStringAssignmentReturn(const char* tValue) {
 	AssignmentReturnValue* val = getFreeAssignmentReturnValue();
-	AssignmentReturnString* ret = (AssignmentReturnString*)val;
-	ret->mType = MUGEN_ASSIGNMENT_RETURN_TYPE_STRING;
-	strcpy(ret->mString, tValue);
+	val->mType = MUGEN_ASSIGNMENT_RETURN_TYPE_STRING;
+	val->mString = internAssignmentReturnString(tValue);
+	return val;
+}
+
+// literals are owned by the assignment tree and outlive the evaluation strings, so they skip the intern table
+static AssignmentReturnValue* makeLiteralStringAssignmentReturn(const char* tValue) {
+	AssignmentReturnValue* val = getFreeAssignmentReturnValue();
+	val->mType = MUGEN_ASSIGNMENT_RETURN_TYPE_STRING;
+	val->mString = tValue;
 	return val;
 }
 
 static AssignmentReturnValue* makeVectorAssignmentReturn(AssignmentReturnValue* a, AssignmentReturnValue* b) {
+	uint32_t indexA = getAssignmentReturnValueIndex(a);
+	uint32_t indexB = getAssignmentReturnValueIndex(b);
 	AssignmentReturnValue* val = getFreeAssignmentReturnValue();
-	AssignmentReturnVector* ret = (AssignmentReturnVector*)val;
-	ret->mType = MUGEN_ASSIGNMENT_RETURN_TYPE_VECTOR;
-	ret->a = a;
-	ret->b = b;
+	val->mType = MUGEN_ASSIGNMENT_RETURN_TYPE_VECTOR;
+	val->mVector.a = indexA;
+	val->mVector.b = indexB;
 	return val;
 }
 
 static AssignmentReturnValue* makeRangeAssignmentReturn(AssignmentReturnValue* a, AssignmentReturnValue* b) {
-	AssignmentReturnValue* val = getFreeAssignmentReturnValue();
-	AssignmentReturnVector* ret = (AssignmentReturnVector*)val;
-	ret->mType = MUGEN_ASSIGNMENT_RETURN_TYPE_RANGE;
-	ret->a = a;
-	ret->b = b;
+	AssignmentReturnValue* val = makeVectorAssignmentReturn(a, b);
+	val->mType = MUGEN_ASSIGNMENT_RETURN_TYPE_RANGE;
 	return val;
 }
 
 static AssignmentReturnValue* makeBottomAssignmentReturn() {
 	AssignmentReturnValue* val = getFreeAssignmentReturnValue();
-	AssignmentReturnBottom* ret = (AssignmentReturnBottom*)val;
-	ret->mType = MUGEN_ASSIGNMENT_RETURN_TYPE_BOTTOM;
+	val->mType = MUGEN_ASSIGNMENT_RETURN_TYPE_BOTTOM;
 	return val;
 }
 
@@ -572,83 +721,96 @@ static AssignmentReturnValue* helperFunction(DreamMugenAssignment** tIndexAssign
 static AssignmentReturnValue* enemyNearFunction(DreamMugenAssignment** tIndexAssignment, DreamPlayer* tPlayer, int* tIsStatic);
 static AssignmentReturnValue* playerIDFunction(DreamMugenAssignment** tIndexAssignment, DreamPlayer* tPlayer, int* tIsStatic);
 
+int resolveMugenAssignmentRedirect(DreamMugenAssignment* tAssignment, uint8_t* oTarget) {
+	if (tAssignment->mType == MUGEN_ASSIGNMENT_TYPE_RAW_VARIABLE) {
+		auto rawVar = (DreamMugenRawVariableAssignment*)tAssignment;
+		if (!strcmp("p1", rawVar->mName)) *oTarget = MUGEN_REDIRECT_TARGET_P1;
+		else if (!strcmp("p2", rawVar->mName)) *oTarget = MUGEN_REDIRECT_TARGET_P2;
+		else if (!strcmp("target", rawVar->mName)) *oTarget = MUGEN_REDIRECT_TARGET_TARGET;
+		else if (!strcmp("enemy", rawVar->mName)) *oTarget = MUGEN_REDIRECT_TARGET_ENEMY;
+		else if (!strcmp("enemynear", rawVar->mName)) *oTarget = MUGEN_REDIRECT_TARGET_ENEMYNEAR;
+		else if (!strcmp("root", rawVar->mName)) *oTarget = MUGEN_REDIRECT_TARGET_ROOT;
+		else if (!strcmp("parent", rawVar->mName)) *oTarget = MUGEN_REDIRECT_TARGET_PARENT;
+		else if (!strcmp("helper", rawVar->mName)) *oTarget = MUGEN_REDIRECT_TARGET_HELPER;
+		else if (!strcmp("playerid", rawVar->mName)) *oTarget = MUGEN_REDIRECT_TARGET_PLAYERID;
+		else return 0;
+		return 1;
+	}
+	else if (tAssignment->mType == MUGEN_ASSIGNMENT_TYPE_ARRAY) {
+		auto arrayVar = (DreamMugenArrayAssignment*)tAssignment;
+		if (arrayVar->mFunc == numTargetArrayFunction) *oTarget = MUGEN_REDIRECT_TARGET_TARGET;
+		else if (arrayVar->mFunc == helperFunction) *oTarget = MUGEN_REDIRECT_TARGET_HELPER;
+		else if (arrayVar->mFunc == enemyNearFunction) *oTarget = MUGEN_REDIRECT_TARGET_ENEMYNEAR;
+		else if (arrayVar->mFunc == playerIDFunction) *oTarget = MUGEN_REDIRECT_TARGET_PLAYERID;
+		else return 0;
+		return 1;
+	}
+
+	return 0;
+}
+
 static DreamPlayer* getPlayerFromFirstVectorPartOrNullIfNonexistant(DreamMugenAssignment** a, DreamPlayer* tPlayer, int* tIsStatic) {
-	static const size_t PLAYER_TEXT_BUFFER_SIZE = 100;
-	char text[PLAYER_TEXT_BUFFER_SIZE];
+	if ((*a)->mType != MUGEN_ASSIGNMENT_TYPE_REDIRECT) return NULL;
+	auto redirect = (DreamMugenRedirectAssignment*)(*a);
+
 	int id = -1;
-	if ((*a)->mType == MUGEN_ASSIGNMENT_TYPE_RAW_VARIABLE)
-	{
-		auto rawVar = (DreamMugenRawVariableAssignment*)(*a);
-		if (strlen(text) >= PLAYER_TEXT_BUFFER_SIZE) return NULL;
-		strcpy(text, rawVar->mName);
-	}
-	else if ((*a)->mType == MUGEN_ASSIGNMENT_TYPE_ARRAY) {
-		auto arrayVar = (DreamMugenArrayAssignment*)(*a);
-		if (arrayVar->mFunc == numTargetArrayFunction) {
-			strcpy(text, "target");
-		}
-		else if (arrayVar->mFunc == helperFunction) {
-			strcpy(text, "helper");
-		}
-		else if (arrayVar->mFunc == enemyNearFunction) {
-			strcpy(text, "enemynear");
-		}
-		else if (arrayVar->mFunc == playerIDFunction) {
-			strcpy(text, "playerid");
-		}
-		else {
-			return NULL;
-		}
-		auto indexReturn = evaluateAssignmentDependency(&arrayVar->mIndex, tPlayer, tIsStatic);
+	if (redirect->mIndex) {
+		auto indexReturn = evaluateAssignmentDependency(&redirect->mIndex, tPlayer, tIsStatic);
 		id = convertAssignmentReturnToNumber(indexReturn);
 		destroyAssignmentReturn(indexReturn);
 	}
-	else {
-		return NULL;
-	}
 
-	if (!strcmp("p1", text)) {
+	DreamPlayer* ret;
+	switch (redirect->mTarget) {
+	case MUGEN_REDIRECT_TARGET_P1:
 		return getRootPlayer(0);
-	}
-	else if (!strcmp("p2", text)) {
+	case MUGEN_REDIRECT_TARGET_P2:
 		return getRootPlayer(1);
-	}
-	else if (!strcmp("target", text)) {
+	case MUGEN_REDIRECT_TARGET_TARGET:
 		return getPlayerOtherPlayer(tPlayer); // TODO: proper targeting + with id (https://dev.azure.com/captdc/DogmaRnDA/_workitems/edit/376)
-	}
-	else if (!strcmp("enemy", text)) {
-		return getPlayerOtherPlayer(tPlayer);
-	}
-	else if (!strcmp("enemynear", text)) {
+	case MUGEN_REDIRECT_TARGET_ENEMY:
+	case MUGEN_REDIRECT_TARGET_ENEMYNEAR:
 		return getPlayerOtherPlayer(tPlayer);
-	}
-	else if (!strcmp("root", text)) {
+	case MUGEN_REDIRECT_TARGET_ROOT:
 		return getPlayerRoot(tPlayer);
-	}
-	else if (!strcmp("parent", text)) {
+	case MUGEN_REDIRECT_TARGET_PARENT:
 		return getPlayerParent(tPlayer);
-	}
-	else if (!strcmp("helper", text)) {
-		DreamPlayer* ret = getPlayerHelperOrNullIfNonexistant(tPlayer, id);
+	case MUGEN_REDIRECT_TARGET_HELPER:
+		ret = getPlayerHelperOrNullIfNonexistant(tPlayer, id);
 		if (!ret) {
 			logWarningFormat("Unable to find helper with id %d. Returning NULL.", id);
 		}
 		return ret;
-	}
-	else if (!strcmp("playerid", text)) {
-		DreamPlayer* ret = getPlayerByIDOrNullIfNonexistant(tPlayer, id);
+	case MUGEN_REDIRECT_TARGET_PLAYERID:
+		ret = getPlayerByIDOrNullIfNonexistant(tPlayer, id);
 		if (!ret) {
 			logWarningFormat("Unable to find helper with id %d. Returning NULL.", id);
 		}
 		return ret;
-	}
-	else {
+	default:
 		return NULL;
 	}
 }
 
-static int isPlayerAccessVectorAssignment(DreamMugenAssignment** a, DreamPlayer* tPlayer, int* tIsStatic) {
-	return getPlayerFromFirstVectorPartOrNullIfNonexistant(a, tPlayer, tIsStatic) != NULL;
+static const char* gRedirectTargetNames[] = { "p1", "p2", "target", "enemy", "enemynear", "root", "parent", "helper", "playerid" };
+
+static AssignmentReturnValue* evaluateRedirectAssignment(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer, int* tIsStatic) {
+	auto redirect = (DreamMugenRedirectAssignment*)(*tAssignment);
+	*tIsStatic = 0;
+	if (!redirect->mIndex) {
+		return makeStringAssignmentReturn(gRedirectTargetNames[redirect->mTarget]);
+	}
+
+	switch (redirect->mTarget) {
+	case MUGEN_REDIRECT_TARGET_TARGET:
+		return numTargetArrayFunction(&redirect->mIndex, tPlayer, tIsStatic);
+	case MUGEN_REDIRECT_TARGET_HELPER:
+		return helperFunction(&redirect->mIndex, tPlayer, tIsStatic);
+	case MUGEN_REDIRECT_TARGET_ENEMYNEAR:
+		return enemyNearFunction(&redirect->mIndex, tPlayer, tIsStatic);
+	default:
+		return playerIDFunction(&redirect->mIndex, tPlayer, tIsStatic);
+	}
 }
 
 static AssignmentReturnValue* evaluateTeamModeAssignment(AssignmentReturnValue* tCommand, DreamPlayer* tPlayer, int* tIsStatic) {
@@ -836,7 +998,7 @@ static AssignmentReturnValue* evaluateHitDefAttributeAssignment(AssignmentReturn
 
 		int isFlag2OK = evaluateSingleHitDefAttributeFlag2(flag, getHitDataAttackClass(tPlayer), getHitDataAttackType(tPlayer));
 		if (isFlag2OK) {
-			return makeBottomAssignmentReturn();
+			return makeBooleanAssignmentReturn(1);
 		}
 
 		if (items == 1) hasNext = 0;
@@ -849,6 +1011,31 @@ static AssignmentReturnValue* evaluateHitDefAttributeAssignment(AssignmentReturn
 	return makeBooleanAssignmentReturn(0);
 }
 
+static int evaluateFlagsAssignmentValue(DreamMugenFlagsAssignment* tFlags, DreamPlayer* tPlayer) {
+	DreamPlayer* player = tFlags->mIsP2 ? getPlayerOtherPlayer(tPlayer) : tPlayer;
+	uint32_t mask = tFlags->mMask;
+
+	switch (tFlags->mKind) {
+	case MUGEN_FLAGS_KIND_STATE_TYPE:
+		return (mask >> getPlayerStateType(player)) & 1;
+	case MUGEN_FLAGS_KIND_MOVE_TYPE:
+		return (mask >> getPlayerStateMoveType(player)) & 1;
+	case MUGEN_FLAGS_KIND_HIT_DEF_ATTRIBUTE:
+		if (!isHitDataActive(player)) return 0;
+		if (!((mask >> getHitDataType(player)) & 1)) return 0;
+		if (!(mask & MUGEN_FLAGS_HIT_DEF_ATTRIBUTE_HAS_ATTACKS)) return 1;
+		return (mask >> (MUGEN_FLAGS_HIT_DEF_ATTRIBUTE_ATTACK_SHIFT + getHitDataAttackClass(player) * 3 + getHitDataAttackType(player))) & 1;
+	default:
+		logWarningFormat("Unrecognized flags kind %d. Default to false.", tFlags->mKind);
+		return 0;
+	}
+}
+
+static AssignmentReturnValue* evaluateFlagsAssignment(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer, int* tIsStatic) {
+	*tIsStatic = 0;
+	return makeBooleanAssignmentReturn(evaluateFlagsAssignmentValue((DreamMugenFlagsAssignment*)*tAssignment, tPlayer));
+}
+
 static AssignmentReturnValue* evaluateProjVectorAssignment(AssignmentReturnValue* tCommand, DreamPlayer* tPlayer, int tProjectileID, int(*tTimeFunc)(DreamPlayer*, int), int* tIsStatic) {
 	auto numberReturn = getVectorAssignmentReturnFirstDependency(tCommand);
 	auto operAndNumberReturn = getVectorAssignmentReturnSecondDependency(tCommand);
@@ -921,14 +1108,12 @@ static int getProjectileIDFromAssignmentName(char* tName, const char* tBaseName)
 	return atoi(idOffset);
 }
 
-static AssignmentReturnValue* evaluateProjAssignment(char* tName, const char* tBaseName, AssignmentReturnValue* tCommand, DreamPlayer* tPlayer, int(*tTimeFunc)(DreamPlayer*, int), int* tIsStatic) {
-	int projID = getProjectileIDFromAssignmentName(tName, tBaseName);
-
+static AssignmentReturnValue* evaluateProjAssignment(int tProjectileID, AssignmentReturnValue* tCommand, DreamPlayer* tPlayer, int(*tTimeFunc)(DreamPlayer*, int), int* tIsStatic) {
 	if (tCommand->mType == MUGEN_ASSIGNMENT_RETURN_TYPE_VECTOR) {
-		return evaluateProjVectorAssignment(tCommand, tPlayer, projID, tTimeFunc, tIsStatic);
+		return evaluateProjVectorAssignment(tCommand, tPlayer, tProjectileID, tTimeFunc, tIsStatic);
 	}
 	else {
-		return evaluateProjNumberAssignment(tCommand, tPlayer, projID, tTimeFunc, tIsStatic);
+		return evaluateProjNumberAssignment(tCommand, tPlayer, tProjectileID, tTimeFunc, tIsStatic);
 	}
 }
 
@@ -937,75 +1122,81 @@ static int isProjAssignment(char* tName, const char* tBaseName) {
 
 }
 
-static int tryEvaluateVariableComparison(DreamMugenRawVariableAssignment* tVariableAssignment, AssignmentReturnValue** oRet, AssignmentReturnValue* b, DreamPlayer* tPlayer, int* tIsStatic) {
+static AssignmentReturnValue* commandTriggerComparisonFunction(AssignmentReturnValue* b, DreamPlayer* tPlayer, int* tIsStatic) {
+	*tIsStatic = 0;
+	if (b->mType == MUGEN_ASSIGNMENT_RETURN_TYPE_NUMBER) {
+		return makeBooleanAssignmentReturn(isPlayerCommandActiveWithLookup(tPlayer, convertAssignmentReturnToNumber(b)));
+	}
+	else {
+		return makeBooleanAssignmentReturn(0); // only triggered when lookup failed before
+	}
+}
+
+int resolveMugenAssignmentTrigger(char* tName, int tIsOrdinal, uint8_t* oKind, void** oFunc, int* oProjectileID) {
+	*oProjectileID = 0;
+	if (tIsOrdinal) {
+		*oFunc = findAssignmentSymbol(&gVariableHandler.mSymbols->mOrdinals, tName);
+		if (!*oFunc) return 0;
+		*oKind = MUGEN_TRIGGER_KIND_ORDINAL;
+		return 1;
+	}
 
-	int hasReturn = 0;
-	if(!strcmp("command", tVariableAssignment->mName)) {
-		hasReturn = 1;
-		if (b->mType == MUGEN_ASSIGNMENT_RETURN_TYPE_NUMBER) {
-			*oRet = makeBooleanAssignmentReturn(isPlayerCommandActiveWithLookup(tPlayer, convertAssignmentReturnToNumber(b)));
-		}
-		else  if (b->mType == MUGEN_ASSIGNMENT_RETURN_TYPE_STRING) {
-			*oRet = makeBooleanAssignmentReturn(0); // only triggered when lookup failed before
-		}
-		else {
-			*oRet = makeBooleanAssignmentReturn(0);
-		}
-		*tIsStatic = 0;
+	*oKind = MUGEN_TRIGGER_KIND_COMPARISON;
+	if (!strcmp("command", tName)) {
+		*oFunc = (void*)commandTriggerComparisonFunction;
+		return 1;
 	}
-	else if (stl_string_map_contains_array(gVariableHandler.mComparisons, tVariableAssignment->mName)) {
-		ComparisonFunction func = gVariableHandler.mComparisons[tVariableAssignment->mName];
-		hasReturn = 1;
-		*oRet = func(b, tPlayer, tIsStatic);
+	else if ((*oFunc = findAssignmentSymbol(&gVariableHandler.mSymbols->mComparisons, tName))) {
+		return 1;
+	}
+
+	*oKind = MUGEN_TRIGGER_KIND_PROJECTILE;
+	if (isProjAssignment(tName, "projcontact")) {
+		*oFunc = (void*)getPlayerProjectileTimeSinceContact;
+		*oProjectileID = getProjectileIDFromAssignmentName(tName, "projcontact");
+		return 1;
 	}
-	else if (isProjAssignment(tVariableAssignment->mName, "projcontact")) {
-		hasReturn = 1;
-		*oRet = evaluateProjAssignment(tVariableAssignment->mName, "projcontact", b, tPlayer, getPlayerProjectileTimeSinceContact, tIsStatic);
+	else if (isProjAssignment(tName, "projguarded")) {
+		*oFunc = (void*)getPlayerProjectileTimeSinceGuarded;
+		*oProjectileID = getProjectileIDFromAssignmentName(tName, "projguarded");
+		return 1;
 	}
-	else if (isProjAssignment(tVariableAssignment->mName, "projguarded")) {
-		hasReturn = 1;
-		*oRet = evaluateProjAssignment(tVariableAssignment->mName, "projguarded", b, tPlayer, getPlayerProjectileTimeSinceGuarded, tIsStatic);
+	else if (isProjAssignment(tName, "projhit")) {
+		*oFunc = (void*)getPlayerProjectileTimeSinceHit;
+		*oProjectileID = getProjectileIDFromAssignmentName(tName, "projhit");
+		return 1;
 	}
-	else if (isProjAssignment(tVariableAssignment->mName, "projhit")) {
-		hasReturn = 1;
-		*oRet = evaluateProjAssignment(tVariableAssignment->mName, "projhit", b, tPlayer, getPlayerProjectileTimeSinceHit, tIsStatic);
+
+	return 0;
+}
+
+static AssignmentReturnValue* evaluateTriggerComparison(DreamMugenTriggerAssignment* tTrigger, AssignmentReturnValue* b, DreamPlayer* tPlayer, int* tIsStatic) {
+	if (tTrigger->mKind == MUGEN_TRIGGER_KIND_PROJECTILE) {
+		return evaluateProjAssignment(tTrigger->mProjectileID, b, tPlayer, (int(*)(DreamPlayer*, int))tTrigger->mFunc, tIsStatic);
 	}
 
-	return hasReturn;
+	ComparisonFunction func = (ComparisonFunction)tTrigger->mFunc;
+	return func(b, tPlayer, tIsStatic);
 }
 
 static int tryEvaluateVariableComparisonOrNegation(DreamMugenAssignment** tAssignment, AssignmentReturnValue** oRet, AssignmentReturnValue* b, DreamPlayer* tPlayer, int* tIsStatic) {
 	if ((*tAssignment)->mType == MUGEN_ASSIGNMENT_TYPE_NEGATION) {
 		DreamMugenDependOnOneAssignment* neg = (DreamMugenDependOnOneAssignment*)(*tAssignment);
-		if (neg->a->mType == MUGEN_ASSIGNMENT_TYPE_RAW_VARIABLE) {
-			DreamMugenRawVariableAssignment* negVar = (DreamMugenRawVariableAssignment*)neg->a;
-			AssignmentReturnValue* retVal = NULL;
-			if (tryEvaluateVariableComparison(negVar, &retVal, b, tPlayer, tIsStatic)) {
-				*oRet = makeBooleanAssignmentReturn(!convertAssignmentReturnToBool(retVal));
-				return 1;
-			}
-		}
-	}
-	else if ((*tAssignment)->mType == MUGEN_ASSIGNMENT_TYPE_RAW_VARIABLE) {
-		DreamMugenRawVariableAssignment* var = (DreamMugenRawVariableAssignment*)*tAssignment;
-		AssignmentReturnValue* retVal = NULL;
-		if (tryEvaluateVariableComparison(var, &retVal, b, tPlayer, tIsStatic)) {
-			*oRet = retVal;
+		if (neg->a->mType == MUGEN_ASSIGNMENT_TYPE_TRIGGER) {
+			AssignmentReturnValue* retVal = evaluateTriggerComparison((DreamMugenTriggerAssignment*)neg->a, b, tPlayer, tIsStatic);
+			*oRet = makeBooleanAssignmentReturn(!convertAssignmentReturnToBool(retVal));
 			return 1;
 		}
 	}
+	else if ((*tAssignment)->mType == MUGEN_ASSIGNMENT_TYPE_TRIGGER) {
+		*oRet = evaluateTriggerComparison((DreamMugenTriggerAssignment*)*tAssignment, b, tPlayer, tIsStatic);
+		return 1;
+	}
 
 	return 0;
 }
 
-static AssignmentReturnValue* evaluateComparisonAssignmentInternal(DreamMugenAssignment** mAssignment, AssignmentReturnValue* b, DreamPlayer* tPlayer, int* tIsStatic) {
-
-	AssignmentReturnValue* retVal = NULL;
-	if (tryEvaluateVariableComparisonOrNegation(mAssignment, &retVal, b, tPlayer, tIsStatic)) {
-		return retVal;
-	}
-
-	AssignmentReturnValue* a = evaluateAssignmentDependency(mAssignment, tPlayer, tIsStatic);
+static AssignmentReturnValue* evaluateComparisonReturns(AssignmentReturnValue* a, AssignmentReturnValue* b) {
 	if (isRangeAssignmentReturn(b)) {
 		return evaluateRangeComparisonAssignment(a, b);
 	}
@@ -1026,14 +1217,26 @@ static AssignmentReturnValue* evaluateComparisonAssignmentInternal(DreamMugenAss
 	}
 }
 
+static AssignmentReturnValue* evaluateComparisonAssignmentInternal(DreamMugenAssignment** mAssignment, AssignmentReturnValue* b, DreamPlayer* tPlayer, int* tIsStatic) {
+
+	AssignmentReturnValue* retVal = NULL;
+	if (tryEvaluateVariableComparisonOrNegation(mAssignment, &retVal, b, tPlayer, tIsStatic)) {
+		return retVal;
+	}
+
+	AssignmentReturnValue* a = evaluateAssignmentDependency(mAssignment, tPlayer, tIsStatic);
+	return evaluateComparisonReturns(a, b);
+}
+
 static AssignmentReturnValue* evaluateComparisonAssignment(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer, int* tIsStatic) {
 	DreamMugenDependOnTwoAssignment* comparisonAssignment = (DreamMugenDependOnTwoAssignment*)*tAssignment;
 
 
 	if (comparisonAssignment->a->mType == MUGEN_ASSIGNMENT_TYPE_VECTOR) {
 		DreamMugenDependOnTwoAssignment* vectorAssignment = (DreamMugenDependOnTwoAssignment*)comparisonAssignment->a;
-		if (isPlayerAccessVectorAssignment(&vectorAssignment->a, tPlayer, tIsStatic)) {
+		if (vectorAssignment->a->mType == MUGEN_ASSIGNMENT_TYPE_REDIRECT) {
 			DreamPlayer* target = getPlayerFromFirstVectorPartOrNullIfNonexistant(&vectorAssignment->a, tPlayer, tIsStatic);
+			*tIsStatic = 0;
 			if (!isPlayerTargetValid(target)) {
 				logWarning("Accessed player was NULL. Defaulting to bottom.");
 				return makeBottomAssignmentReturn(); 
@@ -1054,28 +1257,14 @@ static AssignmentReturnValue* evaluateInequalityAssignment(DreamMugenAssignment*
 	return makeBooleanAssignmentReturn(!val);
 }
 
-static int tryEvaluateVariableOrdinalInternal(DreamMugenRawVariableAssignment* tVariableAssignment, AssignmentReturnValue** oRet, AssignmentReturnValue* b, DreamPlayer* tPlayer, int* tIsStatic, int(*tCompareFunction)(int, int)) {
-
-	if (stl_string_map_contains_array(gVariableHandler.mOrdinals, tVariableAssignment->mName)) {
-		OrdinalFunction func = gVariableHandler.mOrdinals[tVariableAssignment->mName];
-		*oRet = func(b, tPlayer, tIsStatic, tCompareFunction);
-		return 1;
-	}
-
-	return 0;
-}
-
 static int tryEvaluateVariableOrdinal(DreamMugenAssignment** tAssignment, AssignmentReturnValue** oRet, AssignmentReturnValue* b, DreamPlayer* tPlayer, int* tIsStatic, int(*tCompareFunction)(int, int)) {
-	if ((*tAssignment)->mType == MUGEN_ASSIGNMENT_TYPE_RAW_VARIABLE) {
-		DreamMugenRawVariableAssignment* var = (DreamMugenRawVariableAssignment*)*tAssignment;
-		AssignmentReturnValue* retVal = NULL;
-		if (tryEvaluateVariableOrdinalInternal(var, &retVal, b, tPlayer, tIsStatic, tCompareFunction)) {
-			*oRet = retVal;
-			return 1;
-		}
-	}
+	if ((*tAssignment)->mType != MUGEN_ASSIGNMENT_TYPE_TRIGGER) return 0;
+	DreamMugenTriggerAssignment* trigger = (DreamMugenTriggerAssignment*)*tAssignment;
+	if (trigger->mKind != MUGEN_TRIGGER_KIND_ORDINAL) return 0;
 
-	return 0;
+	OrdinalFunction func = (OrdinalFunction)trigger->mFunc;
+	*oRet = func(b, tPlayer, tIsStatic, tCompareFunction);
+	return 1;
 }
 
 static int greaterFunc(int a, int b) { return a > b; }
@@ -1095,6 +1284,15 @@ static AssignmentReturnValue* evaluateGreaterFloats(AssignmentReturnValue* a, As
 }
 
 
+static AssignmentReturnValue* evaluateGreaterReturns(AssignmentReturnValue* a, AssignmentReturnValue* b) {
+	if (isFloatReturn(a) || isFloatReturn(b)) {
+		return evaluateGreaterFloats(a, b);
+	}
+	else {
+		return evaluateGreaterIntegers(a, b);
+	}
+}
+
 static AssignmentReturnValue* evaluateGreaterAssignment(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer, int* tIsStatic) {
 	DreamMugenDependOnTwoAssignment* greaterAssignment = (DreamMugenDependOnTwoAssignment*)*tAssignment;
 	AssignmentReturnValue* b = evaluateAssignmentDependency(&greaterAssignment->b, tPlayer, tIsStatic);
@@ -1106,12 +1304,7 @@ static AssignmentReturnValue* evaluateGreaterAssignment(DreamMugenAssignment** t
 
 	AssignmentReturnValue* a = evaluateAssignmentDependency(&greaterAssignment->a, tPlayer, tIsStatic);
 
-	if (isFloatReturn(a) || isFloatReturn(b)) {
-		return evaluateGreaterFloats(a, b);
-	}
-	else {
-		return evaluateGreaterIntegers(a, b);
-	}
+	return evaluateGreaterReturns(a, b);
 }
 
 static AssignmentReturnValue* evaluateGreaterOrEqualIntegers(AssignmentReturnValue* a, AssignmentReturnValue* b) {
@@ -1124,6 +1317,15 @@ static AssignmentReturnValue* evaluateGreaterOrEqualFloats(AssignmentReturnValue
 	return makeBooleanAssignmentReturn(val);
 }
 
+static AssignmentReturnValue* evaluateGreaterOrEqualReturns(AssignmentReturnValue* a, AssignmentReturnValue* b) {
+	if (isFloatReturn(a) || isFloatReturn(b)) {
+		return evaluateGreaterOrEqualFloats(a, b);
+	}
+	else {
+		return evaluateGreaterOrEqualIntegers(a, b);
+	}
+}
+
 static AssignmentReturnValue* evaluateGreaterOrEqualAssignment(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer, int* tIsStatic) {
 	DreamMugenDependOnTwoAssignment* greaterOrEqualAssignment = (DreamMugenDependOnTwoAssignment*)*tAssignment;
 	AssignmentReturnValue* b = evaluateAssignmentDependency(&greaterOrEqualAssignment->b, tPlayer, tIsStatic);
@@ -1135,12 +1337,7 @@ static AssignmentReturnValue* evaluateGreaterOrEqualAssignment(DreamMugenAssignm
 
 	AssignmentReturnValue* a = evaluateAssignmentDependency(&greaterOrEqualAssignment->a, tPlayer, tIsStatic);
 
-	if (isFloatReturn(a) || isFloatReturn(b)) {
-		return evaluateGreaterOrEqualFloats(a, b);
-	}
-	else {
-		return evaluateGreaterOrEqualIntegers(a, b);
-	}
+	return evaluateGreaterOrEqualReturns(a, b);
 }
 
 static AssignmentReturnValue* evaluateLessIntegers(AssignmentReturnValue* a, AssignmentReturnValue* b) {
@@ -1153,6 +1350,15 @@ static AssignmentReturnValue* evaluateLessFloats(AssignmentReturnValue* a, Assig
 	return makeBooleanAssignmentReturn(val);
 }
 
+static AssignmentReturnValue* evaluateLessReturns(AssignmentReturnValue* a, AssignmentReturnValue* b) {
+	if (isFloatReturn(a) || isFloatReturn(b)) {
+		return evaluateLessFloats(a, b);
+	}
+	else {
+		return evaluateLessIntegers(a, b);
+	}
+}
+
 static AssignmentReturnValue* evaluateLessAssignment(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer, int* tIsStatic) {
 	DreamMugenDependOnTwoAssignment* lessAssignment = (DreamMugenDependOnTwoAssignment*)*tAssignment;
 	AssignmentReturnValue* b = evaluateAssignmentDependency(&lessAssignment->b, tPlayer, tIsStatic);
@@ -1164,12 +1370,7 @@ static AssignmentReturnValue* evaluateLessAssignment(DreamMugenAssignment** tAss
 
 	AssignmentReturnValue* a = evaluateAssignmentDependency(&lessAssignment->a, tPlayer, tIsStatic);
 
-	if (isFloatReturn(a) || isFloatReturn(b)) {
-		return evaluateLessFloats(a, b);
-	}
-	else {
-		return evaluateLessIntegers(a, b);
-	}
+	return evaluateLessReturns(a, b);
 }
 
 static AssignmentReturnValue* evaluateLessOrEqualIntegers(AssignmentReturnValue* a, AssignmentReturnValue* b) {
@@ -1182,6 +1383,15 @@ static AssignmentReturnValue* evaluateLessOrEqualFloats(AssignmentReturnValue* a
 	return makeBooleanAssignmentReturn(val);
 }
 
+static AssignmentReturnValue* evaluateLessOrEqualReturns(AssignmentReturnValue* a, AssignmentReturnValue* b) {
+	if (isFloatReturn(a) || isFloatReturn(b)) {
+		return evaluateLessOrEqualFloats(a, b);
+	}
+	else {
+		return evaluateLessOrEqualIntegers(a, b);
+	}
+}
+
 static AssignmentReturnValue* evaluateLessOrEqualAssignment(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer, int* tIsStatic) {
 	DreamMugenDependOnTwoAssignment* lessOrEqualAssignment = (DreamMugenDependOnTwoAssignment*)*tAssignment;
 	AssignmentReturnValue* b = evaluateAssignmentDependency(&lessOrEqualAssignment->b, tPlayer, tIsStatic);
@@ -1193,12 +1403,7 @@ static AssignmentReturnValue* evaluateLessOrEqualAssignment(DreamMugenAssignment
 
 	AssignmentReturnValue* a = evaluateAssignmentDependency(&lessOrEqualAssignment->a, tPlayer, tIsStatic);
 
-	if (isFloatReturn(a) || isFloatReturn(b)) {
-		return evaluateLessOrEqualFloats(a, b);
-	}
-	else {
-		return evaluateLessOrEqualIntegers(a, b);
-	}
+	return evaluateLessOrEqualReturns(a, b);
 }
 
 static AssignmentReturnValue* evaluateModuloIntegers(AssignmentReturnValue* a, AssignmentReturnValue* b) {
@@ -1210,11 +1415,7 @@ static AssignmentReturnValue* evaluateModuloIntegers(AssignmentReturnValue* a, A
 	return makeNumberAssignmentReturn(val);
 }
 
-static AssignmentReturnValue* evaluateModuloAssignment(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer, int* tIsStatic) {
-	DreamMugenDependOnTwoAssignment* moduloAssignment = (DreamMugenDependOnTwoAssignment*)*tAssignment;
-	AssignmentReturnValue* a = evaluateAssignmentDependency(&moduloAssignment->a, tPlayer, tIsStatic);
-	AssignmentReturnValue* b = evaluateAssignmentDependency(&moduloAssignment->b, tPlayer, tIsStatic);
-
+static AssignmentReturnValue* evaluateModuloReturns(AssignmentReturnValue* a, AssignmentReturnValue* b) {
 	if (isFloatReturn(a) || isFloatReturn(b)) {
 		logWarningFormat("Unable to parse modulo of floats %f and %f. Returning bottom.", convertAssignmentReturnToFloat(a), convertAssignmentReturnToFloat(b));
 		return makeBottomAssignmentReturn();
@@ -1224,12 +1425,20 @@ static AssignmentReturnValue* evaluateModuloAssignment(DreamMugenAssignment** tA
 	}
 }
 
-static int powI(int a, int b) {
-	if (b < 0) {
-			logWarningFormat("Invalid power function %d^%d. Returning 1.", a, b);
-			return 1;
-	}
-
+static AssignmentReturnValue* evaluateModuloAssignment(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer, int* tIsStatic) {
+	DreamMugenDependOnTwoAssignment* moduloAssignment = (DreamMugenDependOnTwoAssignment*)*tAssignment;
+	AssignmentReturnValue* a = evaluateAssignmentDependency(&moduloAssignment->a, tPlayer, tIsStatic);
+	AssignmentReturnValue* b = evaluateAssignmentDependency(&moduloAssignment->b, tPlayer, tIsStatic);
+
+	return evaluateModuloReturns(a, b);
+}
+
+static int powI(int a, int b) {
+	if (b < 0) {
+			logWarningFormat("Invalid power function %d^%d. Returning 1.", a, b);
+			return 1;
+	}
+
 	if (a == 0 && b == 0) return 1;
 
 	int ret = 1;
@@ -1250,11 +1459,7 @@ static AssignmentReturnValue* evaluateExponentiationFloats(AssignmentReturnValue
 	return makeFloatAssignmentReturn(pow(val1, val2));
 }
 
-static AssignmentReturnValue* evaluateExponentiationAssignment(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer, int* tIsStatic) {
-	DreamMugenDependOnTwoAssignment* exponentiationAssignment = (DreamMugenDependOnTwoAssignment*)*tAssignment;
-	AssignmentReturnValue* a = evaluateAssignmentDependency(&exponentiationAssignment->a, tPlayer, tIsStatic);
-	AssignmentReturnValue* b = evaluateAssignmentDependency(&exponentiationAssignment->b, tPlayer, tIsStatic);
-
+static AssignmentReturnValue* evaluateExponentiationReturns(AssignmentReturnValue* a, AssignmentReturnValue* b) {
 	if (isFloatReturn(a) || isFloatReturn(b) || convertAssignmentReturnToNumber(b) < 0) {
 		return evaluateExponentiationFloats(a, b);
 	}
@@ -1263,6 +1468,14 @@ static AssignmentReturnValue* evaluateExponentiationAssignment(DreamMugenAssignm
 	}
 }
 
+static AssignmentReturnValue* evaluateExponentiationAssignment(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer, int* tIsStatic) {
+	DreamMugenDependOnTwoAssignment* exponentiationAssignment = (DreamMugenDependOnTwoAssignment*)*tAssignment;
+	AssignmentReturnValue* a = evaluateAssignmentDependency(&exponentiationAssignment->a, tPlayer, tIsStatic);
+	AssignmentReturnValue* b = evaluateAssignmentDependency(&exponentiationAssignment->b, tPlayer, tIsStatic);
+
+	return evaluateExponentiationReturns(a, b);
+}
+
 
 static AssignmentReturnValue* evaluateMultiplicationIntegers(AssignmentReturnValue* a, AssignmentReturnValue* b) {
 	int val = convertAssignmentReturnToNumber(a) * convertAssignmentReturnToNumber(b);
@@ -1274,11 +1487,7 @@ static AssignmentReturnValue* evaluateMultiplicationFloats(AssignmentReturnValue
 	return makeFloatAssignmentReturn(val);
 }
 
-static AssignmentReturnValue* evaluateMultiplicationAssignment(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer, int* tIsStatic) {
-	DreamMugenDependOnTwoAssignment* multiplicationAssignment = (DreamMugenDependOnTwoAssignment*)*tAssignment;
-	AssignmentReturnValue* a = evaluateAssignmentDependency(&multiplicationAssignment->a, tPlayer, tIsStatic);
-	AssignmentReturnValue* b = evaluateAssignmentDependency(&multiplicationAssignment->b, tPlayer, tIsStatic);
-
+static AssignmentReturnValue* evaluateMultiplicationReturns(AssignmentReturnValue* a, AssignmentReturnValue* b) {
 	if (isFloatReturn(a) || isFloatReturn(b)) {
 		return evaluateMultiplicationFloats(a, b);
 	}
@@ -1287,6 +1496,14 @@ static AssignmentReturnValue* evaluateMultiplicationAssignment(DreamMugenAssignm
 	}
 }
 
+static AssignmentReturnValue* evaluateMultiplicationAssignment(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer, int* tIsStatic) {
+	DreamMugenDependOnTwoAssignment* multiplicationAssignment = (DreamMugenDependOnTwoAssignment*)*tAssignment;
+	AssignmentReturnValue* a = evaluateAssignmentDependency(&multiplicationAssignment->a, tPlayer, tIsStatic);
+	AssignmentReturnValue* b = evaluateAssignmentDependency(&multiplicationAssignment->b, tPlayer, tIsStatic);
+
+	return evaluateMultiplicationReturns(a, b);
+}
+
 static AssignmentReturnValue* evaluateDivisionIntegers(AssignmentReturnValue* a, AssignmentReturnValue* b) {
 	int val1 = convertAssignmentReturnToNumber(a);
 	int val2 = convertAssignmentReturnToNumber(b);
@@ -1300,11 +1517,7 @@ static AssignmentReturnValue* evaluateDivisionFloats(AssignmentReturnValue* a, A
 	return makeFloatAssignmentReturn(val);
 }
 
-static AssignmentReturnValue* evaluateDivisionAssignment(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer, int* tIsStatic) {
-	DreamMugenDependOnTwoAssignment* divisionAssignment = (DreamMugenDependOnTwoAssignment*)*tAssignment;
-	AssignmentReturnValue* a = evaluateAssignmentDependency(&divisionAssignment->a, tPlayer, tIsStatic);
-	AssignmentReturnValue* b = evaluateAssignmentDependency(&divisionAssignment->b, tPlayer, tIsStatic);
-
+static AssignmentReturnValue* evaluateDivisionReturns(AssignmentReturnValue* a, AssignmentReturnValue* b) {
 	if (isFloatReturn(a) || isFloatReturn(b)) {
 		return evaluateDivisionFloats(a, b);
 	}
@@ -1313,6 +1526,14 @@ static AssignmentReturnValue* evaluateDivisionAssignment(DreamMugenAssignment**
 	}
 }
 
+static AssignmentReturnValue* evaluateDivisionAssignment(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer, int* tIsStatic) {
+	DreamMugenDependOnTwoAssignment* divisionAssignment = (DreamMugenDependOnTwoAssignment*)*tAssignment;
+	AssignmentReturnValue* a = evaluateAssignmentDependency(&divisionAssignment->a, tPlayer, tIsStatic);
+	AssignmentReturnValue* b = evaluateAssignmentDependency(&divisionAssignment->b, tPlayer, tIsStatic);
+
+	return evaluateDivisionReturns(a, b);
+}
+
 static int isSparkFileReturn(AssignmentReturnValue* a) {
 	if (a->mType != MUGEN_ASSIGNMENT_RETURN_TYPE_STRING) return 0;
 
@@ -1355,11 +1576,7 @@ static AssignmentReturnValue* evaluateAdditionFloats(AssignmentReturnValue* a, A
 	return makeFloatAssignmentReturn(val);
 }
 
-static AssignmentReturnValue* evaluateAdditionAssignment(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer, int* tIsStatic) {
-	DreamMugenDependOnTwoAssignment* additionAssignment = (DreamMugenDependOnTwoAssignment*)*tAssignment;
-	AssignmentReturnValue* a = evaluateAssignmentDependency(&additionAssignment->a, tPlayer, tIsStatic);
-	AssignmentReturnValue* b = evaluateAssignmentDependency(&additionAssignment->b, tPlayer, tIsStatic);
-
+static AssignmentReturnValue* evaluateAdditionReturns(AssignmentReturnValue* a, AssignmentReturnValue* b) {
 	if (isSparkFileReturn(a)) {
 		return evaluateAdditionSparkFile(a, b);
 	}
@@ -1371,6 +1588,14 @@ static AssignmentReturnValue* evaluateAdditionAssignment(DreamMugenAssignment**
 	}
 }
 
+static AssignmentReturnValue* evaluateAdditionAssignment(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer, int* tIsStatic) {
+	DreamMugenDependOnTwoAssignment* additionAssignment = (DreamMugenDependOnTwoAssignment*)*tAssignment;
+	AssignmentReturnValue* a = evaluateAssignmentDependency(&additionAssignment->a, tPlayer, tIsStatic);
+	AssignmentReturnValue* b = evaluateAssignmentDependency(&additionAssignment->b, tPlayer, tIsStatic);
+
+	return evaluateAdditionReturns(a, b);
+}
+
 
 static AssignmentReturnValue* evaluateSubtractionIntegers(AssignmentReturnValue* a, AssignmentReturnValue* b) {
 	int val = convertAssignmentReturnToNumber(a) - convertAssignmentReturnToNumber(b);
@@ -1382,11 +1607,7 @@ static AssignmentReturnValue* evaluateSubtractionFloats(AssignmentReturnValue* a
 	return makeFloatAssignmentReturn(val);
 }
 
-static AssignmentReturnValue* evaluateSubtractionAssignment(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer, int* tIsStatic) {
-	DreamMugenDependOnTwoAssignment* subtractionAssignment = (DreamMugenDependOnTwoAssignment*)*tAssignment;
-	AssignmentReturnValue* a = evaluateAssignmentDependency(&subtractionAssignment->a, tPlayer, tIsStatic);
-	AssignmentReturnValue* b = evaluateAssignmentDependency(&subtractionAssignment->b, tPlayer, tIsStatic);
-
+static AssignmentReturnValue* evaluateSubtractionReturns(AssignmentReturnValue* a, AssignmentReturnValue* b) {
 	if (isFloatReturn(a) || isFloatReturn(b)) {
 		return evaluateSubtractionFloats(a, b);
 	}
@@ -1395,6 +1616,14 @@ static AssignmentReturnValue* evaluateSubtractionAssignment(DreamMugenAssignment
 	}
 }
 
+static AssignmentReturnValue* evaluateSubtractionAssignment(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer, int* tIsStatic) {
+	DreamMugenDependOnTwoAssignment* subtractionAssignment = (DreamMugenDependOnTwoAssignment*)*tAssignment;
+	AssignmentReturnValue* a = evaluateAssignmentDependency(&subtractionAssignment->a, tPlayer, tIsStatic);
+	AssignmentReturnValue* b = evaluateAssignmentDependency(&subtractionAssignment->b, tPlayer, tIsStatic);
+
+	return evaluateSubtractionReturns(a, b);
+}
+
 
 static AssignmentReturnValue* evaluateOperatorArgumentAssignment(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer, int* tIsStatic) {
 	DreamMugenDependOnTwoAssignment* operatorAssignment = (DreamMugenDependOnTwoAssignment*)*tAssignment;
@@ -1433,16 +1662,17 @@ static AssignmentReturnValue* evaluateStringAssignment(DreamMugenAssignment** tA
 	(void)tIsStatic;
 	DreamMugenStringAssignment* s = (DreamMugenStringAssignment*)*tAssignment;
 
-	return makeStringAssignmentReturn(s->mValue);
+	return makeLiteralStringAssignmentReturn(s->mValue);
 }
 
 static AssignmentReturnValue* evaluatePlayerVectorAssignment(DreamMugenAssignment** tFirstValue, DreamMugenDependOnTwoAssignment* tVectorAssignment, DreamPlayer* tPlayer, int* tIsStatic) {
 	DreamPlayer* target = getPlayerFromFirstVectorPartOrNullIfNonexistant(tFirstValue, tPlayer, tIsStatic);
+	*tIsStatic = 0;
 	if (!isPlayerTargetValid(target)) {
 		logWarning("Unable to evaluate player vector assignment with NULL. Defaulting to bottom.");
 		return makeBottomAssignmentReturn(); 
 	}
-	if (tVectorAssignment->b->mType != MUGEN_ASSIGNMENT_TYPE_VARIABLE && tVectorAssignment->b->mType != MUGEN_ASSIGNMENT_TYPE_RAW_VARIABLE && tVectorAssignment->b->mType != MUGEN_ASSIGNMENT_TYPE_ARRAY) {
+	if (tVectorAssignment->b->mType != MUGEN_ASSIGNMENT_TYPE_VARIABLE && tVectorAssignment->b->mType != MUGEN_ASSIGNMENT_TYPE_RAW_VARIABLE && tVectorAssignment->b->mType != MUGEN_ASSIGNMENT_TYPE_TRIGGER && tVectorAssignment->b->mType != MUGEN_ASSIGNMENT_TYPE_ARRAY) {
 		logWarningFormat("Invalid player vector assignment type %d. Defaulting to bottom.", tVectorAssignment->b->mType);
 		return makeBottomAssignmentReturn();
 	}
@@ -1453,7 +1683,7 @@ static AssignmentReturnValue* evaluatePlayerVectorAssignment(DreamMugenAssignmen
 static AssignmentReturnValue* evaluateVectorAssignment(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer, int* tIsStatic) {
 	DreamMugenDependOnTwoAssignment* vectorAssignment = (DreamMugenDependOnTwoAssignment*)*tAssignment;
 
-	if (isPlayerAccessVectorAssignment(&vectorAssignment->a, tPlayer, tIsStatic)) {
+	if (vectorAssignment->a->mType == MUGEN_ASSIGNMENT_TYPE_REDIRECT) {
 		return evaluatePlayerVectorAssignment(&vectorAssignment->a, vectorAssignment, tPlayer, tIsStatic);
 	}
 	else {
@@ -1504,23 +1734,21 @@ static AssignmentReturnValue* hitDefAttributeComparisonFunction(AssignmentReturn
 
 static AssignmentReturnValue* animElemOrdinalFunction(AssignmentReturnValue* b, DreamPlayer* tPlayer, int* tIsStatic, int(*tCompareFunction)(int, int)) { return evaluateAnimElemOrdinalAssignment(b, tPlayer, tIsStatic, tCompareFunction); }
 
-static void setupComparisons() {
-	gVariableHandler.mComparisons.clear();
-
-	gVariableHandler.mComparisons["command"] = commandComparisonFunction;
-	gVariableHandler.mComparisons["statetype"] = stateTypeComparisonFunction;
-	gVariableHandler.mComparisons["p2statetype"] = p2StateTypeComparisonFunction;
-	gVariableHandler.mComparisons["movetype"] = moveTypeComparisonFunction;
-	gVariableHandler.mComparisons["p2movetype"] = p2MoveTypeComparisonFunction;
-	gVariableHandler.mComparisons["animelem"] = animElemComparisonFunction;
-	gVariableHandler.mComparisons["timemod"] = timeModComparisonFunction;
-	gVariableHandler.mComparisons["teammode"] = teamModeComparisonFunction;
-	gVariableHandler.mComparisons["hitdefattr"] = hitDefAttributeComparisonFunction;
-
-	gVariableHandler.mOrdinals.clear();
-	gVariableHandler.mOrdinals["animelem"] = animElemOrdinalFunction;
+static const AssignmentSymbol gFightComparisonSymbols[] = {
+	{ "command", (void*)commandComparisonFunction },
+	{ "statetype", (void*)stateTypeComparisonFunction },
+	{ "p2statetype", (void*)p2StateTypeComparisonFunction },
+	{ "movetype", (void*)moveTypeComparisonFunction },
+	{ "p2movetype", (void*)p2MoveTypeComparisonFunction },
+	{ "animelem", (void*)animElemComparisonFunction },
+	{ "timemod", (void*)timeModComparisonFunction },
+	{ "teammode", (void*)teamModeComparisonFunction },
+	{ "hitdefattr", (void*)hitDefAttributeComparisonFunction },
+};
 
-}
+static const AssignmentSymbol gFightOrdinalSymbols[] = {
+	{ "animelem", (void*)animElemOrdinalFunction },
+};
 
 static const char* getPlatformString() {
 	if (isOnDreamcast()) return "dreamcast";
@@ -1746,244 +1974,264 @@ static AssignmentReturnValue* getHitVarIsBoundFunction(DreamPlayer* tPlayer) {	r
 static AssignmentReturnValue* getHitVarChainIDFunction(DreamPlayer* tPlayer) {	return makeNumberAssignmentReturn(getActiveHitDataChainID(tPlayer));}
 static AssignmentReturnValue* getHitVarGuardedFunction(DreamPlayer* tPlayer) {	return makeBooleanAssignmentReturn(getLastPlayerHitGuarded(tPlayer));}
 
-static void setupVariableAssignments() {
-	gVariableHandler.mVariables.clear();
-	gVariableHandler.mVariables["ailevel"] = aiLevelFunction;
-	gVariableHandler.mVariables["alive"] = aliveFunction;
-	gVariableHandler.mVariables["anim"] = animFunction;
-	gVariableHandler.mVariables["animtime"] = animTimeFunction;
-	gVariableHandler.mVariables["authorname"] = authorNameFunction;
-
-	gVariableHandler.mVariables["backedge"] = backEdgeFunction;
-	gVariableHandler.mVariables["backedgebodydist"] = backEdgeBodyDistFunction;
-	gVariableHandler.mVariables["backedgedist"] = backEdgeDistFunction;
-	gVariableHandler.mVariables["bottomedge"] = bottomEdgeFunction;
-
-	gVariableHandler.mVariables["camerapos x"] = cameraPosXFunction;
-	gVariableHandler.mVariables["camerapos y"] = cameraPosYFunction;
-	gVariableHandler.mVariables["camerazoom"] = cameraZoomFunction;
-	gVariableHandler.mVariables["canrecover"] = canRecoverFunction;
-	gVariableHandler.mVariables["ctrl"] = ctrlFunction;
-
-	gVariableHandler.mVariables["drawgame"] = drawGameFunction;
-
-	gVariableHandler.mVariables["e"] = eFunction;
-
-	gVariableHandler.mVariables["facing"] = facingFunction;
-	gVariableHandler.mVariables["frontedge"] = frontEdgeFunction;
-	gVariableHandler.mVariables["frontedgebodydist"] = frontEdgeBodyDistFunction;
-	gVariableHandler.mVariables["frontedgedist"] = frontEdgeDistFunction;
-
-	gVariableHandler.mVariables["gameheight"] = gameHeightFunction;
-	gVariableHandler.mVariables["gametime"] = gameTimeFunction;
-	gVariableHandler.mVariables["gamewidth"] = gameWidthFunction;
-
-	gVariableHandler.mVariables["hitcount"] = hitCountFunction;
-	gVariableHandler.mVariables["hitfall"] = hitFallFunction;
-	gVariableHandler.mVariables["hitover"] = hitOverFunction;
-	gVariableHandler.mVariables["hitpausetime"] = hitPauseTimeFunction;
-	gVariableHandler.mVariables["hitshakeover"] = hitShakeOverFunction;
-	gVariableHandler.mVariables["hitvel x"] = hitVelXFunction;
-	gVariableHandler.mVariables["hitvel y"] = hitVelYFunction;
-
-	gVariableHandler.mVariables["id"] = idFunction;
-	gVariableHandler.mVariables["inguarddist"] = inGuardDistFunction;
-	gVariableHandler.mVariables["ishelper"] = isHelperFunction;
-	gVariableHandler.mVariables["ishometeam"] = isHomeTeamFunction;
-
-	gVariableHandler.mVariables["leftedge"] = leftEdgeFunction;
-	gVariableHandler.mVariables["life"] = lifeFunction;
-	gVariableHandler.mVariables["lifemax"] = lifeMaxFunction;
-	gVariableHandler.mVariables["lose"] = loseFunction;
-
-	gVariableHandler.mVariables["matchno"] = matchNoFunction;
-	gVariableHandler.mVariables["matchover"] = matchOverFunction;
-	gVariableHandler.mVariables["movecontact"] = moveContactFunction;
-	gVariableHandler.mVariables["moveguarded"] = moveGuardedFunction;
-	gVariableHandler.mVariables["movehit"] = moveHitFunction;
-	gVariableHandler.mVariables["movereversed"] = moveReversedFunction;
-
-	gVariableHandler.mVariables["name"] = nameFunction;
-	gVariableHandler.mVariables["numenemy"] = numEnemyFunction;
-	gVariableHandler.mVariables["numexplod"] = numExplodFunction;
-	gVariableHandler.mVariables["numhelper"] = numHelperFunction;
-	gVariableHandler.mVariables["numpartner"] = numPartnerFunction;
-	gVariableHandler.mVariables["numproj"] = numProjFunction;
-	gVariableHandler.mVariables["numtarget"] = numTargetFunction;
-
-	gVariableHandler.mVariables["p1name"] = p1NameFunction;
-	gVariableHandler.mVariables["p2bodydist x"] = p2BodyDistFunctionX;
-	gVariableHandler.mVariables["p2bodydist y"] = p2BodyDistFunctionY;
-	gVariableHandler.mVariables["p2dist x"] = p2DistFunctionX;
-	gVariableHandler.mVariables["p2dist y"] = p2DistFunctionY;
-	gVariableHandler.mVariables["p2life"] = p2LifeFunction;
-	gVariableHandler.mVariables["p2name"] = p2NameFunction;
-	gVariableHandler.mVariables["p2stateno"] = p2StateNoFunction;
-	gVariableHandler.mVariables["p3name"] = p3NameFunction;
-	gVariableHandler.mVariables["p4name"] = p4NameFunction;
-	gVariableHandler.mVariables["palno"] = palNoFunction;
-	gVariableHandler.mVariables["parentdist x"] = parentDistXFunction;
-	gVariableHandler.mVariables["parentdist y"] = parentDistYFunction;
-	gVariableHandler.mVariables["pi"] = piFunction;
-	gVariableHandler.mVariables["pos x"] = posXFunction;
-	gVariableHandler.mVariables["pos y"] = posYFunction;
-	gVariableHandler.mVariables["power"] = powerFunction;
-	gVariableHandler.mVariables["powermax"] = powerMaxFunction;
-	gVariableHandler.mVariables["prevstateno"] = prevStateNoFunction;
-
-	gVariableHandler.mVariables["random"] = randomFunction;
-	gVariableHandler.mVariables["rightedge"] = rightEdgeFunction;
-	gVariableHandler.mVariables["rootdist x"] = rootDistXFunction;
-	gVariableHandler.mVariables["rootdist y"] = rootDistYFunction;
-	gVariableHandler.mVariables["roundno"] = roundNoFunction;
-	gVariableHandler.mVariables["roundsexisted"] = roundsExistedFunction;
-	gVariableHandler.mVariables["roundstate"] = roundStateFunction;
-
-	gVariableHandler.mVariables["screenpos x"] = screenPosXFunction;
-	gVariableHandler.mVariables["screenpos y"] = screenPosYFunction;
-	gVariableHandler.mVariables["screenheight"] = screenHeightFunction;
-	gVariableHandler.mVariables["screenwidth"] = screenWidthFunction;
-	gVariableHandler.mVariables["stateno"] = stateNoFunction;
-	gVariableHandler.mVariables["statetime"] = timeFunction;
-
-	gVariableHandler.mVariables["teamside"] = teamSideFunction;
-	gVariableHandler.mVariables["tickspersecond"] = ticksPerSecondFunction;
-	gVariableHandler.mVariables["time"] = timeFunction;
-	gVariableHandler.mVariables["topedge"] = topEdgeFunction;
-
-	gVariableHandler.mVariables["uniquehitcount"] = uniqHitCountFunction;
-
-	gVariableHandler.mVariables["vel x"] = velXFunction;
-	gVariableHandler.mVariables["vel y"] = velYFunction;
-
-	gVariableHandler.mVariables["win"] = winFunction;
+static const AssignmentSymbol gFightVariableSymbols[] = {
+	{ "ailevel", (void*)aiLevelFunction },
+	{ "alive", (void*)aliveFunction },
+	{ "anim", (void*)animFunction },
+	{ "animtime", (void*)animTimeFunction },
+	{ "authorname", (void*)authorNameFunction },
+
+	{ "backedge", (void*)backEdgeFunction },
+	{ "backedgebodydist", (void*)backEdgeBodyDistFunction },
+	{ "backedgedist", (void*)backEdgeDistFunction },
+	{ "bottomedge", (void*)bottomEdgeFunction },
+
+	{ "camerapos x", (void*)cameraPosXFunction },
+	{ "camerapos y", (void*)cameraPosYFunction },
+	{ "camerazoom", (void*)cameraZoomFunction },
+	{ "canrecover", (void*)canRecoverFunction },
+	{ "ctrl", (void*)ctrlFunction },
+
+	{ "drawgame", (void*)drawGameFunction },
+
+	{ "e", (void*)eFunction },
+
+	{ "facing", (void*)facingFunction },
+	{ "frontedge", (void*)frontEdgeFunction },
+	{ "frontedgebodydist", (void*)frontEdgeBodyDistFunction },
+	{ "frontedgedist", (void*)frontEdgeDistFunction },
+
+	{ "gameheight", (void*)gameHeightFunction },
+	{ "gametime", (void*)gameTimeFunction },
+	{ "gamewidth", (void*)gameWidthFunction },
+
+	{ "hitcount", (void*)hitCountFunction },
+	{ "hitfall", (void*)hitFallFunction },
+	{ "hitover", (void*)hitOverFunction },
+	{ "hitpausetime", (void*)hitPauseTimeFunction },
+	{ "hitshakeover", (void*)hitShakeOverFunction },
+	{ "hitvel x", (void*)hitVelXFunction },
+	{ "hitvel y", (void*)hitVelYFunction },
+
+	{ "id", (void*)idFunction },
+	{ "inguarddist", (void*)inGuardDistFunction },
+	{ "ishelper", (void*)isHelperFunction },
+	{ "ishometeam", (void*)isHomeTeamFunction },
+
+	{ "leftedge", (void*)leftEdgeFunction },
+	{ "life", (void*)lifeFunction },
+	{ "lifemax", (void*)lifeMaxFunction },
+	{ "lose", (void*)loseFunction },
+
+	{ "matchno", (void*)matchNoFunction },
+	{ "matchover", (void*)matchOverFunction },
+	{ "movecontact", (void*)moveContactFunction },
+	{ "moveguarded", (void*)moveGuardedFunction },
+	{ "movehit", (void*)moveHitFunction },
+	{ "movereversed", (void*)moveReversedFunction },
+
+	{ "name", (void*)nameFunction },
+	{ "numenemy", (void*)numEnemyFunction },
+	{ "numexplod", (void*)numExplodFunction },
+	{ "numhelper", (void*)numHelperFunction },
+	{ "numpartner", (void*)numPartnerFunction },
+	{ "numproj", (void*)numProjFunction },
+	{ "numtarget", (void*)numTargetFunction },
+
+	{ "p1name", (void*)p1NameFunction },
+	{ "p2bodydist x", (void*)p2BodyDistFunctionX },
+	{ "p2bodydist y", (void*)p2BodyDistFunctionY },
+	{ "p2dist x", (void*)p2DistFunctionX },
+	{ "p2dist y", (void*)p2DistFunctionY },
+	{ "p2life", (void*)p2LifeFunction },
+	{ "p2name", (void*)p2NameFunction },
+	{ "p2stateno", (void*)p2StateNoFunction },
+	{ "p3name", (void*)p3NameFunction },
+	{ "p4name", (void*)p4NameFunction },
+	{ "palno", (void*)palNoFunction },
+	{ "parentdist x", (void*)parentDistXFunction },
+	{ "parentdist y", (void*)parentDistYFunction },
+	{ "pi", (void*)piFunction },
+	{ "pos x", (void*)posXFunction },
+	{ "pos y", (void*)posYFunction },
+	{ "power", (void*)powerFunction },
+	{ "powermax", (void*)powerMaxFunction },
+	{ "prevstateno", (void*)prevStateNoFunction },
+
+	{ "random", (void*)randomFunction },
+	{ "rightedge", (void*)rightEdgeFunction },
+	{ "rootdist x", (void*)rootDistXFunction },
+	{ "rootdist y", (void*)rootDistYFunction },
+	{ "roundno", (void*)roundNoFunction },
+	{ "roundsexisted", (void*)roundsExistedFunction },
+	{ "roundstate", (void*)roundStateFunction },
+
+	{ "screenpos x", (void*)screenPosXFunction },
+	{ "screenpos y", (void*)screenPosYFunction },
+	{ "screenheight", (void*)screenHeightFunction },
+	{ "screenwidth", (void*)screenWidthFunction },
+	{ "stateno", (void*)stateNoFunction },
+	{ "statetime", (void*)timeFunction },
+
+	{ "teamside", (void*)teamSideFunction },
+	{ "tickspersecond", (void*)ticksPerSecondFunction },
+	{ "time", (void*)timeFunction },
+	{ "topedge", (void*)topEdgeFunction },
+
+	{ "uniquehitcount", (void*)uniqHitCountFunction },
+
+	{ "vel x", (void*)velXFunction },
+	{ "vel y", (void*)velYFunction },
+
+	{ "win", (void*)winFunction },
 
 	// Dolmexica vars
-	gVariableHandler.mVariables["inputallowed"] = inputAllowedFunction;
-	gVariableHandler.mVariables["platform"] = platformFunction;
+	{ "inputallowed", (void*)inputAllowedFunction },
+	{ "platform", (void*)platformFunction },
 
 	// Arrays // TODO: consider remove (https://dev.azure.com/captdc/DogmaRnDA/_workitems/edit/390)
-	gVariableHandler.mVariables["const(data.life)"] = dataLifeFunction;
-	gVariableHandler.mVariables["const(data.power)"] = dataPowerFunction;
-	gVariableHandler.mVariables["const(data.attack)"] = dataAttackFunction;
-	gVariableHandler.mVariables["const(data.defence)"] = dataDefenceFunction;
-	gVariableHandler.mVariables["const(data.fall.defence_mul)"] = dataFallDefenceMultiplierFunction;
-	gVariableHandler.mVariables["const(data.liedown.time)"] = dataLiedownTimeFunction;
-	gVariableHandler.mVariables["const(data.airjuggle)"] = dataAirjuggleFunction;
-	gVariableHandler.mVariables["const(data.sparkno)"] = dataSparkNoFunction;
-	gVariableHandler.mVariables["const(data.guard.sparkno)"] = dataGuardSparkNoFunction;
-	gVariableHandler.mVariables["const(data.ko.echo)"] = dataKOEchoFunction;
-	gVariableHandler.mVariables["const(data.intpersistindex)"] = dataIntPersistIndexFunction;
-	gVariableHandler.mVariables["const(data.floatpersistindex)"] = dataFloatPersistIndexFunction;
-
-	gVariableHandler.mVariables["const(size.xscale)"] = sizeXScaleFunction;
-	gVariableHandler.mVariables["const(size.yscale)"] = sizeYScaleFunction;
-	gVariableHandler.mVariables["const(size.ground.back)"] = sizeGroundBackFunction;
-	gVariableHandler.mVariables["const(size.ground.front)"] = sizeGroundFrontFunction;
-	gVariableHandler.mVariables["const(size.air.back)"] = sizeAirBackFunction;
-	gVariableHandler.mVariables["const(size.air.front)"] = sizeAirFrontFunction;
-	gVariableHandler.mVariables["const(size.height)"] = sizeHeightFunction;
-	gVariableHandler.mVariables["const(size.attack.dist)"] = sizeAttackDistFunction;
-	gVariableHandler.mVariables["const(size.proj.attack.dist)"] = sizeProjAttackDistFunction;
-	gVariableHandler.mVariables["const(size.proj.doscale)"] = sizeProjDoScaleFunction;
-	gVariableHandler.mVariables["const(size.head.pos.x)"] = sizeHeadPosXFunction;
-	gVariableHandler.mVariables["const(size.head.pos.y)"] = sizeHeadPosYFunction;
-	gVariableHandler.mVariables["const(size.mid.pos.x)"] = sizeMidPosXFunction;
-	gVariableHandler.mVariables["const(size.mid.pos.y)"] = sizeMidPosYFunction;
-	gVariableHandler.mVariables["const(size.shadowoffset)"] = sizeShadowOffsetFunction;
-	gVariableHandler.mVariables["const(size.draw.offset.x)"] = sizeDrawOffsetXFunction;
-	gVariableHandler.mVariables["const(size.draw.offset.y)"] = sizeDrawOffsetYFunction;
-
-	gVariableHandler.mVariables["const(velocity.walk.fwd.x)"] = velocityWalkFwdXFunction;
-	gVariableHandler.mVariables["const(velocity.walk.back.x)"] = velocityWalkBackXFunction;
-	gVariableHandler.mVariables["const(velocity.run.fwd.x)"] = velocityRunFwdXFunction;
-	gVariableHandler.mVariables["const(velocity.run.fwd.y)"] = velocityRunFwdYFunction;
-	gVariableHandler.mVariables["const(velocity.run.back.x)"] = velocityRunBackXFunction;
-	gVariableHandler.mVariables["const(velocity.run.back.y)"] = velocityRunBackYFunction;
-	gVariableHandler.mVariables["const(velocity.jump.y)"] = velocityJumpYFunction;
-	gVariableHandler.mVariables["const(velocity.jump.neu.x)"] = velocityJumpNeuXFunction;
-	gVariableHandler.mVariables["const(velocity.jump.back.x)"] = velocityJumpBackXFunction;
-	gVariableHandler.mVariables["const(velocity.jump.fwd.x)"] = velocityJumpFwdXFunction;
-	gVariableHandler.mVariables["const(velocity.runjump.y)"] = velocityJumpYFunction;
-	gVariableHandler.mVariables["const(velocity.runjump.back.x)"] = velocityRunJumpBackXFunction;
-	gVariableHandler.mVariables["const(velocity.runjump.fwd.x)"] = velocityRunJumpFwdXFunction;
-	gVariableHandler.mVariables["const(velocity.airjump.y)"] = velocityAirJumpYFunction;
-	gVariableHandler.mVariables["const(velocity.airjump.neu.x)"] = velocityAirJumpNeuXFunction;
-	gVariableHandler.mVariables["const(velocity.airjump.back.x)"] = velocityAirJumpBackXFunction;
-	gVariableHandler.mVariables["const(velocity.airjump.fwd.x)"] = velocityAirJumpFwdXFunction;
-	gVariableHandler.mVariables["const(velocity.air.gethit.groundrecover.x)"] = velocityAirGetHitGroundRecoverXFunction;
-	gVariableHandler.mVariables["const(velocity.air.gethit.groundrecover.y)"] = velocityAirGetHitGroundRecoverYFunction;
-	gVariableHandler.mVariables["const(velocity.air.gethit.airrecover.mul.x)"] = velocityAirGetHitAirRecoverMulXFunction;
-	gVariableHandler.mVariables["const(velocity.air.gethit.airrecover.mul.y)"] = velocityAirGetHitAirRecoverMulYFunction;
-	gVariableHandler.mVariables["const(velocity.air.gethit.airrecover.add.x)"] = velocityAirGetHitAirRecoverAddXFunction;
-	gVariableHandler.mVariables["const(velocity.air.gethit.airrecover.add.y)"] = velocityAirGetHitAirRecoverAddYFunction;
-	gVariableHandler.mVariables["const(velocity.air.gethit.airrecover.back)"] = velocityAirGetHitAirRecoverBackFunction;
-	gVariableHandler.mVariables["const(velocity.air.gethit.airrecover.fwd)"] = velocityAirGetHitAirRecoverFwdFunction;
-	gVariableHandler.mVariables["const(velocity.air.gethit.airrecover.up)"] = velocityAirGetHitAirRecoverUpFunction;
-	gVariableHandler.mVariables["const(velocity.air.gethit.airrecover.down)"] = velocityAirGetHitAirRecoverDownFunction;
-
-	gVariableHandler.mVariables["const(movement.airjump.num)"] = movementAirJumpNumFunction;
-	gVariableHandler.mVariables["const(movement.airjump.height)"] = movementAirJumpHeightFunction;
-	gVariableHandler.mVariables["const(movement.yaccel)"] = movementYAccelFunction;
-	gVariableHandler.mVariables["const(movement.stand.friction)"] = movementStandFrictionFunction;
-	gVariableHandler.mVariables["const(movement.crouch.friction)"] = movementCrouchFrictionFunction;
-	gVariableHandler.mVariables["const(movement.stand.friction.threshold)"] = movementStandFrictionThresholdFunction;
-	gVariableHandler.mVariables["const(movement.crouch.friction.threshold)"] = movementCrouchFrictionThresholdFunction;
-	gVariableHandler.mVariables["const(movement.jump.changeanim.threshold)"] = movementJumpChangeAnimThresholdFunction;
-	gVariableHandler.mVariables["const(movement.air.gethit.groundlevel)"] = movementAirGetHitGroundLevelFunction;
-	gVariableHandler.mVariables["const(movement.air.gethit.groundrecover.ground.threshold)"] = movementAirGetHitGroundRecoverGroundThresholdFunction;
-	gVariableHandler.mVariables["const(movement.air.gethit.groundrecover.groundlevel)"] = movementAirGetHitGroundRecoverGroundLevelFunction;
-	gVariableHandler.mVariables["const(movement.air.gethit.airrecover.threshold)"] = movementAirGetHitAirRecoverThresholdFunction;
-	gVariableHandler.mVariables["const(movement.air.gethit.airrecover.yaccel)"] = movementAirGetHitAirRecoverYAccelFunction;
-	gVariableHandler.mVariables["const(movement.air.gethit.trip.groundlevel)"] = movementAirGetHitTripGroundLevelFunction;
-	gVariableHandler.mVariables["const(movement.down.bounce.offset.x)"] = movementDownBounceOffsetXFunction;
-	gVariableHandler.mVariables["const(movement.down.bounce.offset.y)"] = movementDownBounceOffsetYFunction;
-	gVariableHandler.mVariables["const(movement.down.bounce.yaccel)"] = movementDownBounceYAccelFunction;
-	gVariableHandler.mVariables["const(movement.down.bounce.groundlevel)"] = movementDownBounceGroundLevelFunction;
-	gVariableHandler.mVariables["const(movement.down.friction.threshold)"] = movementDownFrictionThresholdFunction;
-
-	gVariableHandler.mVariables["gethitvar(xveladd)"] = getHitVarXVelAddFunction;
-	gVariableHandler.mVariables["gethitvar(yveladd)"] = getHitVarYVelAddFunction;
-	gVariableHandler.mVariables["gethitvar(type)"] = getHitVarTypeFunction;
-	gVariableHandler.mVariables["gethitvar(animtype)"] = getHitVarAnimtypeFunction;
-	gVariableHandler.mVariables["gethitvar(airtype)"] = getHitVarAirtypeFunction;
-	gVariableHandler.mVariables["gethitvar(groundtype)"] = getHitVarGroundtypeFunction;
-	gVariableHandler.mVariables["gethitvar(damage)"] = getHitVarDamageFunction;
-	gVariableHandler.mVariables["gethitvar(hitcount)"] = getHitVarHitcountFunction;
-	gVariableHandler.mVariables["gethitvar(fallcount)"] = getHitVarFallcountFunction;
-	gVariableHandler.mVariables["gethitvar(hitshaketime)"] = getHitVarHitshaketimeFunction;
-	gVariableHandler.mVariables["gethitvar(hittime)"] = getHitVarHitTimeFunction;
-	gVariableHandler.mVariables["gethitvar(slidetime)"] = getHitVarSlidetimeFunction;
-	gVariableHandler.mVariables["gethitvar(ctrltime)"] = getHitVarCtrltimeFunction;
-	gVariableHandler.mVariables["gethitvar(recovertime)"] = getHitVarRecoverTimeFunction;
-	gVariableHandler.mVariables["gethitvar(xoff)"] = getHitVarXOffFunction;
-	gVariableHandler.mVariables["gethitvar(yoff)"] = getHitVarYOffFunction;
-	gVariableHandler.mVariables["gethitvar(xvel)"] = getHitVarXvelFunction;
-	gVariableHandler.mVariables["gethitvar(yvel)"] = getHitVarYvelFunction;
-	gVariableHandler.mVariables["gethitvar(yaccel)"] = getHitVarYaccelFunction;
-	gVariableHandler.mVariables["gethitvar(chainid)"] = getHitVarChainIDFunction;
-	gVariableHandler.mVariables["gethitvar(guarded)"] = getHitVarGuardedFunction;
-	gVariableHandler.mVariables["gethitvar(isbound)"] = getHitVarIsBoundFunction;
-	gVariableHandler.mVariables["gethitvar(fall)"] = getHitVarFallFunction;
-	gVariableHandler.mVariables["gethitvar(fall.damage)"] = getHitVarFallDamageFunction;
-	gVariableHandler.mVariables["gethitvar(fall.xvel)"] = getHitVarFallXVelFunction;
-	gVariableHandler.mVariables["gethitvar(fall.yvel)"] = getHitVarFallYVelFunction;
-	gVariableHandler.mVariables["gethitvar(fall.recover)"] = getHitVarFallRecoverFunction;
-	gVariableHandler.mVariables["gethitvar(fall.recovertime)"] = getHitVarFallRecoverTimeFunction;
-	gVariableHandler.mVariables["gethitvar(fall.kill)"] = getHitVarFallKillFunction;
-	gVariableHandler.mVariables["gethitvar(fall.envshake.time)"] = getHitVarFallEnvshakeTimeFunction;
-	gVariableHandler.mVariables["gethitvar(fall.envshake.freq)"] = getHitVarFallEnvshakeFreqFunction;
-	gVariableHandler.mVariables["gethitvar(fall.envshake.ampl)"] = getHitVarFallEnvshakeAmplFunction;
-	gVariableHandler.mVariables["gethitvar(fall.envshake.phase)"] = getHitVarFallEnvshakePhaseFunction;
-}
-
-static void setupArrayAssignments();
+	{ "const(data.life)", (void*)dataLifeFunction },
+	{ "const(data.power)", (void*)dataPowerFunction },
+	{ "const(data.attack)", (void*)dataAttackFunction },
+	{ "const(data.defence)", (void*)dataDefenceFunction },
+	{ "const(data.fall.defence_mul)", (void*)dataFallDefenceMultiplierFunction },
+	{ "const(data.liedown.time)", (void*)dataLiedownTimeFunction },
+	{ "const(data.airjuggle)", (void*)dataAirjuggleFunction },
+	{ "const(data.sparkno)", (void*)dataSparkNoFunction },
+	{ "const(data.guard.sparkno)", (void*)dataGuardSparkNoFunction },
+	{ "const(data.ko.echo)", (void*)dataKOEchoFunction },
+	{ "const(data.intpersistindex)", (void*)dataIntPersistIndexFunction },
+	{ "const(data.floatpersistindex)", (void*)dataFloatPersistIndexFunction },
+
+	{ "const(size.xscale)", (void*)sizeXScaleFunction },
+	{ "const(size.yscale)", (void*)sizeYScaleFunction },
+	{ "const(size.ground.back)", (void*)sizeGroundBackFunction },
+	{ "const(size.ground.front)", (void*)sizeGroundFrontFunction },
+	{ "const(size.air.back)", (void*)sizeAirBackFunction },
+	{ "const(size.air.front)", (void*)sizeAirFrontFunction },
+	{ "const(size.height)", (void*)sizeHeightFunction },
+	{ "const(size.attack.dist)", (void*)sizeAttackDistFunction },
+	{ "const(size.proj.attack.dist)", (void*)sizeProjAttackDistFunction },
+	{ "const(size.proj.doscale)", (void*)sizeProjDoScaleFunction },
+	{ "const(size.head.pos.x)", (void*)sizeHeadPosXFunction },
+	{ "const(size.head.pos.y)", (void*)sizeHeadPosYFunction },
+	{ "const(size.mid.pos.x)", (void*)sizeMidPosXFunction },
+	{ "const(size.mid.pos.y)", (void*)sizeMidPosYFunction },
+	{ "const(size.shadowoffset)", (void*)sizeShadowOffsetFunction },
+	{ "const(size.draw.offset.x)", (void*)sizeDrawOffsetXFunction },
+	{ "const(size.draw.offset.y)", (void*)sizeDrawOffsetYFunction },
+
+	{ "const(velocity.walk.fwd.x)", (void*)velocityWalkFwdXFunction },
+	{ "const(velocity.walk.back.x)", (void*)velocityWalkBackXFunction },
+	{ "const(velocity.run.fwd.x)", (void*)velocityRunFwdXFunction },
+	{ "const(velocity.run.fwd.y)", (void*)velocityRunFwdYFunction },
+	{ "const(velocity.run.back.x)", (void*)velocityRunBackXFunction },
+	{ "const(velocity.run.back.y)", (void*)velocityRunBackYFunction },
+	{ "const(velocity.jump.y)", (void*)velocityJumpYFunction },
+	{ "const(velocity.jump.neu.x)", (void*)velocityJumpNeuXFunction },
+	{ "const(velocity.jump.back.x)", (void*)velocityJumpBackXFunction },
+	{ "const(velocity.jump.fwd.x)", (void*)velocityJumpFwdXFunction },
+	{ "const(velocity.runjump.y)", (void*)velocityJumpYFunction },
+	{ "const(velocity.runjump.back.x)", (void*)velocityRunJumpBackXFunction },
+	{ "const(velocity.runjump.fwd.x)", (void*)velocityRunJumpFwdXFunction },
+	{ "const(velocity.airjump.y)", (void*)velocityAirJumpYFunction },
+	{ "const(velocity.airjump.neu.x)", (void*)velocityAirJumpNeuXFunction },
+	{ "const(velocity.airjump.back.x)", (void*)velocityAirJumpBackXFunction },
+	{ "const(velocity.airjump.fwd.x)", (void*)velocityAirJumpFwdXFunction },
+	{ "const(velocity.air.gethit.groundrecover.x)", (void*)velocityAirGetHitGroundRecoverXFunction },
+	{ "const(velocity.air.gethit.groundrecover.y)", (void*)velocityAirGetHitGroundRecoverYFunction },
+	{ "const(velocity.air.gethit.airrecover.mul.x)", (void*)velocityAirGetHitAirRecoverMulXFunction },
+	{ "const(velocity.air.gethit.airrecover.mul.y)", (void*)velocityAirGetHitAirRecoverMulYFunction },
+	{ "const(velocity.air.gethit.airrecover.add.x)", (void*)velocityAirGetHitAirRecoverAddXFunction },
+	{ "const(velocity.air.gethit.airrecover.add.y)", (void*)velocityAirGetHitAirRecoverAddYFunction },
+	{ "const(velocity.air.gethit.airrecover.back)", (void*)velocityAirGetHitAirRecoverBackFunction },
+	{ "const(velocity.air.gethit.airrecover.fwd)", (void*)velocityAirGetHitAirRecoverFwdFunction },
+	{ "const(velocity.air.gethit.airrecover.up)", (void*)velocityAirGetHitAirRecoverUpFunction },
+	{ "const(velocity.air.gethit.airrecover.down)", (void*)velocityAirGetHitAirRecoverDownFunction },
+
+	{ "const(movement.airjump.num)", (void*)movementAirJumpNumFunction },
+	{ "const(movement.airjump.height)", (void*)movementAirJumpHeightFunction },
+	{ "const(movement.yaccel)", (void*)movementYAccelFunction },
+	{ "const(movement.stand.friction)", (void*)movementStandFrictionFunction },
+	{ "const(movement.crouch.friction)", (void*)movementCrouchFrictionFunction },
+	{ "const(movement.stand.friction.threshold)", (void*)movementStandFrictionThresholdFunction },
+	{ "const(movement.crouch.friction.threshold)", (void*)movementCrouchFrictionThresholdFunction },
+	{ "const(movement.jump.changeanim.threshold)", (void*)movementJumpChangeAnimThresholdFunction },
+	{ "const(movement.air.gethit.groundlevel)", (void*)movementAirGetHitGroundLevelFunction },
+	{ "const(movement.air.gethit.groundrecover.ground.threshold)", (void*)movementAirGetHitGroundRecoverGroundThresholdFunction },
+	{ "const(movement.air.gethit.groundrecover.groundlevel)", (void*)movementAirGetHitGroundRecoverGroundLevelFunction },
+	{ "const(movement.air.gethit.airrecover.threshold)", (void*)movementAirGetHitAirRecoverThresholdFunction },
+	{ "const(movement.air.gethit.airrecover.yaccel)", (void*)movementAirGetHitAirRecoverYAccelFunction },
+	{ "const(movement.air.gethit.trip.groundlevel)", (void*)movementAirGetHitTripGroundLevelFunction },
+	{ "const(movement.down.bounce.offset.x)", (void*)movementDownBounceOffsetXFunction },
+	{ "const(movement.down.bounce.offset.y)", (void*)movementDownBounceOffsetYFunction },
+	{ "const(movement.down.bounce.yaccel)", (void*)movementDownBounceYAccelFunction },
+	{ "const(movement.down.bounce.groundlevel)", (void*)movementDownBounceGroundLevelFunction },
+	{ "const(movement.down.friction.threshold)", (void*)movementDownFrictionThresholdFunction },
+
+	{ "gethitvar(xveladd)", (void*)getHitVarXVelAddFunction },
+	{ "gethitvar(yveladd)", (void*)getHitVarYVelAddFunction },
+	{ "gethitvar(type)", (void*)getHitVarTypeFunction },
+	{ "gethitvar(animtype)", (void*)getHitVarAnimtypeFunction },
+	{ "gethitvar(airtype)", (void*)getHitVarAirtypeFunction },
+	{ "gethitvar(groundtype)", (void*)getHitVarGroundtypeFunction },
+	{ "gethitvar(damage)", (void*)getHitVarDamageFunction },
+	{ "gethitvar(hitcount)", (void*)getHitVarHitcountFunction },
+	{ "gethitvar(fallcount)", (void*)getHitVarFallcountFunction },
+	{ "gethitvar(hitshaketime)", (void*)getHitVarHitshaketimeFunction },
+	{ "gethitvar(hittime)", (void*)getHitVarHitTimeFunction },
+	{ "gethitvar(slidetime)", (void*)getHitVarSlidetimeFunction },
+	{ "gethitvar(ctrltime)", (void*)getHitVarCtrltimeFunction },
+	{ "gethitvar(recovertime)", (void*)getHitVarRecoverTimeFunction },
+	{ "gethitvar(xoff)", (void*)getHitVarXOffFunction },
+	{ "gethitvar(yoff)", (void*)getHitVarYOffFunction },
+	{ "gethitvar(xvel)", (void*)getHitVarXvelFunction },
+	{ "gethitvar(yvel)", (void*)getHitVarYvelFunction },
+	{ "gethitvar(yaccel)", (void*)getHitVarYaccelFunction },
+	{ "gethitvar(chainid)", (void*)getHitVarChainIDFunction },
+	{ "gethitvar(guarded)", (void*)getHitVarGuardedFunction },
+	{ "gethitvar(isbound)", (void*)getHitVarIsBoundFunction },
+	{ "gethitvar(fall)", (void*)getHitVarFallFunction },
+	{ "gethitvar(fall.damage)", (void*)getHitVarFallDamageFunction },
+	{ "gethitvar(fall.xvel)", (void*)getHitVarFallXVelFunction },
+	{ "gethitvar(fall.yvel)", (void*)getHitVarFallYVelFunction },
+	{ "gethitvar(fall.recover)", (void*)getHitVarFallRecoverFunction },
+	{ "gethitvar(fall.recovertime)", (void*)getHitVarFallRecoverTimeFunction },
+	{ "gethitvar(fall.kill)", (void*)getHitVarFallKillFunction },
+	{ "gethitvar(fall.envshake.time)", (void*)getHitVarFallEnvshakeTimeFunction },
+	{ "gethitvar(fall.envshake.freq)", (void*)getHitVarFallEnvshakeFreqFunction },
+	{ "gethitvar(fall.envshake.ampl)", (void*)getHitVarFallEnvshakeAmplFunction },
+	{ "gethitvar(fall.envshake.phase)", (void*)getHitVarFallEnvshakePhaseFunction },
+};
+
+// only reads of player state that controllers are the sole writers of within a state machine step
+static const char* gMemoizedVariableNames[] = {
+	"alive", "anim", "animtime", "backedgebodydist", "backedgedist", "canrecover", "ctrl", "facing", "frontedgebodydist", "frontedgedist",
+	"hitcount", "hitfall", "hitover", "hitpausetime", "hitshakeover", "hitvel x", "hitvel y", "inguarddist", "life", "movecontact", "moveguarded",
+	"movehit", "movereversed", "numenemy", "numexplod", "numhelper", "numproj", "numtarget", "p2bodydist x", "p2bodydist y", "p2dist x", "p2dist y",
+	"p2life", "p2stateno", "pos x", "pos y", "power", "prevstateno", "screenpos x", "screenpos y", "stateno", "statetime", "time", "uniquehitcount",
+	"vel x", "vel y",
+};
+
+static void setupVariableMemoSymbols() {
+	gVariableHandler.mMemoSymbols.clear();
+	int amount = sizeof(gMemoizedVariableNames) / sizeof(gMemoizedVariableNames[0]);
+	for (int i = 0; i < amount; i++) {
+		VariableFunction func = (VariableFunction)findAssignmentSymbol(&gVariableHandler.mSymbols->mVariables, gMemoizedVariableNames[i]);
+		if (stl_map_contains(gVariableHandler.mMemoSymbols, func)) continue;
+		gVariableHandler.mMemoSymbols[func] = uint8_t(gVariableHandler.mMemoSymbols.size() + 1);
+	}
+}
+
+static void setupFightAssignmentSymbols();
+
+static void setupAssignmentProgramTypes();
 
 void setupDreamAssignmentEvaluator() {
 	initEvaluationStack();
-	setupVariableAssignments();
-	setupArrayAssignments();
-	setupComparisons();
+	setupAssignmentProgramTypes();
+	setupFightAssignmentSymbols();
+	setupVariableMemoSymbols();
 }
 
 static int isIsInOtherFileVariable(char* tName) {
@@ -2009,9 +2257,8 @@ static AssignmentReturnValue* makeExternalFileAssignmentReturn(char tIdentifierC
 static AssignmentReturnValue* evaluateVariableAssignment(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer, int* tIsStatic) {
 	DreamMugenVariableAssignment* variable = (DreamMugenVariableAssignment*)*tAssignment;
 	*tIsStatic = 0;
-	AssignmentReturnValue*(*func)(DreamPlayer*) = (AssignmentReturnValue*(*)(DreamPlayer*))variable->mFunc;
 
-	return func(tPlayer);
+	return callVariableFunction((VariableFunction)variable->mFunc, variable->mMemoSymbol, tPlayer);
 }
 
 static AssignmentReturnValue* evaluateRawVariableAssignment(DreamMugenAssignment** tAssignment, DreamPlayer* /*tPlayer*/, int* tIsStatic) {
@@ -2022,7 +2269,11 @@ static AssignmentReturnValue* evaluateRawVariableAssignment(DreamMugenAssignment
 		return makeExternalFileAssignmentReturn(variable->mName[0], variable->mName + 1);
 	}
 
-	return makeStringAssignmentReturn(variable->mName);
+	return makeLiteralStringAssignmentReturn(variable->mName);
+}
+
+static AssignmentReturnValue* evaluateTriggerAssignment(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer, int* tIsStatic) {
+	return evaluateRawVariableAssignment(tAssignment, tPlayer, tIsStatic);
 }
 
 static AssignmentReturnValue* evaluateVarArrayAssignment(AssignmentReturnValue* tIndex, DreamPlayer* tPlayer, int* tIsStatic) {
@@ -2425,59 +2676,57 @@ static AssignmentReturnValue* projContactArrayFunction(DreamMugenAssignment** tI
 static AssignmentReturnValue* projGuardedArrayFunction(DreamMugenAssignment** tIndexAssignment, DreamPlayer* tPlayer, int* tIsStatic) { return evaluateProjectileGuardedArrayAssignment(evaluateAssignmentDependency(tIndexAssignment, tPlayer, tIsStatic), tPlayer, tIsStatic); }
 
 
-static void setupArrayAssignments() {
-	gVariableHandler.mArrays.clear();
-
-	gVariableHandler.mArrays["var"] = varFunction;
-	gVariableHandler.mArrays["sysvar"] = sysVarFunction;
-	gVariableHandler.mArrays["globalvar"] = globalVarFunction;
-	gVariableHandler.mArrays["fvar"] = fVarFunction;
-	gVariableHandler.mArrays["sysfvar"] = sysFVarFunction;
-	gVariableHandler.mArrays["globalfvar"] = globalFVarFunction;
-	gVariableHandler.mArrays["stagevar"] = stageVarFunction;
-	gVariableHandler.mArrays["abs"] = absFunction;
-	gVariableHandler.mArrays["exp"] = expFunction;
-	gVariableHandler.mArrays["ln"] = lnFunction;
-	gVariableHandler.mArrays["log"] = logFunction;
-	gVariableHandler.mArrays["cos"] = cosFunction;
-	gVariableHandler.mArrays["acos"] = acosFunction;
-	gVariableHandler.mArrays["sin"] = sinFunction;
-	gVariableHandler.mArrays["asin"] = asinFunction;
-	gVariableHandler.mArrays["tan"] = tanFunction;
-	gVariableHandler.mArrays["atan"] = atanFunction;
-	gVariableHandler.mArrays["floor"] = floorFunction;
-	gVariableHandler.mArrays["ceil"] = ceilFunction;
-	gVariableHandler.mArrays["animelemtime"] = animElemTimeFunction;
-	gVariableHandler.mArrays["animelemno"] = animElemNoFunction;
-	gVariableHandler.mArrays["ifelse"] = ifElseFunction;
-	gVariableHandler.mArrays["sifelse"] = ifElseFunction;
-	gVariableHandler.mArrays["cond"] = condFunction;
-	gVariableHandler.mArrays["animexist"] = animExistFunction;
-	gVariableHandler.mArrays["selfanimexist"] = selfAnimExistFunction;
-	gVariableHandler.mArrays["const240p"] = const240pFunction;
-	gVariableHandler.mArrays["const480p"] = const480pFunction;
-	gVariableHandler.mArrays["const720p"] = const720pFunction;
-	gVariableHandler.mArrays["f"] = externalFileFunctionF;
-	gVariableHandler.mArrays["s"] = externalFileFunctionS;
-	gVariableHandler.mArrays["numtarget"] = numTargetArrayFunction;
-	gVariableHandler.mArrays["target"] = numTargetArrayFunction;
-	gVariableHandler.mArrays["enemy"] = numTargetArrayFunction;
-	gVariableHandler.mArrays["numhelper"] = numHelperArrayFunction;
-	gVariableHandler.mArrays["numexplod"] = numExplodArrayFunction;
-	gVariableHandler.mArrays["ishelper"] = isHelperArrayFunction;
-	gVariableHandler.mArrays["helper"] = helperFunction;
-	gVariableHandler.mArrays["enemynear"] = enemyNearFunction;
-	gVariableHandler.mArrays["playerid"] = playerIDFunction;
-	gVariableHandler.mArrays["playeridexist"] = playerIDExistFunction;
-	gVariableHandler.mArrays["numprojid"] = numProjIDFunction;
-	gVariableHandler.mArrays["projcanceltime"] = projCancelTimeFunction;
-	gVariableHandler.mArrays["projcontacttime"] = projContactTimeFunction;
-	gVariableHandler.mArrays["projguardedtime"] = projGuardedTimeFunction;
-	gVariableHandler.mArrays["projhittime"] = projHitTimeFunction;
-	gVariableHandler.mArrays["projhit"] = projHitArrayFunction;
-	gVariableHandler.mArrays["projcontact"] = projContactArrayFunction;
-	gVariableHandler.mArrays["projguarded"] = projGuardedArrayFunction;
-}
+static const AssignmentSymbol gFightArraySymbols[] = {
+	{ "var", (void*)varFunction },
+	{ "sysvar", (void*)sysVarFunction },
+	{ "globalvar", (void*)globalVarFunction },
+	{ "fvar", (void*)fVarFunction },
+	{ "sysfvar", (void*)sysFVarFunction },
+	{ "globalfvar", (void*)globalFVarFunction },
+	{ "stagevar", (void*)stageVarFunction },
+	{ "abs", (void*)absFunction },
+	{ "exp", (void*)expFunction },
+	{ "ln", (void*)lnFunction },
+	{ "log", (void*)logFunction },
+	{ "cos", (void*)cosFunction },
+	{ "acos", (void*)acosFunction },
+	{ "sin", (void*)sinFunction },
+	{ "asin", (void*)asinFunction },
+	{ "tan", (void*)tanFunction },
+	{ "atan", (void*)atanFunction },
+	{ "floor", (void*)floorFunction },
+	{ "ceil", (void*)ceilFunction },
+	{ "animelemtime", (void*)animElemTimeFunction },
+	{ "animelemno", (void*)animElemNoFunction },
+	{ "ifelse", (void*)ifElseFunction },
+	{ "sifelse", (void*)ifElseFunction },
+	{ "cond", (void*)condFunction },
+	{ "animexist", (void*)animExistFunction },
+	{ "selfanimexist", (void*)selfAnimExistFunction },
+	{ "const240p", (void*)const240pFunction },
+	{ "const480p", (void*)const480pFunction },
+	{ "const720p", (void*)const720pFunction },
+	{ "f", (void*)externalFileFunctionF },
+	{ "s", (void*)externalFileFunctionS },
+	{ "numtarget", (void*)numTargetArrayFunction },
+	{ "target", (void*)numTargetArrayFunction },
+	{ "enemy", (void*)numTargetArrayFunction },
+	{ "numhelper", (void*)numHelperArrayFunction },
+	{ "numexplod", (void*)numExplodArrayFunction },
+	{ "ishelper", (void*)isHelperArrayFunction },
+	{ "helper", (void*)helperFunction },
+	{ "enemynear", (void*)enemyNearFunction },
+	{ "playerid", (void*)playerIDFunction },
+	{ "playeridexist", (void*)playerIDExistFunction },
+	{ "numprojid", (void*)numProjIDFunction },
+	{ "projcanceltime", (void*)projCancelTimeFunction },
+	{ "projcontacttime", (void*)projContactTimeFunction },
+	{ "projguardedtime", (void*)projGuardedTimeFunction },
+	{ "projhittime", (void*)projHitTimeFunction },
+	{ "projhit", (void*)projHitArrayFunction },
+	{ "projcontact", (void*)projContactArrayFunction },
+	{ "projguarded", (void*)projGuardedArrayFunction },
+};
 
 
 static AssignmentReturnValue* evaluateArrayAssignment(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer, int* tIsStatic) {
@@ -2487,6 +2736,20 @@ static AssignmentReturnValue* evaluateArrayAssignment(DreamMugenAssignment** tAs
 	return func(&arrays->mIndex, tPlayer, tIsStatic);
 }
 
+static AssignmentReturnValue* evaluateConditionalAssignment(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer, int* tIsStatic) {
+	DreamMugenConditionalAssignment* conditional = (DreamMugenConditionalAssignment*)*tAssignment;
+
+	AssignmentReturnValue* condition = evaluateAssignmentDependency(&conditional->mCondition, tPlayer, tIsStatic);
+	int isTrue = convertAssignmentReturnToBool(condition);
+	if (!conditional->mIsEager) {
+		return evaluateAssignmentDependency(isTrue ? &conditional->mTrue : &conditional->mFalse, tPlayer, tIsStatic);
+	}
+
+	AssignmentReturnValue* yes = evaluateAssignmentDependency(&conditional->mTrue, tPlayer, tIsStatic);
+	AssignmentReturnValue* no = evaluateAssignmentDependency(&conditional->mFalse, tPlayer, tIsStatic);
+	return isTrue ? yes : no;
+}
+
 static AssignmentReturnValue* evaluateUnaryMinusAssignment(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer, int* tIsStatic) {
 	DreamMugenDependOnOneAssignment* min = (DreamMugenDependOnOneAssignment*)*tAssignment;
 
@@ -2508,146 +2771,1108 @@ static AssignmentReturnValue* evaluateNegationAssignment(DreamMugenAssignment**
 	return makeBooleanAssignmentReturn(!val);
 }
 
-typedef struct {
-	uint8_t mType;
-	AssignmentReturnValue* mValue;
-} DreamMugenStaticAssignment;
-
 int gPruneAmount;
 
-static DreamMugenAssignment* makeStaticDreamMugenAssignment(AssignmentReturnValue* tValue) {
-	DreamMugenStaticAssignment* e = (DreamMugenStaticAssignment*)allocMemory(sizeof(DreamMugenStaticAssignment));
-	e->mType = MUGEN_ASSIGNMENT_TYPE_STATIC;
-	e->mValue = tValue;
+static AssignmentReturnValue* evaluateStaticAssignment(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer, int* tIsStatic) {
+	DreamMugenStaticAssignment* stat = (DreamMugenStaticAssignment*)*tAssignment;
+	for (int i = 0; i < MUGEN_ASSIGNMENT_STATIC_ENTRY_AMOUNT; i++) {
+		DreamMugenStaticAssignmentEntry* entry = &stat->mEntries[i];
+		if (entry->mGeneration == gAssignmentEvaluator.mStaticGeneration && entry->mPlayer == tPlayer) {
+			return &entry->mValue;
+		}
+	}
+
+	AssignmentReturnValue* ret = evaluateAssignmentInternal(&stat->mOriginal, tPlayer, tIsStatic);
+	if (!*tIsStatic || ret->mType == MUGEN_ASSIGNMENT_RETURN_TYPE_VECTOR || ret->mType == MUGEN_ASSIGNMENT_RETURN_TYPE_RANGE) return ret;
 
+	DreamMugenStaticAssignmentEntry* entry = &stat->mEntries[stat->mNextEntry];
+	stat->mNextEntry = (stat->mNextEntry + 1) % MUGEN_ASSIGNMENT_STATIC_ENTRY_AMOUNT;
+	entry->mValue = *ret;
+	entry->mGeneration = gAssignmentEvaluator.mStaticGeneration;
+	entry->mPlayer = tPlayer;
 	gPruneAmount++;
-	return (DreamMugenAssignment*)e;
+	return &entry->mValue;
+}
+
+enum DreamMugenAssignmentOpcode : uint8_t {
+	MUGEN_ASSIGNMENT_OPCODE_PUSH_NUMBER,
+	MUGEN_ASSIGNMENT_OPCODE_PUSH_FLOAT,
+	MUGEN_ASSIGNMENT_OPCODE_PUSH_BOOLEAN,
+	MUGEN_ASSIGNMENT_OPCODE_CALL_VARIABLE,
+	MUGEN_ASSIGNMENT_OPCODE_EVALUATE_TREE,
+	MUGEN_ASSIGNMENT_OPCODE_EVALUATE_STATIC,
+	MUGEN_ASSIGNMENT_OPCODE_LOAD_VAR,
+	MUGEN_ASSIGNMENT_OPCODE_LOAD_FVAR,
+	MUGEN_ASSIGNMENT_OPCODE_LOAD_SYSVAR,
+	MUGEN_ASSIGNMENT_OPCODE_LOAD_SYSFVAR,
+	MUGEN_ASSIGNMENT_OPCODE_JUMP_IF_FALSE_OR_POP,
+	MUGEN_ASSIGNMENT_OPCODE_JUMP_IF_TRUE_OR_POP,
+	MUGEN_ASSIGNMENT_OPCODE_JUMP_IF_FALSE,
+	MUGEN_ASSIGNMENT_OPCODE_JUMP,
+	MUGEN_ASSIGNMENT_OPCODE_TO_BOOLEAN,
+	MUGEN_ASSIGNMENT_OPCODE_NEGATION,
+	MUGEN_ASSIGNMENT_OPCODE_UNARY_MINUS,
+	MUGEN_ASSIGNMENT_OPCODE_BITWISE_AND,
+	MUGEN_ASSIGNMENT_OPCODE_BITWISE_OR,
+	MUGEN_ASSIGNMENT_OPCODE_ADDITION,
+	MUGEN_ASSIGNMENT_OPCODE_SUBTRACTION,
+	MUGEN_ASSIGNMENT_OPCODE_MULTIPLICATION,
+	MUGEN_ASSIGNMENT_OPCODE_DIVISION,
+	MUGEN_ASSIGNMENT_OPCODE_MODULO,
+	MUGEN_ASSIGNMENT_OPCODE_EXPONENTIATION,
+	MUGEN_ASSIGNMENT_OPCODE_ADDITION_INTEGERS,
+	MUGEN_ASSIGNMENT_OPCODE_SUBTRACTION_INTEGERS,
+	MUGEN_ASSIGNMENT_OPCODE_MULTIPLICATION_INTEGERS,
+	MUGEN_ASSIGNMENT_OPCODE_ADDITION_FLOATS,
+	MUGEN_ASSIGNMENT_OPCODE_SUBTRACTION_FLOATS,
+	MUGEN_ASSIGNMENT_OPCODE_MULTIPLICATION_FLOATS,
+	MUGEN_ASSIGNMENT_OPCODE_DIVISION_FLOATS,
+	MUGEN_ASSIGNMENT_OPCODE_COMPARISON,
+	MUGEN_ASSIGNMENT_OPCODE_INEQUALITY,
+	MUGEN_ASSIGNMENT_OPCODE_LESS,
+	MUGEN_ASSIGNMENT_OPCODE_LESS_OR_EQUAL,
+	MUGEN_ASSIGNMENT_OPCODE_GREATER,
+	MUGEN_ASSIGNMENT_OPCODE_GREATER_OR_EQUAL,
+	MUGEN_ASSIGNMENT_OPCODE_COMPARISON_INTEGERS,
+	MUGEN_ASSIGNMENT_OPCODE_INEQUALITY_INTEGERS,
+	MUGEN_ASSIGNMENT_OPCODE_LESS_INTEGERS,
+	MUGEN_ASSIGNMENT_OPCODE_LESS_OR_EQUAL_INTEGERS,
+	MUGEN_ASSIGNMENT_OPCODE_GREATER_INTEGERS,
+	MUGEN_ASSIGNMENT_OPCODE_GREATER_OR_EQUAL_INTEGERS,
+	MUGEN_ASSIGNMENT_OPCODE_COMPARISON_FLOATS,
+	MUGEN_ASSIGNMENT_OPCODE_INEQUALITY_FLOATS,
+	MUGEN_ASSIGNMENT_OPCODE_LESS_FLOATS,
+	MUGEN_ASSIGNMENT_OPCODE_LESS_OR_EQUAL_FLOATS,
+	MUGEN_ASSIGNMENT_OPCODE_GREATER_FLOATS,
+	MUGEN_ASSIGNMENT_OPCODE_GREATER_OR_EQUAL_FLOATS,
+	MUGEN_ASSIGNMENT_OPCODE_COMPARISON_INTEGER_CONSTANT,
+	MUGEN_ASSIGNMENT_OPCODE_INEQUALITY_INTEGER_CONSTANT,
+	MUGEN_ASSIGNMENT_OPCODE_LESS_INTEGER_CONSTANT,
+	MUGEN_ASSIGNMENT_OPCODE_LESS_OR_EQUAL_INTEGER_CONSTANT,
+	MUGEN_ASSIGNMENT_OPCODE_GREATER_INTEGER_CONSTANT,
+	MUGEN_ASSIGNMENT_OPCODE_GREATER_OR_EQUAL_INTEGER_CONSTANT,
+	MUGEN_ASSIGNMENT_OPCODE_COMPARISON_FLOAT_CONSTANT,
+	MUGEN_ASSIGNMENT_OPCODE_INEQUALITY_FLOAT_CONSTANT,
+	MUGEN_ASSIGNMENT_OPCODE_LESS_FLOAT_CONSTANT,
+	MUGEN_ASSIGNMENT_OPCODE_LESS_OR_EQUAL_FLOAT_CONSTANT,
+	MUGEN_ASSIGNMENT_OPCODE_GREATER_FLOAT_CONSTANT,
+	MUGEN_ASSIGNMENT_OPCODE_GREATER_OR_EQUAL_FLOAT_CONSTANT,
+	MUGEN_ASSIGNMENT_OPCODE_TEST_FLAGS,
+	MUGEN_ASSIGNMENT_OPCODE_RETURN,
+};
+
+typedef struct {
+	uint8_t mOpcode;
+	uint8_t mMemoSymbol;
+	union {
+		int mNumber;
+		double mFloat;
+		void* mPointer;
+	};
+} AssignmentInstruction;
+
+typedef struct {
+	AssignmentReturnType mType;
+	union {
+		int mNumber;
+		double mFloat;
+		AssignmentReturnValue* mReturn;
+	};
+} AssignmentProgramValue;
+
+typedef enum {
+	ASSIGNMENT_PROGRAM_TYPE_UNKNOWN,
+	ASSIGNMENT_PROGRAM_TYPE_INTEGER,
+	ASSIGNMENT_PROGRAM_TYPE_FLOAT,
+	ASSIGNMENT_PROGRAM_TYPE_STRING,
+} AssignmentProgramType;
+
+typedef struct {
+	vector<AssignmentInstruction> mInstructions;
+	vector<DreamMugenAssignment**> mStatics;
+	int mDepth;
+	int mMaximumDepth;
+} AssignmentProgramBuilder;
+
+#define ASSIGNMENT_PROGRAM_STACK_SIZE 32
+
+static void addAssignmentProgramInstruction(AssignmentProgramBuilder* tBuilder, DreamMugenAssignmentOpcode tOpcode, int tStackDelta, void* tPointer = NULL) {
+	AssignmentInstruction e;
+	e.mOpcode = tOpcode;
+	e.mMemoSymbol = 0;
+	e.mPointer = tPointer;
+	tBuilder->mInstructions.push_back(e);
+
+	tBuilder->mDepth += tStackDelta;
+	tBuilder->mMaximumDepth = max(tBuilder->mMaximumDepth, tBuilder->mDepth);
+}
+
+static void addAssignmentProgramNumberInstruction(AssignmentProgramBuilder* tBuilder, DreamMugenAssignmentOpcode tOpcode, int tValue) {
+	addAssignmentProgramInstruction(tBuilder, tOpcode, 1);
+	tBuilder->mInstructions.back().mNumber = tValue;
+}
+
+static void addAssignmentProgramFloatInstruction(AssignmentProgramBuilder* tBuilder, double tValue) {
+	addAssignmentProgramInstruction(tBuilder, MUGEN_ASSIGNMENT_OPCODE_PUSH_FLOAT, 1);
+	tBuilder->mInstructions.back().mFloat = tValue;
+}
+
+// every variable function returns a single fixed type, which lets the compiler pick typed opcodes for them
+static const VariableFunction gIntegerVariableFunctions[] = {
+	aiLevelFunction, aliveFunction, animFunction, animTimeFunction, canRecoverFunction, ctrlFunction, dataAirjuggleFunction,
+	dataAttackFunction, dataDefenceFunction, dataFloatPersistIndexFunction, dataGuardSparkNoFunction, dataIntPersistIndexFunction,
+	dataKOEchoFunction, dataLiedownTimeFunction, dataLifeFunction, dataPowerFunction, dataSparkNoFunction, drawGameFunction, facingFunction,
+	gameTimeFunction, getHitVarAirtypeFunction, getHitVarAnimtypeFunction, getHitVarChainIDFunction, getHitVarCtrltimeFunction,
+	getHitVarDamageFunction, getHitVarFallDamageFunction, getHitVarFallEnvshakeAmplFunction, getHitVarFallEnvshakeTimeFunction,
+	getHitVarFallFunction, getHitVarFallKillFunction, getHitVarFallRecoverFunction, getHitVarFallRecoverTimeFunction,
+	getHitVarFallcountFunction, getHitVarGroundtypeFunction, getHitVarGuardedFunction, getHitVarHitTimeFunction, getHitVarHitcountFunction,
+	getHitVarHitshaketimeFunction, getHitVarIsBoundFunction, getHitVarRecoverTimeFunction, getHitVarSlidetimeFunction, getHitVarTypeFunction,
+	hitCountFunction, hitFallFunction, hitOverFunction, hitPauseTimeFunction, hitShakeOverFunction, idFunction, inGuardDistFunction,
+	inputAllowedFunction, isHelperFunction, isHomeTeamFunction, lifeFunction, lifeMaxFunction, loseFunction, matchNoFunction,
+	matchOverFunction, moveContactFunction, moveGuardedFunction, moveHitFunction, moveReversedFunction, movementAirJumpHeightFunction,
+	movementAirJumpNumFunction, numEnemyFunction, numExplodFunction, numHelperFunction, numPartnerFunction, numProjFunction,
+	numTargetFunction, p2LifeFunction, p2StateNoFunction, palNoFunction, powerFunction, powerMaxFunction, prevStateNoFunction, randomFunction,
+	roundNoFunction, roundStateFunction, roundsExistedFunction, sizeAirBackFunction, sizeAirFrontFunction, sizeAttackDistFunction,
+	sizeDrawOffsetXFunction, sizeDrawOffsetYFunction, sizeGroundBackFunction, sizeGroundFrontFunction, sizeHeightFunction,
+	sizeProjAttackDistFunction, sizeProjDoScaleFunction, sizeShadowOffsetFunction, stateNoFunction, teamSideFunction, ticksPerSecondFunction,
+	timeFunction, uniqHitCountFunction, winFunction
+};
+
+static const VariableFunction gFloatVariableFunctions[] = {
+	backEdgeBodyDistFunction, backEdgeDistFunction, backEdgeFunction, bottomEdgeFunction, cameraPosXFunction, cameraPosYFunction,
+	cameraZoomFunction, dataFallDefenceMultiplierFunction, eFunction, frontEdgeBodyDistFunction, frontEdgeDistFunction, frontEdgeFunction,
+	gameHeightFunction, gameWidthFunction, getHitVarFallEnvshakeFreqFunction, getHitVarFallEnvshakePhaseFunction, getHitVarFallXVelFunction,
+	getHitVarFallYVelFunction, getHitVarXOffFunction, getHitVarXVelAddFunction, getHitVarXvelFunction, getHitVarYOffFunction,
+	getHitVarYVelAddFunction, getHitVarYaccelFunction, getHitVarYvelFunction, hitVelXFunction, hitVelYFunction, leftEdgeFunction,
+	movementAirGetHitAirRecoverThresholdFunction, movementAirGetHitAirRecoverYAccelFunction, movementAirGetHitGroundLevelFunction,
+	movementAirGetHitGroundRecoverGroundLevelFunction, movementAirGetHitGroundRecoverGroundThresholdFunction,
+	movementAirGetHitTripGroundLevelFunction, movementCrouchFrictionFunction, movementCrouchFrictionThresholdFunction,
+	movementDownBounceGroundLevelFunction, movementDownBounceOffsetXFunction, movementDownBounceOffsetYFunction,
+	movementDownBounceYAccelFunction, movementDownFrictionThresholdFunction, movementJumpChangeAnimThresholdFunction,
+	movementStandFrictionFunction, movementStandFrictionThresholdFunction, movementYAccelFunction, p2BodyDistFunctionX, p2BodyDistFunctionY,
+	p2DistFunctionX, p2DistFunctionY, parentDistXFunction, parentDistYFunction, piFunction, posXFunction, posYFunction, rightEdgeFunction,
+	rootDistXFunction, rootDistYFunction, screenHeightFunction, screenPosXFunction, screenPosYFunction, screenWidthFunction,
+	sizeHeadPosXFunction, sizeHeadPosYFunction, sizeMidPosXFunction, sizeMidPosYFunction, sizeXScaleFunction, sizeYScaleFunction,
+	topEdgeFunction, velXFunction, velYFunction, velocityAirGetHitAirRecoverAddXFunction, velocityAirGetHitAirRecoverAddYFunction,
+	velocityAirGetHitAirRecoverBackFunction, velocityAirGetHitAirRecoverDownFunction, velocityAirGetHitAirRecoverFwdFunction,
+	velocityAirGetHitAirRecoverMulXFunction, velocityAirGetHitAirRecoverMulYFunction, velocityAirGetHitAirRecoverUpFunction,
+	velocityAirGetHitGroundRecoverXFunction, velocityAirGetHitGroundRecoverYFunction, velocityAirJumpBackXFunction,
+	velocityAirJumpFwdXFunction, velocityAirJumpNeuXFunction, velocityAirJumpYFunction, velocityJumpBackXFunction, velocityJumpFwdXFunction,
+	velocityJumpNeuXFunction, velocityJumpYFunction, velocityRunBackXFunction, velocityRunBackYFunction, velocityRunFwdXFunction,
+	velocityRunFwdYFunction, velocityRunJumpBackXFunction, velocityRunJumpFwdXFunction, velocityWalkBackXFunction, velocityWalkFwdXFunction
+};
+
+static const VariableFunction gStringVariableFunctions[] = {
+	authorNameFunction, nameFunction, p1NameFunction, p2NameFunction, p3NameFunction, p4NameFunction, platformFunction
+};
+
+// array functions that leave the static flag set when their index is static
+static const ArrayFunction gStaticArrayFunctions[] = {
+	absFunction, expFunction, lnFunction, logFunction, cosFunction, acosFunction, sinFunction, asinFunction, tanFunction, atanFunction,
+	floorFunction, ceilFunction, ifElseFunction, condFunction, selfAnimExistFunction, const240pFunction, const480pFunction, const720pFunction, stageVarFunction
+};
+
+static struct {
+	unordered_map<const void*, AssignmentProgramType> mVariableTypes;
+	set<const void*> mStaticArrays;
+} gAssignmentProgramTypes;
+
+static void addAssignmentProgramVariableTypes(const VariableFunction* tFunctions, int tAmount, AssignmentProgramType tType) {
+	for (int i = 0; i < tAmount; i++) {
+		gAssignmentProgramTypes.mVariableTypes[(const void*)tFunctions[i]] = tType;
+	}
 }
 
-static AssignmentReturnValue* evaluateStaticAssignment(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer, int* tIsStatic) {
-	(void)tPlayer;
-	(void)tIsStatic;
+static void setupAssignmentProgramTypes() {
+	if (!gAssignmentProgramTypes.mVariableTypes.empty()) return;
 
-	DreamMugenStaticAssignment* stat = (DreamMugenStaticAssignment*)*tAssignment;
-	return stat->mValue;
+	addAssignmentProgramVariableTypes(gIntegerVariableFunctions, sizeof(gIntegerVariableFunctions) / sizeof(gIntegerVariableFunctions[0]), ASSIGNMENT_PROGRAM_TYPE_INTEGER);
+	addAssignmentProgramVariableTypes(gFloatVariableFunctions, sizeof(gFloatVariableFunctions) / sizeof(gFloatVariableFunctions[0]), ASSIGNMENT_PROGRAM_TYPE_FLOAT);
+	addAssignmentProgramVariableTypes(gStringVariableFunctions, sizeof(gStringVariableFunctions) / sizeof(gStringVariableFunctions[0]), ASSIGNMENT_PROGRAM_TYPE_STRING);
+	for (size_t i = 0; i < sizeof(gStaticArrayFunctions) / sizeof(gStaticArrayFunctions[0]); i++) {
+		gAssignmentProgramTypes.mStaticArrays.insert((const void*)gStaticArrayFunctions[i]);
+	}
 }
 
-typedef AssignmentReturnValue*(AssignmentEvaluationFunction)(DreamMugenAssignment**, DreamPlayer*, int*);
+static AssignmentProgramType getAssignmentProgramVariableType(const void* tFunc) {
+	auto it = gAssignmentProgramTypes.mVariableTypes.find(tFunc);
+	if (it == gAssignmentProgramTypes.mVariableTypes.end()) return ASSIGNMENT_PROGRAM_TYPE_UNKNOWN;
+	return it->second;
+}
 
-static void* gEvaluationFunctions[] = {
-	(void*)evaluateBooleanAssignment,
-	(void*)evaluateAndAssignment,
-	(void*)evaluateOrAssignment,
-	(void*)evaluateComparisonAssignment,
-	(void*)evaluateInequalityAssignment,
-	(void*)evaluateLessOrEqualAssignment,
-	(void*)evaluateGreaterOrEqualAssignment,
-	(void*)evaluateVectorAssignment,
-	(void*)evaluateRangeAssignment,
-	(void*)evaluateBooleanAssignment,
-	(void*)evaluateNegationAssignment,
-	(void*)evaluateVariableAssignment,
-	(void*)evaluateRawVariableAssignment,
-	(void*)evaluateNumberAssignment,
-	(void*)evaluateFloatAssignment,
-	(void*)evaluateStringAssignment,
-	(void*)evaluateArrayAssignment,
-	(void*)evaluateLessAssignment,
-	(void*)evaluateGreaterAssignment,
-	(void*)evaluateAdditionAssignment,
-	(void*)evaluateMultiplicationAssignment,
-	(void*)evaluateModuloAssignment,
-	(void*)evaluateSubtractionAssignment,
-	(void*)evaluateSetVariableAssignment,
-	(void*)evaluateDivisionAssignment,
-	(void*)evaluateExponentiationAssignment,
-	(void*)evaluateUnaryMinusAssignment,
-	(void*)evaluateOperatorArgumentAssignment,
-	(void*)evaluateBitwiseAndAssignment,
-	(void*)evaluateBitwiseOrAssignment,
-	(void*)evaluateStaticAssignment,
-};
+static int isAssignmentProgramTypeNumerical(AssignmentProgramType tType) {
+	return tType == ASSIGNMENT_PROGRAM_TYPE_INTEGER || tType == ASSIGNMENT_PROGRAM_TYPE_FLOAT;
+}
 
+static AssignmentProgramType getAssignmentProgramArithmeticType(AssignmentProgramType a, AssignmentProgramType b, int tHasIntegerResult) {
+	if (!isAssignmentProgramTypeNumerical(a) || !isAssignmentProgramTypeNumerical(b)) return ASSIGNMENT_PROGRAM_TYPE_UNKNOWN;
+	if (a == ASSIGNMENT_PROGRAM_TYPE_FLOAT || b == ASSIGNMENT_PROGRAM_TYPE_FLOAT) return ASSIGNMENT_PROGRAM_TYPE_FLOAT;
+	return tHasIntegerResult ? ASSIGNMENT_PROGRAM_TYPE_INTEGER : ASSIGNMENT_PROGRAM_TYPE_UNKNOWN;
+}
+
+static int isAssignmentProgramTriggerComparison(DreamMugenAssignment* a) {
+	if (a->mType == MUGEN_ASSIGNMENT_TYPE_TRIGGER || a->mType == MUGEN_ASSIGNMENT_TYPE_VECTOR) return 1;
+	if (a->mType != MUGEN_ASSIGNMENT_TYPE_NEGATION) return 0;
+
+	DreamMugenDependOnOneAssignment* neg = (DreamMugenDependOnOneAssignment*)a;
+	return neg->a->mType == MUGEN_ASSIGNMENT_TYPE_TRIGGER;
+}
 
-static void setAssignmentStatic(DreamMugenAssignment** tAssignment, AssignmentReturnValue* tValue) {
-	switch ((*tAssignment)->mType) {
+// mirrors the types compileAssignmentProgramNode reports, without emitting anything
+static AssignmentProgramType inferAssignmentProgramType(DreamMugenAssignment* tAssignment) {
+	switch (tAssignment->mType) {
+	case MUGEN_ASSIGNMENT_TYPE_FIXED_BOOLEAN:
+	case MUGEN_ASSIGNMENT_TYPE_NULL:
+	case MUGEN_ASSIGNMENT_TYPE_NUMBER:
 	case MUGEN_ASSIGNMENT_TYPE_AND:
 	case MUGEN_ASSIGNMENT_TYPE_OR:
+	case MUGEN_ASSIGNMENT_TYPE_NEGATION:
+	case MUGEN_ASSIGNMENT_TYPE_BITWISE_AND:
+	case MUGEN_ASSIGNMENT_TYPE_BITWISE_OR:
+	case MUGEN_ASSIGNMENT_TYPE_FLAGS:
+		return ASSIGNMENT_PROGRAM_TYPE_INTEGER;
 	case MUGEN_ASSIGNMENT_TYPE_COMPARISON:
 	case MUGEN_ASSIGNMENT_TYPE_INEQUALITY:
+	case MUGEN_ASSIGNMENT_TYPE_LESS:
 	case MUGEN_ASSIGNMENT_TYPE_LESS_OR_EQUAL:
+	case MUGEN_ASSIGNMENT_TYPE_GREATER:
 	case MUGEN_ASSIGNMENT_TYPE_GREATER_OR_EQUAL:
-	case MUGEN_ASSIGNMENT_TYPE_VECTOR:
-	case MUGEN_ASSIGNMENT_TYPE_RANGE:
-	case MUGEN_ASSIGNMENT_TYPE_NEGATION:
-	case MUGEN_ASSIGNMENT_TYPE_VARIABLE:
+	{
+		// only comparisons with typed opcodes are guaranteed to produce a boolean, the rest may return bottom
+		DreamMugenDependOnTwoAssignment* e = (DreamMugenDependOnTwoAssignment*)tAssignment;
+		if (isAssignmentProgramTriggerComparison(e->a)) return ASSIGNMENT_PROGRAM_TYPE_UNKNOWN;
+		int isTyped = isAssignmentProgramTypeNumerical(inferAssignmentProgramType(e->a)) && isAssignmentProgramTypeNumerical(inferAssignmentProgramType(e->b));
+		return isTyped ? ASSIGNMENT_PROGRAM_TYPE_INTEGER : ASSIGNMENT_PROGRAM_TYPE_UNKNOWN;
+	}
+	case MUGEN_ASSIGNMENT_TYPE_FLOAT:
+		return ASSIGNMENT_PROGRAM_TYPE_FLOAT;
+	case MUGEN_ASSIGNMENT_TYPE_STRING:
 	case MUGEN_ASSIGNMENT_TYPE_RAW_VARIABLE:
+		return ASSIGNMENT_PROGRAM_TYPE_STRING;
+	case MUGEN_ASSIGNMENT_TYPE_VARIABLE:
+		return getAssignmentProgramVariableType(((DreamMugenVariableAssignment*)tAssignment)->mFunc);
+	case MUGEN_ASSIGNMENT_TYPE_ARRAY:
+	{
+		ArrayFunction func = (ArrayFunction)((DreamMugenArrayAssignment*)tAssignment)->mFunc;
+		if (func == varFunction || func == sysVarFunction) return ASSIGNMENT_PROGRAM_TYPE_INTEGER;
+		if (func == fVarFunction || func == sysFVarFunction) return ASSIGNMENT_PROGRAM_TYPE_FLOAT;
+		return ASSIGNMENT_PROGRAM_TYPE_UNKNOWN;
+	}
+	case MUGEN_ASSIGNMENT_TYPE_UNARY_MINUS:
+	{
+		AssignmentProgramType a = inferAssignmentProgramType(((DreamMugenDependOnOneAssignment*)tAssignment)->a);
+		return isAssignmentProgramTypeNumerical(a) ? a : ASSIGNMENT_PROGRAM_TYPE_UNKNOWN;
+	}
+	case MUGEN_ASSIGNMENT_TYPE_ADDITION:
+	case MUGEN_ASSIGNMENT_TYPE_SUBTRACTION:
+	case MUGEN_ASSIGNMENT_TYPE_MULTIPLICATION:
+	case MUGEN_ASSIGNMENT_TYPE_DIVISION:
+	{
+		DreamMugenDependOnTwoAssignment* e = (DreamMugenDependOnTwoAssignment*)tAssignment;
+		return getAssignmentProgramArithmeticType(inferAssignmentProgramType(e->a), inferAssignmentProgramType(e->b), tAssignment->mType != MUGEN_ASSIGNMENT_TYPE_DIVISION);
+	}
+	case MUGEN_ASSIGNMENT_TYPE_CONDITIONAL:
+	{
+		DreamMugenConditionalAssignment* e = (DreamMugenConditionalAssignment*)tAssignment;
+		if (e->mIsEager) return ASSIGNMENT_PROGRAM_TYPE_UNKNOWN;
+		AssignmentProgramType yes = inferAssignmentProgramType(e->mTrue);
+		return yes == inferAssignmentProgramType(e->mFalse) ? yes : ASSIGNMENT_PROGRAM_TYPE_UNKNOWN;
+	}
+	default:
+		return ASSIGNMENT_PROGRAM_TYPE_UNKNOWN;
+	}
+}
+
+typedef enum {
+	ASSIGNMENT_STATIC_KIND_NEVER,
+	ASSIGNMENT_STATIC_KIND_CONSTANT,
+	ASSIGNMENT_STATIC_KIND_CACHEABLE,
+} AssignmentStaticKind;
+
+static AssignmentStaticKind combineAssignmentStaticKinds(AssignmentStaticKind a, AssignmentStaticKind b) {
+	if (a == ASSIGNMENT_STATIC_KIND_NEVER || b == ASSIGNMENT_STATIC_KIND_NEVER) return ASSIGNMENT_STATIC_KIND_NEVER;
+	return max(a, b);
+}
+
+// cacheable subtrees only depend on literals and static array functions, so their value is fixed per player
+static AssignmentStaticKind getAssignmentStaticKind(DreamMugenAssignment* tAssignment) {
+	switch (tAssignment->mType) {
+	case MUGEN_ASSIGNMENT_TYPE_FIXED_BOOLEAN:
+	case MUGEN_ASSIGNMENT_TYPE_NULL:
+	case MUGEN_ASSIGNMENT_TYPE_NUMBER:
+	case MUGEN_ASSIGNMENT_TYPE_FLOAT:
+	case MUGEN_ASSIGNMENT_TYPE_STRING:
+		return ASSIGNMENT_STATIC_KIND_CONSTANT;
 	case MUGEN_ASSIGNMENT_TYPE_ARRAY:
+	{
+		DreamMugenArrayAssignment* e = (DreamMugenArrayAssignment*)tAssignment;
+		if (!stl_set_contains(gAssignmentProgramTypes.mStaticArrays, (const void*)e->mFunc)) return ASSIGNMENT_STATIC_KIND_NEVER;
+		return combineAssignmentStaticKinds(getAssignmentStaticKind(e->mIndex), ASSIGNMENT_STATIC_KIND_CACHEABLE);
+	}
+	case MUGEN_ASSIGNMENT_TYPE_UNARY_MINUS:
+	case MUGEN_ASSIGNMENT_TYPE_NEGATION:
+		return getAssignmentStaticKind(((DreamMugenDependOnOneAssignment*)tAssignment)->a);
+	case MUGEN_ASSIGNMENT_TYPE_AND:
+	case MUGEN_ASSIGNMENT_TYPE_OR:
+	case MUGEN_ASSIGNMENT_TYPE_COMPARISON:
+	case MUGEN_ASSIGNMENT_TYPE_INEQUALITY:
 	case MUGEN_ASSIGNMENT_TYPE_LESS:
+	case MUGEN_ASSIGNMENT_TYPE_LESS_OR_EQUAL:
 	case MUGEN_ASSIGNMENT_TYPE_GREATER:
+	case MUGEN_ASSIGNMENT_TYPE_GREATER_OR_EQUAL:
 	case MUGEN_ASSIGNMENT_TYPE_ADDITION:
-	case MUGEN_ASSIGNMENT_TYPE_MULTIPLICATION:
-	case MUGEN_ASSIGNMENT_TYPE_MODULO:
 	case MUGEN_ASSIGNMENT_TYPE_SUBTRACTION:
-	case MUGEN_ASSIGNMENT_TYPE_SET_VARIABLE:
+	case MUGEN_ASSIGNMENT_TYPE_MULTIPLICATION:
 	case MUGEN_ASSIGNMENT_TYPE_DIVISION:
+	case MUGEN_ASSIGNMENT_TYPE_MODULO:
 	case MUGEN_ASSIGNMENT_TYPE_EXPONENTIATION:
-	case MUGEN_ASSIGNMENT_TYPE_UNARY_MINUS:
-	case MUGEN_ASSIGNMENT_TYPE_OPERATOR_ARGUMENT:
 	case MUGEN_ASSIGNMENT_TYPE_BITWISE_AND:
 	case MUGEN_ASSIGNMENT_TYPE_BITWISE_OR:
-		if(0) *tAssignment = makeStaticDreamMugenAssignment(tValue); // TODO: reset (https://dev.azure.com/captdc/DogmaRnDA/_workitems/edit/388)
-		break;
+	case MUGEN_ASSIGNMENT_TYPE_OPERATOR_ARGUMENT:
+	{
+		DreamMugenDependOnTwoAssignment* e = (DreamMugenDependOnTwoAssignment*)tAssignment;
+		return combineAssignmentStaticKinds(getAssignmentStaticKind(e->a), getAssignmentStaticKind(e->b));
+	}
+	case MUGEN_ASSIGNMENT_TYPE_CONDITIONAL:
+	{
+		DreamMugenConditionalAssignment* e = (DreamMugenConditionalAssignment*)tAssignment;
+		return combineAssignmentStaticKinds(getAssignmentStaticKind(e->mCondition), combineAssignmentStaticKinds(getAssignmentStaticKind(e->mTrue), getAssignmentStaticKind(e->mFalse)));
+	}
 	default:
-		break;
+		return ASSIGNMENT_STATIC_KIND_NEVER;
 	}
 }
 
-static AssignmentReturnValue* evaluateAssignmentInternal(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer, int* oIsStatic) {
-	*oIsStatic = 1;
-	
-	if (!tAssignment || !(*tAssignment)) {
-		logWarning("Invalid assignment. Defaulting to bottom.");
-		return makeBottomAssignmentReturn(); 
-	}
+static AssignmentProgramType compileAssignmentProgramNode(AssignmentProgramBuilder* tBuilder, DreamMugenAssignment** tAssignment);
 
+static AssignmentProgramType compileAssignmentProgramTree(AssignmentProgramBuilder* tBuilder, DreamMugenAssignment** tAssignment) {
+	addAssignmentProgramInstruction(tBuilder, MUGEN_ASSIGNMENT_OPCODE_EVALUATE_TREE, 1, tAssignment);
+	return ASSIGNMENT_PROGRAM_TYPE_UNKNOWN;
+}
 
-	if ((*tAssignment)->mType >= MUGEN_ASSIGNMENT_TYPE_AMOUNT) {
-		logWarningFormat("Unidentified assignment type %d. Returning bottom.", (*tAssignment)->mType);
-		return makeBottomAssignmentReturn();
-	}
+static AssignmentProgramType compileAssignmentProgramStatic(AssignmentProgramBuilder* tBuilder, DreamMugenAssignment** tAssignment) {
+	addAssignmentProgramNumberInstruction(tBuilder, MUGEN_ASSIGNMENT_OPCODE_EVALUATE_STATIC, int(tBuilder->mStatics.size()));
+	tBuilder->mStatics.push_back(tAssignment);
+	return ASSIGNMENT_PROGRAM_TYPE_UNKNOWN;
+}
 
-	AssignmentEvaluationFunction* func = (AssignmentEvaluationFunction*)gEvaluationFunctions[(*tAssignment)->mType];
-	AssignmentReturnValue* ret = func(tAssignment, tPlayer, oIsStatic);
+static AssignmentProgramType compileAssignmentProgramArray(AssignmentProgramBuilder* tBuilder, DreamMugenAssignment** tAssignment) {
+	DreamMugenArrayAssignment* arrays = (DreamMugenArrayAssignment*)*tAssignment;
 
-	if (*oIsStatic) {
-		setAssignmentStatic(tAssignment, ret);
+	ArrayFunction func = (ArrayFunction)arrays->mFunc;
+	if (func == varFunction || func == sysVarFunction) {
+		compileAssignmentProgramNode(tBuilder, &arrays->mIndex);
+		addAssignmentProgramInstruction(tBuilder, func == varFunction ? MUGEN_ASSIGNMENT_OPCODE_LOAD_VAR : MUGEN_ASSIGNMENT_OPCODE_LOAD_SYSVAR, 0);
+		return ASSIGNMENT_PROGRAM_TYPE_INTEGER;
 	}
+	else if (func == fVarFunction || func == sysFVarFunction) {
+		compileAssignmentProgramNode(tBuilder, &arrays->mIndex);
+		addAssignmentProgramInstruction(tBuilder, func == fVarFunction ? MUGEN_ASSIGNMENT_OPCODE_LOAD_FVAR : MUGEN_ASSIGNMENT_OPCODE_LOAD_SYSFVAR, 0);
+		return ASSIGNMENT_PROGRAM_TYPE_FLOAT;
+	}
+	else {
+		return compileAssignmentProgramTree(tBuilder, tAssignment);
+	}
+}
 
-	return ret;
+static AssignmentProgramType compileAssignmentProgramLogical(AssignmentProgramBuilder* tBuilder, DreamMugenAssignment** tAssignment, DreamMugenAssignmentOpcode tJumpOpcode) {
+	DreamMugenDependOnTwoAssignment* logical = (DreamMugenDependOnTwoAssignment*)*tAssignment;
+
+	compileAssignmentProgramNode(tBuilder, &logical->a);
+	size_t jumpPosition = tBuilder->mInstructions.size();
+	addAssignmentProgramInstruction(tBuilder, tJumpOpcode, -1);
+	compileAssignmentProgramNode(tBuilder, &logical->b);
+	addAssignmentProgramInstruction(tBuilder, MUGEN_ASSIGNMENT_OPCODE_TO_BOOLEAN, 0);
+	tBuilder->mInstructions[jumpPosition].mNumber = int(tBuilder->mInstructions.size());
+	return ASSIGNMENT_PROGRAM_TYPE_INTEGER;
 }
 
-static AssignmentReturnValue* evaluateAssignmentStart(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer, int* oIsStatic) {
-	gAssignmentEvaluator.mFreePointer = 0;
+static AssignmentProgramType compileAssignmentProgramConditional(AssignmentProgramBuilder* tBuilder, DreamMugenAssignment** tAssignment) {
+	DreamMugenConditionalAssignment* conditional = (DreamMugenConditionalAssignment*)*tAssignment;
+	if (conditional->mIsEager) {
+		return compileAssignmentProgramTree(tBuilder, tAssignment);
+	}
 
-	auto ret = evaluateAssignmentInternal(tAssignment, tPlayer, oIsStatic);
+	compileAssignmentProgramNode(tBuilder, &conditional->mCondition);
+	size_t falseJumpPosition = tBuilder->mInstructions.size();
+	addAssignmentProgramInstruction(tBuilder, MUGEN_ASSIGNMENT_OPCODE_JUMP_IF_FALSE, -1);
+	AssignmentProgramType yes = compileAssignmentProgramNode(tBuilder, &conditional->mTrue);
+	size_t endJumpPosition = tBuilder->mInstructions.size();
+	addAssignmentProgramInstruction(tBuilder, MUGEN_ASSIGNMENT_OPCODE_JUMP, 0);
 
-	if(!gAssignmentEvaluator.mEmergencyStack.empty()) gAssignmentEvaluator.mEmergencyStack.clear();
-	return ret;
+	// only one of the branches ends up on the stack
+	tBuilder->mDepth--;
+	tBuilder->mInstructions[falseJumpPosition].mNumber = int(tBuilder->mInstructions.size());
+	AssignmentProgramType no = compileAssignmentProgramNode(tBuilder, &conditional->mFalse);
+	tBuilder->mInstructions[endJumpPosition].mNumber = int(tBuilder->mInstructions.size());
+	return yes == no ? yes : ASSIGNMENT_PROGRAM_TYPE_UNKNOWN;
 }
 
-static AssignmentReturnValue* timeStoryFunction(DreamPlayer* tPlayer) { return makeNumberAssignmentReturn(getDolmexicaStoryTimeInState((StoryInstance*)tPlayer)); }
+static DreamMugenAssignmentOpcode getAssignmentProgramTypedOpcode(AssignmentProgramType a, AssignmentProgramType b, DreamMugenAssignmentOpcode tGenericOpcode, DreamMugenAssignmentOpcode tIntegerOpcode, DreamMugenAssignmentOpcode tFloatOpcode) {
+	if (!isAssignmentProgramTypeNumerical(a) || !isAssignmentProgramTypeNumerical(b)) return tGenericOpcode;
+	if (a == ASSIGNMENT_PROGRAM_TYPE_FLOAT || b == ASSIGNMENT_PROGRAM_TYPE_FLOAT) return tFloatOpcode;
+	return tIntegerOpcode;
+}
+
+static AssignmentProgramType compileAssignmentProgramArithmetic(AssignmentProgramBuilder* tBuilder, DreamMugenAssignment** tAssignment, DreamMugenAssignmentOpcode tGenericOpcode, DreamMugenAssignmentOpcode tIntegerOpcode, DreamMugenAssignmentOpcode tFloatOpcode) {
+	DreamMugenDependOnTwoAssignment* arithmetic = (DreamMugenDependOnTwoAssignment*)*tAssignment;
 
-static void setupStoryVariableAssignments() {
-	gVariableHandler.mVariables.clear();
-	gVariableHandler.mVariables["time"] = timeStoryFunction;
-	gVariableHandler.mVariables["random"] = randomFunction;
-	gVariableHandler.mVariables["platform"] = platformFunction;
+	AssignmentProgramType a = compileAssignmentProgramNode(tBuilder, &arithmetic->a);
+	AssignmentProgramType b = compileAssignmentProgramNode(tBuilder, &arithmetic->b);
+	DreamMugenAssignmentOpcode opcode = getAssignmentProgramTypedOpcode(a, b, tGenericOpcode, tIntegerOpcode, tFloatOpcode);
+	addAssignmentProgramInstruction(tBuilder, opcode, -1);
+
+	if (opcode == tGenericOpcode) return ASSIGNMENT_PROGRAM_TYPE_UNKNOWN;
+	else if (opcode == tIntegerOpcode) return ASSIGNMENT_PROGRAM_TYPE_INTEGER;
+	else return ASSIGNMENT_PROGRAM_TYPE_FLOAT;
 }
 
-//static AssignmentReturnValue* movementDownFrictionThresholdFunction(DreamPlayer* tPlayer) { return makeFloatAssignmentReturn(getPlayerLyingDownFrictionThreshold(tPlayer)); }
+static AssignmentProgramType compileAssignmentProgramComparison(AssignmentProgramBuilder* tBuilder, DreamMugenAssignment** tAssignment, DreamMugenAssignmentOpcode tGenericOpcode, DreamMugenAssignmentOpcode tIntegerOpcode, DreamMugenAssignmentOpcode tFloatOpcode) {
+	DreamMugenDependOnTwoAssignment* comparison = (DreamMugenDependOnTwoAssignment*)*tAssignment;
+	if (isAssignmentProgramTriggerComparison(comparison->a)) {
+		return compileAssignmentProgramTree(tBuilder, tAssignment);
+	}
 
-static AssignmentReturnValue* evaluateAnimTimeStoryArrayAssignment(AssignmentReturnValue* tIndex, StoryInstance* tInstance, int* tIsStatic) {
+	AssignmentProgramType a = inferAssignmentProgramType(comparison->a);
+	int isConstantB = comparison->b->mType == MUGEN_ASSIGNMENT_TYPE_NUMBER || comparison->b->mType == MUGEN_ASSIGNMENT_TYPE_FLOAT || comparison->b->mType == MUGEN_ASSIGNMENT_TYPE_FIXED_BOOLEAN;
+	if (isConstantB && isAssignmentProgramTypeNumerical(a)) {
+		// the constant opcodes follow the order of the generic comparison opcodes
+		int offset = tGenericOpcode - MUGEN_ASSIGNMENT_OPCODE_COMPARISON;
+		compileAssignmentProgramNode(tBuilder, &comparison->a);
+		if (a == ASSIGNMENT_PROGRAM_TYPE_INTEGER && comparison->b->mType != MUGEN_ASSIGNMENT_TYPE_FLOAT) {
+			addAssignmentProgramInstruction(tBuilder, DreamMugenAssignmentOpcode(MUGEN_ASSIGNMENT_OPCODE_COMPARISON_INTEGER_CONSTANT + offset), 0);
+			tBuilder->mInstructions.back().mNumber = comparison->b->mType == MUGEN_ASSIGNMENT_TYPE_NUMBER ? ((DreamMugenNumberAssignment*)comparison->b)->mValue : ((DreamMugenFixedBooleanAssignment*)comparison->b)->mValue;
+		}
+		else {
+			addAssignmentProgramInstruction(tBuilder, DreamMugenAssignmentOpcode(MUGEN_ASSIGNMENT_OPCODE_COMPARISON_FLOAT_CONSTANT + offset), 0);
+			if (comparison->b->mType == MUGEN_ASSIGNMENT_TYPE_FLOAT) tBuilder->mInstructions.back().mFloat = ((DreamMugenFloatAssignment*)comparison->b)->mValue;
+			else if (comparison->b->mType == MUGEN_ASSIGNMENT_TYPE_NUMBER) tBuilder->mInstructions.back().mFloat = ((DreamMugenNumberAssignment*)comparison->b)->mValue;
+			else tBuilder->mInstructions.back().mFloat = ((DreamMugenFixedBooleanAssignment*)comparison->b)->mValue;
+		}
+		return ASSIGNMENT_PROGRAM_TYPE_INTEGER;
+	}
+
+	// the tree evaluator resolves the right side first, so comparisons keep a on top of b
+	AssignmentProgramType b = compileAssignmentProgramNode(tBuilder, &comparison->b);
+	a = compileAssignmentProgramNode(tBuilder, &comparison->a);
+	DreamMugenAssignmentOpcode opcode = getAssignmentProgramTypedOpcode(a, b, tGenericOpcode, tIntegerOpcode, tFloatOpcode);
+	addAssignmentProgramInstruction(tBuilder, opcode, -1);
+	return opcode == tGenericOpcode ? ASSIGNMENT_PROGRAM_TYPE_UNKNOWN : ASSIGNMENT_PROGRAM_TYPE_INTEGER;
+}
+
+static AssignmentProgramType compileAssignmentProgramNode(AssignmentProgramBuilder* tBuilder, DreamMugenAssignment** tAssignment) {
+	DreamMugenAssignment* assignment = *tAssignment;
+	if (getAssignmentStaticKind(assignment) == ASSIGNMENT_STATIC_KIND_CACHEABLE) return compileAssignmentProgramStatic(tBuilder, tAssignment);
+
+	AssignmentProgramType a;
+	switch (assignment->mType) {
+	case MUGEN_ASSIGNMENT_TYPE_FIXED_BOOLEAN:
+	case MUGEN_ASSIGNMENT_TYPE_NULL:
+		addAssignmentProgramNumberInstruction(tBuilder, MUGEN_ASSIGNMENT_OPCODE_PUSH_BOOLEAN, ((DreamMugenFixedBooleanAssignment*)assignment)->mValue);
+		return ASSIGNMENT_PROGRAM_TYPE_INTEGER;
+	case MUGEN_ASSIGNMENT_TYPE_NUMBER:
+		addAssignmentProgramNumberInstruction(tBuilder, MUGEN_ASSIGNMENT_OPCODE_PUSH_NUMBER, ((DreamMugenNumberAssignment*)assignment)->mValue);
+		return ASSIGNMENT_PROGRAM_TYPE_INTEGER;
+	case MUGEN_ASSIGNMENT_TYPE_FLOAT:
+		addAssignmentProgramFloatInstruction(tBuilder, ((DreamMugenFloatAssignment*)assignment)->mValue);
+		return ASSIGNMENT_PROGRAM_TYPE_FLOAT;
+	case MUGEN_ASSIGNMENT_TYPE_VARIABLE:
+		addAssignmentProgramInstruction(tBuilder, MUGEN_ASSIGNMENT_OPCODE_CALL_VARIABLE, 1, ((DreamMugenVariableAssignment*)assignment)->mFunc);
+		tBuilder->mInstructions.back().mMemoSymbol = ((DreamMugenVariableAssignment*)assignment)->mMemoSymbol;
+		return getAssignmentProgramVariableType(((DreamMugenVariableAssignment*)assignment)->mFunc);
+	case MUGEN_ASSIGNMENT_TYPE_ARRAY:
+		return compileAssignmentProgramArray(tBuilder, tAssignment);
+	case MUGEN_ASSIGNMENT_TYPE_FLAGS:
+		addAssignmentProgramInstruction(tBuilder, MUGEN_ASSIGNMENT_OPCODE_TEST_FLAGS, 1, assignment);
+		return ASSIGNMENT_PROGRAM_TYPE_INTEGER;
+	case MUGEN_ASSIGNMENT_TYPE_CONDITIONAL:
+		return compileAssignmentProgramConditional(tBuilder, tAssignment);
+	case MUGEN_ASSIGNMENT_TYPE_AND:
+		return compileAssignmentProgramLogical(tBuilder, tAssignment, MUGEN_ASSIGNMENT_OPCODE_JUMP_IF_FALSE_OR_POP);
+	case MUGEN_ASSIGNMENT_TYPE_OR:
+		return compileAssignmentProgramLogical(tBuilder, tAssignment, MUGEN_ASSIGNMENT_OPCODE_JUMP_IF_TRUE_OR_POP);
+	case MUGEN_ASSIGNMENT_TYPE_NEGATION:
+		compileAssignmentProgramNode(tBuilder, &((DreamMugenDependOnOneAssignment*)assignment)->a);
+		addAssignmentProgramInstruction(tBuilder, MUGEN_ASSIGNMENT_OPCODE_NEGATION, 0);
+		return ASSIGNMENT_PROGRAM_TYPE_INTEGER;
+	case MUGEN_ASSIGNMENT_TYPE_UNARY_MINUS:
+		a = compileAssignmentProgramNode(tBuilder, &((DreamMugenDependOnOneAssignment*)assignment)->a);
+		addAssignmentProgramInstruction(tBuilder, MUGEN_ASSIGNMENT_OPCODE_UNARY_MINUS, 0);
+		return isAssignmentProgramTypeNumerical(a) ? a : ASSIGNMENT_PROGRAM_TYPE_UNKNOWN;
+	case MUGEN_ASSIGNMENT_TYPE_BITWISE_AND:
+	case MUGEN_ASSIGNMENT_TYPE_BITWISE_OR:
+		compileAssignmentProgramNode(tBuilder, &((DreamMugenDependOnTwoAssignment*)assignment)->a);
+		compileAssignmentProgramNode(tBuilder, &((DreamMugenDependOnTwoAssignment*)assignment)->b);
+		addAssignmentProgramInstruction(tBuilder, assignment->mType == MUGEN_ASSIGNMENT_TYPE_BITWISE_AND ? MUGEN_ASSIGNMENT_OPCODE_BITWISE_AND : MUGEN_ASSIGNMENT_OPCODE_BITWISE_OR, -1);
+		return ASSIGNMENT_PROGRAM_TYPE_INTEGER;
+	case MUGEN_ASSIGNMENT_TYPE_ADDITION:
+		return compileAssignmentProgramArithmetic(tBuilder, tAssignment, MUGEN_ASSIGNMENT_OPCODE_ADDITION, MUGEN_ASSIGNMENT_OPCODE_ADDITION_INTEGERS, MUGEN_ASSIGNMENT_OPCODE_ADDITION_FLOATS);
+	case MUGEN_ASSIGNMENT_TYPE_SUBTRACTION:
+		return compileAssignmentProgramArithmetic(tBuilder, tAssignment, MUGEN_ASSIGNMENT_OPCODE_SUBTRACTION, MUGEN_ASSIGNMENT_OPCODE_SUBTRACTION_INTEGERS, MUGEN_ASSIGNMENT_OPCODE_SUBTRACTION_FLOATS);
+	case MUGEN_ASSIGNMENT_TYPE_MULTIPLICATION:
+		return compileAssignmentProgramArithmetic(tBuilder, tAssignment, MUGEN_ASSIGNMENT_OPCODE_MULTIPLICATION, MUGEN_ASSIGNMENT_OPCODE_MULTIPLICATION_INTEGERS, MUGEN_ASSIGNMENT_OPCODE_MULTIPLICATION_FLOATS);
+	case MUGEN_ASSIGNMENT_TYPE_DIVISION:
+		return compileAssignmentProgramArithmetic(tBuilder, tAssignment, MUGEN_ASSIGNMENT_OPCODE_DIVISION, MUGEN_ASSIGNMENT_OPCODE_DIVISION, MUGEN_ASSIGNMENT_OPCODE_DIVISION_FLOATS);
+	case MUGEN_ASSIGNMENT_TYPE_MODULO:
+		return compileAssignmentProgramArithmetic(tBuilder, tAssignment, MUGEN_ASSIGNMENT_OPCODE_MODULO, MUGEN_ASSIGNMENT_OPCODE_MODULO, MUGEN_ASSIGNMENT_OPCODE_MODULO);
+	case MUGEN_ASSIGNMENT_TYPE_EXPONENTIATION:
+		return compileAssignmentProgramArithmetic(tBuilder, tAssignment, MUGEN_ASSIGNMENT_OPCODE_EXPONENTIATION, MUGEN_ASSIGNMENT_OPCODE_EXPONENTIATION, MUGEN_ASSIGNMENT_OPCODE_EXPONENTIATION);
+	case MUGEN_ASSIGNMENT_TYPE_COMPARISON:
+		return compileAssignmentProgramComparison(tBuilder, tAssignment, MUGEN_ASSIGNMENT_OPCODE_COMPARISON, MUGEN_ASSIGNMENT_OPCODE_COMPARISON_INTEGERS, MUGEN_ASSIGNMENT_OPCODE_COMPARISON_FLOATS);
+	case MUGEN_ASSIGNMENT_TYPE_INEQUALITY:
+		return compileAssignmentProgramComparison(tBuilder, tAssignment, MUGEN_ASSIGNMENT_OPCODE_INEQUALITY, MUGEN_ASSIGNMENT_OPCODE_INEQUALITY_INTEGERS, MUGEN_ASSIGNMENT_OPCODE_INEQUALITY_FLOATS);
+	case MUGEN_ASSIGNMENT_TYPE_LESS:
+		return compileAssignmentProgramComparison(tBuilder, tAssignment, MUGEN_ASSIGNMENT_OPCODE_LESS, MUGEN_ASSIGNMENT_OPCODE_LESS_INTEGERS, MUGEN_ASSIGNMENT_OPCODE_LESS_FLOATS);
+	case MUGEN_ASSIGNMENT_TYPE_LESS_OR_EQUAL:
+		return compileAssignmentProgramComparison(tBuilder, tAssignment, MUGEN_ASSIGNMENT_OPCODE_LESS_OR_EQUAL, MUGEN_ASSIGNMENT_OPCODE_LESS_OR_EQUAL_INTEGERS, MUGEN_ASSIGNMENT_OPCODE_LESS_OR_EQUAL_FLOATS);
+	case MUGEN_ASSIGNMENT_TYPE_GREATER:
+		return compileAssignmentProgramComparison(tBuilder, tAssignment, MUGEN_ASSIGNMENT_OPCODE_GREATER, MUGEN_ASSIGNMENT_OPCODE_GREATER_INTEGERS, MUGEN_ASSIGNMENT_OPCODE_GREATER_FLOATS);
+	case MUGEN_ASSIGNMENT_TYPE_GREATER_OR_EQUAL:
+		return compileAssignmentProgramComparison(tBuilder, tAssignment, MUGEN_ASSIGNMENT_OPCODE_GREATER_OR_EQUAL, MUGEN_ASSIGNMENT_OPCODE_GREATER_OR_EQUAL_INTEGERS, MUGEN_ASSIGNMENT_OPCODE_GREATER_OR_EQUAL_FLOATS);
+	default:
+		return compileAssignmentProgramTree(tBuilder, tAssignment);
+	}
+}
+
+static DreamMugenAssignment* makeAssignmentProgram(DreamMugenAssignment* tTree) {
+	DreamMugenProgramAssignment* e = (DreamMugenProgramAssignment*)allocMemory(sizeof(DreamMugenProgramAssignment));
+	e->mType = MUGEN_ASSIGNMENT_TYPE_PROGRAM;
+	e->mTree = tTree;
+
+	AssignmentProgramBuilder builder;
+	builder.mDepth = 0;
+	builder.mMaximumDepth = 0;
+	compileAssignmentProgramNode(&builder, &e->mTree);
+	if (builder.mMaximumDepth > ASSIGNMENT_PROGRAM_STACK_SIZE || builder.mInstructions.size() >= 0xFFFF) {
+		logWarningFormat("Assignment program too large (%d instructions, depth %d). Falling back to tree evaluation.", int(builder.mInstructions.size()), builder.mMaximumDepth);
+		builder.mInstructions.clear();
+		builder.mStatics.clear();
+		builder.mDepth = 0;
+		builder.mMaximumDepth = 0;
+		compileAssignmentProgramTree(&builder, &e->mTree);
+	}
+	addAssignmentProgramInstruction(&builder, MUGEN_ASSIGNMENT_OPCODE_RETURN, 0);
+
+	e->mStackSize = uint16_t(builder.mMaximumDepth);
+	e->mInstructionAmount = uint16_t(builder.mInstructions.size());
+	e->mStaticAmount = uint16_t(builder.mStatics.size());
+	e->mStatics = e->mStaticAmount ? (DreamMugenStaticAssignment*)allocMemory(sizeof(DreamMugenStaticAssignment) * e->mStaticAmount) : NULL;
+	for (int i = 0; i < e->mStaticAmount; i++) {
+		DreamMugenStaticAssignment* stat = &e->mStatics[i];
+		memset(stat, 0, sizeof(DreamMugenStaticAssignment));
+		stat->mType = MUGEN_ASSIGNMENT_TYPE_STATIC;
+		stat->mOriginal = *builder.mStatics[i];
+	}
+	for (auto& instruction : builder.mInstructions) {
+		if (instruction.mOpcode == MUGEN_ASSIGNMENT_OPCODE_EVALUATE_STATIC) instruction.mPointer = &e->mStatics[instruction.mNumber];
+	}
+	e->mInstructions = allocMemory(sizeof(AssignmentInstruction) * e->mInstructionAmount);
+	memcpy(e->mInstructions, builder.mInstructions.data(), sizeof(AssignmentInstruction) * e->mInstructionAmount);
+	return (DreamMugenAssignment*)e;
+}
+
+void compileDreamAssignmentProgram(DreamMugenAssignment** tAssignment)
+{
+	if (!(*tAssignment) || (*tAssignment)->mType == MUGEN_ASSIGNMENT_TYPE_PROGRAM) return;
+	*tAssignment = makeAssignmentProgram(*tAssignment);
+}
+
+static int isProgramValueScalar(const AssignmentProgramValue* tValue) {
+	return tValue->mType == MUGEN_ASSIGNMENT_RETURN_TYPE_NUMBER || tValue->mType == MUGEN_ASSIGNMENT_RETURN_TYPE_BOOLEAN || tValue->mType == MUGEN_ASSIGNMENT_RETURN_TYPE_FLOAT;
+}
+
+static int isProgramValueFloat(const AssignmentProgramValue* tValue) {
+	return tValue->mType == MUGEN_ASSIGNMENT_RETURN_TYPE_FLOAT;
+}
+
+static double getProgramScalarFloat(const AssignmentProgramValue* tValue) {
+	return isProgramValueFloat(tValue) ? tValue->mFloat : tValue->mNumber;
+}
+
+static int getProgramScalarNumber(const AssignmentProgramValue* tValue) {
+	return isProgramValueFloat(tValue) ? int(tValue->mFloat) : tValue->mNumber;
+}
+
+static void setProgramValueNumber(AssignmentProgramValue* oValue, int tValue) {
+	oValue->mType = MUGEN_ASSIGNMENT_RETURN_TYPE_NUMBER;
+	oValue->mNumber = tValue;
+}
+
+static void setProgramValueFloat(AssignmentProgramValue* oValue, double tValue) {
+	oValue->mType = MUGEN_ASSIGNMENT_RETURN_TYPE_FLOAT;
+	oValue->mFloat = tValue;
+}
+
+static void setProgramValueBoolean(AssignmentProgramValue* oValue, int tValue) {
+	oValue->mType = MUGEN_ASSIGNMENT_RETURN_TYPE_BOOLEAN;
+	oValue->mNumber = tValue;
+}
+
+static void setProgramValueFromReturn(AssignmentProgramValue* oValue, AssignmentReturnValue* tReturn) {
+	oValue->mType = tReturn->mType;
+	switch (tReturn->mType) {
+	case MUGEN_ASSIGNMENT_RETURN_TYPE_NUMBER:
+		oValue->mNumber = getNumberAssignmentReturnValue(tReturn);
+		break;
+	case MUGEN_ASSIGNMENT_RETURN_TYPE_BOOLEAN:
+		oValue->mNumber = getBooleanAssignmentReturnValue(tReturn);
+		break;
+	case MUGEN_ASSIGNMENT_RETURN_TYPE_FLOAT:
+		oValue->mFloat = getFloatAssignmentReturnValue(tReturn);
+		break;
+	default:
+		oValue->mReturn = tReturn;
+		break;
+	}
+}
+
+static AssignmentReturnValue* makeAssignmentReturnFromProgramValue(const AssignmentProgramValue* tValue) {
+	switch (tValue->mType) {
+	case MUGEN_ASSIGNMENT_RETURN_TYPE_NUMBER:
+		return makeNumberAssignmentReturn(tValue->mNumber);
+	case MUGEN_ASSIGNMENT_RETURN_TYPE_BOOLEAN:
+		return makeBooleanAssignmentReturn(tValue->mNumber);
+	case MUGEN_ASSIGNMENT_RETURN_TYPE_FLOAT:
+		return makeFloatAssignmentReturn(tValue->mFloat);
+	default:
+		return tValue->mReturn;
+	}
+}
+
+static int convertProgramValueToBool(const AssignmentProgramValue* tValue) {
+	if (isProgramValueScalar(tValue)) return getProgramScalarNumber(tValue);
+	return convertAssignmentReturnToBool(tValue->mReturn);
+}
+
+static int convertProgramValueToNumber(const AssignmentProgramValue* tValue) {
+	if (isProgramValueScalar(tValue)) return getProgramScalarNumber(tValue);
+	return convertAssignmentReturnToNumber(tValue->mReturn);
+}
+
+static double convertProgramValueToFloat(const AssignmentProgramValue* tValue) {
+	if (isProgramValueScalar(tValue)) return getProgramScalarFloat(tValue);
+	return convertAssignmentReturnToFloat(tValue->mReturn);
+}
+
+static void evaluateProgramReturns(AssignmentProgramValue* a, const AssignmentProgramValue* b, AssignmentReturnValue*(*tFunc)(AssignmentReturnValue*, AssignmentReturnValue*), AssignmentProgramValue* oResult) {
+	AssignmentReturnValue* aReturn = makeAssignmentReturnFromProgramValue(a);
+	AssignmentReturnValue* bReturn = makeAssignmentReturnFromProgramValue(b);
+	setProgramValueFromReturn(oResult, tFunc(aReturn, bReturn));
+}
+
+static void evaluateProgramArithmetic(AssignmentProgramValue* a, const AssignmentProgramValue* b, uint8_t tOpcode) {
+	if (!isProgramValueScalar(a) || !isProgramValueScalar(b) || (tOpcode == MUGEN_ASSIGNMENT_OPCODE_MODULO && (isProgramValueFloat(a) || isProgramValueFloat(b)))) {
+		switch (tOpcode) {
+		case MUGEN_ASSIGNMENT_OPCODE_ADDITION: evaluateProgramReturns(a, b, evaluateAdditionReturns, a); break;
+		case MUGEN_ASSIGNMENT_OPCODE_SUBTRACTION: evaluateProgramReturns(a, b, evaluateSubtractionReturns, a); break;
+		case MUGEN_ASSIGNMENT_OPCODE_MULTIPLICATION: evaluateProgramReturns(a, b, evaluateMultiplicationReturns, a); break;
+		case MUGEN_ASSIGNMENT_OPCODE_DIVISION: evaluateProgramReturns(a, b, evaluateDivisionReturns, a); break;
+		case MUGEN_ASSIGNMENT_OPCODE_MODULO: evaluateProgramReturns(a, b, evaluateModuloReturns, a); break;
+		default: evaluateProgramReturns(a, b, evaluateExponentiationReturns, a); break;
+		}
+		return;
+	}
+
+	if (tOpcode == MUGEN_ASSIGNMENT_OPCODE_EXPONENTIATION) {
+		if (isProgramValueFloat(a) || isProgramValueFloat(b) || b->mNumber < 0) setProgramValueFloat(a, pow(getProgramScalarFloat(a), getProgramScalarFloat(b)));
+		else setProgramValueNumber(a, powI(a->mNumber, b->mNumber));
+	}
+	else if (isProgramValueFloat(a) || isProgramValueFloat(b)) {
+		double val1 = getProgramScalarFloat(a);
+		double val2 = getProgramScalarFloat(b);
+		switch (tOpcode) {
+		case MUGEN_ASSIGNMENT_OPCODE_ADDITION: setProgramValueFloat(a, val1 + val2); break;
+		case MUGEN_ASSIGNMENT_OPCODE_SUBTRACTION: setProgramValueFloat(a, val1 - val2); break;
+		case MUGEN_ASSIGNMENT_OPCODE_MULTIPLICATION: setProgramValueFloat(a, val1 * val2); break;
+		default: setProgramValueFloat(a, val1 / val2); break;
+		}
+	}
+	else {
+		int val1 = a->mNumber;
+		int val2 = b->mNumber;
+		switch (tOpcode) {
+		case MUGEN_ASSIGNMENT_OPCODE_ADDITION: setProgramValueNumber(a, val1 + val2); break;
+		case MUGEN_ASSIGNMENT_OPCODE_SUBTRACTION: setProgramValueNumber(a, val1 - val2); break;
+		case MUGEN_ASSIGNMENT_OPCODE_MULTIPLICATION: setProgramValueNumber(a, val1 * val2); break;
+		case MUGEN_ASSIGNMENT_OPCODE_DIVISION: 
+			if (val2) setProgramValueNumber(a, val1 / val2);
+			else setProgramValueFromReturn(a, makeBottomAssignmentReturn());
+			break;
+		default:
+			if (val2) setProgramValueNumber(a, val1 % val2);
+			else setProgramValueFromReturn(a, makeBottomAssignmentReturn());
+			break;
+		}
+	}
+}
+
+static int evaluateProgramScalarComparison(const AssignmentProgramValue* a, const AssignmentProgramValue* b, uint8_t tOpcode) {
+	if (isProgramValueFloat(a) || isProgramValueFloat(b)) {
+		double val1 = getProgramScalarFloat(a);
+		double val2 = getProgramScalarFloat(b);
+		switch (tOpcode) {
+		case MUGEN_ASSIGNMENT_OPCODE_COMPARISON: return val1 == val2;
+		case MUGEN_ASSIGNMENT_OPCODE_INEQUALITY: return val1 != val2;
+		case MUGEN_ASSIGNMENT_OPCODE_LESS: return val1 < val2;
+		case MUGEN_ASSIGNMENT_OPCODE_LESS_OR_EQUAL: return val1 <= val2;
+		case MUGEN_ASSIGNMENT_OPCODE_GREATER: return val1 > val2;
+		default: return val1 >= val2;
+		}
+	}
+	else {
+		int val1 = a->mNumber;
+		int val2 = b->mNumber;
+		switch (tOpcode) {
+		case MUGEN_ASSIGNMENT_OPCODE_COMPARISON: return val1 == val2;
+		case MUGEN_ASSIGNMENT_OPCODE_INEQUALITY: return val1 != val2;
+		case MUGEN_ASSIGNMENT_OPCODE_LESS: return val1 < val2;
+		case MUGEN_ASSIGNMENT_OPCODE_LESS_OR_EQUAL: return val1 <= val2;
+		case MUGEN_ASSIGNMENT_OPCODE_GREATER: return val1 > val2;
+		default: return val1 >= val2;
+		}
+	}
+}
+
+static void evaluateProgramComparison(const AssignmentProgramValue* a, AssignmentProgramValue* b, uint8_t tOpcode) {
+	if (isProgramValueScalar(a) && isProgramValueScalar(b)) {
+		setProgramValueBoolean(b, evaluateProgramScalarComparison(a, b, tOpcode));
+		return;
+	}
+
+	AssignmentReturnValue* aReturn = makeAssignmentReturnFromProgramValue(a);
+	AssignmentReturnValue* bReturn = makeAssignmentReturnFromProgramValue(b);
+	switch (tOpcode) {
+	case MUGEN_ASSIGNMENT_OPCODE_COMPARISON: setProgramValueFromReturn(b, evaluateComparisonReturns(aReturn, bReturn)); break;
+	case MUGEN_ASSIGNMENT_OPCODE_INEQUALITY: setProgramValueBoolean(b, !convertAssignmentReturnToBool(evaluateComparisonReturns(aReturn, bReturn))); break;
+	case MUGEN_ASSIGNMENT_OPCODE_LESS: setProgramValueFromReturn(b, evaluateLessReturns(aReturn, bReturn)); break;
+	case MUGEN_ASSIGNMENT_OPCODE_LESS_OR_EQUAL: setProgramValueFromReturn(b, evaluateLessOrEqualReturns(aReturn, bReturn)); break;
+	case MUGEN_ASSIGNMENT_OPCODE_GREATER: setProgramValueFromReturn(b, evaluateGreaterReturns(aReturn, bReturn)); break;
+	default: setProgramValueFromReturn(b, evaluateGreaterOrEqualReturns(aReturn, bReturn)); break;
+	}
+}
+
+// returns 1 iff the instruction jumps to tInstruction->mNumber
+static inline int executeAssignmentInstruction(uint8_t tOpcode, const AssignmentInstruction* tInstruction, AssignmentProgramValue*& top, DreamPlayer* tPlayer) {
+	int isStatic;
+	switch (tOpcode) {
+	case MUGEN_ASSIGNMENT_OPCODE_PUSH_NUMBER:
+		setProgramValueNumber(++top, tInstruction->mNumber);
+		break;
+	case MUGEN_ASSIGNMENT_OPCODE_PUSH_FLOAT:
+		setProgramValueFloat(++top, tInstruction->mFloat);
+		break;
+	case MUGEN_ASSIGNMENT_OPCODE_PUSH_BOOLEAN:
+		setProgramValueBoolean(++top, tInstruction->mNumber);
+		break;
+	case MUGEN_ASSIGNMENT_OPCODE_CALL_VARIABLE:
+		setProgramValueFromReturn(++top, callVariableFunction((VariableFunction)tInstruction->mPointer, tInstruction->mMemoSymbol, tPlayer));
+		break;
+	case MUGEN_ASSIGNMENT_OPCODE_EVALUATE_TREE:
+		setProgramValueFromReturn(++top, evaluateAssignmentInternal((DreamMugenAssignment**)tInstruction->mPointer, tPlayer, &isStatic));
+		break;
+	case MUGEN_ASSIGNMENT_OPCODE_EVALUATE_STATIC:
+	{
+		DreamMugenAssignment* stat = (DreamMugenAssignment*)tInstruction->mPointer;
+		setProgramValueFromReturn(++top, evaluateStaticAssignment(&stat, tPlayer, &isStatic));
+		break;
+	}
+	case MUGEN_ASSIGNMENT_OPCODE_TEST_FLAGS:
+		setProgramValueBoolean(++top, evaluateFlagsAssignmentValue((DreamMugenFlagsAssignment*)tInstruction->mPointer, tPlayer));
+		break;
+	case MUGEN_ASSIGNMENT_OPCODE_LOAD_VAR:
+		setProgramValueNumber(top, getPlayerVariable(tPlayer, convertProgramValueToNumber(top)));
+		break;
+	case MUGEN_ASSIGNMENT_OPCODE_LOAD_FVAR:
+		setProgramValueFloat(top, getPlayerFloatVariable(tPlayer, convertProgramValueToNumber(top)));
+		break;
+	case MUGEN_ASSIGNMENT_OPCODE_LOAD_SYSVAR:
+		setProgramValueNumber(top, getPlayerSystemVariable(tPlayer, convertProgramValueToNumber(top)));
+		break;
+	case MUGEN_ASSIGNMENT_OPCODE_LOAD_SYSFVAR:
+		setProgramValueFloat(top, getPlayerSystemFloatVariable(tPlayer, convertProgramValueToNumber(top)));
+		break;
+	case MUGEN_ASSIGNMENT_OPCODE_JUMP_IF_FALSE_OR_POP:
+		if (!convertProgramValueToBool(top)) {
+			setProgramValueBoolean(top, 0);
+			return 1;
+		}
+		top--;
+		break;
+	case MUGEN_ASSIGNMENT_OPCODE_JUMP_IF_TRUE_OR_POP:
+	{
+		int value = convertProgramValueToBool(top);
+		if (value) {
+			setProgramValueBoolean(top, value);
+			return 1;
+		}
+		top--;
+		break;
+	}
+	case MUGEN_ASSIGNMENT_OPCODE_JUMP_IF_FALSE:
+		return !convertProgramValueToBool(top--);
+	case MUGEN_ASSIGNMENT_OPCODE_JUMP:
+		return 1;
+	case MUGEN_ASSIGNMENT_OPCODE_TO_BOOLEAN:
+		setProgramValueBoolean(top, convertProgramValueToBool(top));
+		break;
+	case MUGEN_ASSIGNMENT_OPCODE_NEGATION:
+		setProgramValueBoolean(top, !convertProgramValueToBool(top));
+		break;
+	case MUGEN_ASSIGNMENT_OPCODE_UNARY_MINUS:
+		if (isProgramValueFloat(top)) setProgramValueFloat(top, -top->mFloat);
+		else setProgramValueNumber(top, -convertProgramValueToNumber(top));
+		break;
+	case MUGEN_ASSIGNMENT_OPCODE_BITWISE_AND:
+		top--;
+		setProgramValueNumber(top, convertProgramValueToNumber(top) & convertProgramValueToNumber(top + 1));
+		break;
+	case MUGEN_ASSIGNMENT_OPCODE_BITWISE_OR:
+		top--;
+		setProgramValueNumber(top, convertProgramValueToNumber(top) | convertProgramValueToNumber(top + 1));
+		break;
+	case MUGEN_ASSIGNMENT_OPCODE_ADDITION:
+	case MUGEN_ASSIGNMENT_OPCODE_SUBTRACTION:
+	case MUGEN_ASSIGNMENT_OPCODE_MULTIPLICATION:
+	case MUGEN_ASSIGNMENT_OPCODE_DIVISION:
+	case MUGEN_ASSIGNMENT_OPCODE_MODULO:
+	case MUGEN_ASSIGNMENT_OPCODE_EXPONENTIATION:
+		top--;
+		evaluateProgramArithmetic(top, top + 1, tOpcode);
+		break;
+	case MUGEN_ASSIGNMENT_OPCODE_ADDITION_INTEGERS:
+		top--;
+		setProgramValueNumber(top, top->mNumber + top[1].mNumber);
+		break;
+	case MUGEN_ASSIGNMENT_OPCODE_SUBTRACTION_INTEGERS:
+		top--;
+		setProgramValueNumber(top, top->mNumber - top[1].mNumber);
+		break;
+	case MUGEN_ASSIGNMENT_OPCODE_MULTIPLICATION_INTEGERS:
+		top--;
+		setProgramValueNumber(top, top->mNumber * top[1].mNumber);
+		break;
+	case MUGEN_ASSIGNMENT_OPCODE_ADDITION_FLOATS:
+		top--;
+		setProgramValueFloat(top, getProgramScalarFloat(top) + getProgramScalarFloat(top + 1));
+		break;
+	case MUGEN_ASSIGNMENT_OPCODE_SUBTRACTION_FLOATS:
+		top--;
+		setProgramValueFloat(top, getProgramScalarFloat(top) - getProgramScalarFloat(top + 1));
+		break;
+	case MUGEN_ASSIGNMENT_OPCODE_MULTIPLICATION_FLOATS:
+		top--;
+		setProgramValueFloat(top, getProgramScalarFloat(top) * getProgramScalarFloat(top + 1));
+		break;
+	case MUGEN_ASSIGNMENT_OPCODE_DIVISION_FLOATS:
+		top--;
+		setProgramValueFloat(top, getProgramScalarFloat(top) / getProgramScalarFloat(top + 1));
+		break;
+	case MUGEN_ASSIGNMENT_OPCODE_COMPARISON:
+	case MUGEN_ASSIGNMENT_OPCODE_INEQUALITY:
+	case MUGEN_ASSIGNMENT_OPCODE_LESS:
+	case MUGEN_ASSIGNMENT_OPCODE_LESS_OR_EQUAL:
+	case MUGEN_ASSIGNMENT_OPCODE_GREATER:
+	case MUGEN_ASSIGNMENT_OPCODE_GREATER_OR_EQUAL:
+		top--;
+		evaluateProgramComparison(top + 1, top, tOpcode);
+		break;
+	case MUGEN_ASSIGNMENT_OPCODE_COMPARISON_INTEGERS:
+		top--;
+		setProgramValueBoolean(top, top[1].mNumber == top->mNumber);
+		break;
+	case MUGEN_ASSIGNMENT_OPCODE_INEQUALITY_INTEGERS:
+		top--;
+		setProgramValueBoolean(top, top[1].mNumber != top->mNumber);
+		break;
+	case MUGEN_ASSIGNMENT_OPCODE_LESS_INTEGERS:
+		top--;
+		setProgramValueBoolean(top, top[1].mNumber < top->mNumber);
+		break;
+	case MUGEN_ASSIGNMENT_OPCODE_LESS_OR_EQUAL_INTEGERS:
+		top--;
+		setProgramValueBoolean(top, top[1].mNumber <= top->mNumber);
+		break;
+	case MUGEN_ASSIGNMENT_OPCODE_GREATER_INTEGERS:
+		top--;
+		setProgramValueBoolean(top, top[1].mNumber > top->mNumber);
+		break;
+	case MUGEN_ASSIGNMENT_OPCODE_GREATER_OR_EQUAL_INTEGERS:
+		top--;
+		setProgramValueBoolean(top, top[1].mNumber >= top->mNumber);
+		break;
+	case MUGEN_ASSIGNMENT_OPCODE_COMPARISON_FLOATS:
+		top--;
+		setProgramValueBoolean(top, getProgramScalarFloat(top + 1) == getProgramScalarFloat(top));
+		break;
+	case MUGEN_ASSIGNMENT_OPCODE_INEQUALITY_FLOATS:
+		top--;
+		setProgramValueBoolean(top, getProgramScalarFloat(top + 1) != getProgramScalarFloat(top));
+		break;
+	case MUGEN_ASSIGNMENT_OPCODE_LESS_FLOATS:
+		top--;
+		setProgramValueBoolean(top, getProgramScalarFloat(top + 1) < getProgramScalarFloat(top));
+		break;
+	case MUGEN_ASSIGNMENT_OPCODE_LESS_OR_EQUAL_FLOATS:
+		top--;
+		setProgramValueBoolean(top, getProgramScalarFloat(top + 1) <= getProgramScalarFloat(top));
+		break;
+	case MUGEN_ASSIGNMENT_OPCODE_GREATER_FLOATS:
+		top--;
+		setProgramValueBoolean(top, getProgramScalarFloat(top + 1) > getProgramScalarFloat(top));
+		break;
+	case MUGEN_ASSIGNMENT_OPCODE_GREATER_OR_EQUAL_FLOATS:
+		top--;
+		setProgramValueBoolean(top, getProgramScalarFloat(top + 1) >= getProgramScalarFloat(top));
+		break;
+	case MUGEN_ASSIGNMENT_OPCODE_COMPARISON_INTEGER_CONSTANT:
+		setProgramValueBoolean(top, top->mNumber == tInstruction->mNumber);
+		break;
+	case MUGEN_ASSIGNMENT_OPCODE_INEQUALITY_INTEGER_CONSTANT:
+		setProgramValueBoolean(top, top->mNumber != tInstruction->mNumber);
+		break;
+	case MUGEN_ASSIGNMENT_OPCODE_LESS_INTEGER_CONSTANT:
+		setProgramValueBoolean(top, top->mNumber < tInstruction->mNumber);
+		break;
+	case MUGEN_ASSIGNMENT_OPCODE_LESS_OR_EQUAL_INTEGER_CONSTANT:
+		setProgramValueBoolean(top, top->mNumber <= tInstruction->mNumber);
+		break;
+	case MUGEN_ASSIGNMENT_OPCODE_GREATER_INTEGER_CONSTANT:
+		setProgramValueBoolean(top, top->mNumber > tInstruction->mNumber);
+		break;
+	case MUGEN_ASSIGNMENT_OPCODE_GREATER_OR_EQUAL_INTEGER_CONSTANT:
+		setProgramValueBoolean(top, top->mNumber >= tInstruction->mNumber);
+		break;
+	case MUGEN_ASSIGNMENT_OPCODE_COMPARISON_FLOAT_CONSTANT:
+		setProgramValueBoolean(top, getProgramScalarFloat(top) == tInstruction->mFloat);
+		break;
+	case MUGEN_ASSIGNMENT_OPCODE_INEQUALITY_FLOAT_CONSTANT:
+		setProgramValueBoolean(top, getProgramScalarFloat(top) != tInstruction->mFloat);
+		break;
+	case MUGEN_ASSIGNMENT_OPCODE_LESS_FLOAT_CONSTANT:
+		setProgramValueBoolean(top, getProgramScalarFloat(top) < tInstruction->mFloat);
+		break;
+	case MUGEN_ASSIGNMENT_OPCODE_LESS_OR_EQUAL_FLOAT_CONSTANT:
+		setProgramValueBoolean(top, getProgramScalarFloat(top) <= tInstruction->mFloat);
+		break;
+	case MUGEN_ASSIGNMENT_OPCODE_GREATER_FLOAT_CONSTANT:
+		setProgramValueBoolean(top, getProgramScalarFloat(top) > tInstruction->mFloat);
+		break;
+	case MUGEN_ASSIGNMENT_OPCODE_GREATER_OR_EQUAL_FLOAT_CONSTANT:
+		setProgramValueBoolean(top, getProgramScalarFloat(top) >= tInstruction->mFloat);
+		break;
+	default:
+		break;
+	}
+	return 0;
+}
+
+static AssignmentProgramValue runAssignmentProgram(DreamMugenProgramAssignment* tProgram, DreamPlayer* tPlayer) {
+	AssignmentProgramValue stack[ASSIGNMENT_PROGRAM_STACK_SIZE];
+	AssignmentProgramValue* top = stack - 1;
+	const AssignmentInstruction* instructions = (const AssignmentInstruction*)tProgram->mInstructions;
+	const AssignmentInstruction* instruction = instructions;
+
+	while (instruction->mOpcode != MUGEN_ASSIGNMENT_OPCODE_RETURN) {
+		if (executeAssignmentInstruction(instruction->mOpcode, instruction, top, tPlayer)) instruction = instructions + instruction->mNumber;
+		else instruction++;
+	}
+	return *top;
+}
+
+static AssignmentReturnValue* evaluateProgramAssignment(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer, int* tIsStatic) {
+	*tIsStatic = 0;
+	AssignmentProgramValue ret = runAssignmentProgram((DreamMugenProgramAssignment*)*tAssignment, tPlayer);
+	return makeAssignmentReturnFromProgramValue(&ret);
+}
+
+typedef AssignmentReturnValue*(AssignmentEvaluationFunction)(DreamMugenAssignment**, DreamPlayer*, int*);
+
+static void* gEvaluationFunctions[] = {
+	(void*)evaluateBooleanAssignment,
+	(void*)evaluateAndAssignment,
+	(void*)evaluateOrAssignment,
+	(void*)evaluateComparisonAssignment,
+	(void*)evaluateInequalityAssignment,
+	(void*)evaluateLessOrEqualAssignment,
+	(void*)evaluateGreaterOrEqualAssignment,
+	(void*)evaluateVectorAssignment,
+	(void*)evaluateRangeAssignment,
+	(void*)evaluateBooleanAssignment,
+	(void*)evaluateNegationAssignment,
+	(void*)evaluateVariableAssignment,
+	(void*)evaluateRawVariableAssignment,
+	(void*)evaluateNumberAssignment,
+	(void*)evaluateFloatAssignment,
+	(void*)evaluateStringAssignment,
+	(void*)evaluateArrayAssignment,
+	(void*)evaluateLessAssignment,
+	(void*)evaluateGreaterAssignment,
+	(void*)evaluateAdditionAssignment,
+	(void*)evaluateMultiplicationAssignment,
+	(void*)evaluateModuloAssignment,
+	(void*)evaluateSubtractionAssignment,
+	(void*)evaluateSetVariableAssignment,
+	(void*)evaluateDivisionAssignment,
+	(void*)evaluateExponentiationAssignment,
+	(void*)evaluateUnaryMinusAssignment,
+	(void*)evaluateOperatorArgumentAssignment,
+	(void*)evaluateBitwiseAndAssignment,
+	(void*)evaluateBitwiseOrAssignment,
+	(void*)evaluateStaticAssignment,
+	(void*)evaluateProgramAssignment,
+	(void*)evaluateTriggerAssignment,
+	(void*)evaluateRedirectAssignment,
+	(void*)evaluateFlagsAssignment,
+	(void*)evaluateConditionalAssignment,
+};
+
+
+static AssignmentReturnValue* evaluateAssignmentInternal(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer, int* oIsStatic) {
+	*oIsStatic = 1;
+	
+	if (!tAssignment || !(*tAssignment)) {
+		logWarning("Invalid assignment. Defaulting to bottom.");
+		return makeBottomAssignmentReturn(); 
+	}
+
+
+	if ((*tAssignment)->mType >= MUGEN_ASSIGNMENT_TYPE_AMOUNT) {
+		logWarningFormat("Unidentified assignment type %d. Returning bottom.", (*tAssignment)->mType);
+		return makeBottomAssignmentReturn();
+	}
+
+	AssignmentEvaluationFunction* func = (AssignmentEvaluationFunction*)gEvaluationFunctions[(*tAssignment)->mType];
+	return func(tAssignment, tPlayer, oIsStatic);
+}
+
+static AssignmentProgramValue evaluateAssignmentStart(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer) {
+	gAssignmentEvaluator.mFreePointer = 0;
+	if (gAssignmentEvaluator.mStrings.size() >= MAXIMUM_INTERNED_STRING_AMOUNT) {
+		clearEvaluationStrings();
+		gAssignmentEvaluator.mStaticGeneration++;
+		gAssignmentMemo.mGeneration++;
+	}
+
+	if ((*tAssignment)->mType != MUGEN_ASSIGNMENT_TYPE_PROGRAM) {
+		AssignmentProgramValue ret;
+		int isStatic;
+		setProgramValueFromReturn(&ret, evaluateAssignmentInternal(tAssignment, tPlayer, &isStatic));
+		return ret;
+	}
+	return runAssignmentProgram((DreamMugenProgramAssignment*)*tAssignment, tPlayer);
+}
+
+static AssignmentReturnValue* timeStoryFunction(DreamPlayer* tPlayer) { return makeNumberAssignmentReturn(getDolmexicaStoryTimeInState((StoryInstance*)tPlayer)); }
+
+static const AssignmentSymbol gStoryVariableSymbols[] = {
+	{ "time", (void*)timeStoryFunction },
+	{ "random", (void*)randomFunction },
+	{ "platform", (void*)platformFunction },
+};
+
+//static AssignmentReturnValue* movementDownFrictionThresholdFunction(DreamPlayer* tPlayer) { return makeFloatAssignmentReturn(getPlayerLyingDownFrictionThreshold(tPlayer)); }
+
+static AssignmentReturnValue* evaluateAnimTimeStoryArrayAssignment(AssignmentReturnValue* tIndex, StoryInstance* tInstance, int* tIsStatic) {
 	int id = convertAssignmentReturnToNumber(tIndex);
 	*tIsStatic = 0;
 	return makeNumberAssignmentReturn(getDolmexicaStoryAnimationTimeLeft(tInstance, id));
@@ -2836,37 +4061,35 @@ static AssignmentReturnValue* parentVarStoryFunction(DreamMugenAssignment** tInd
 static AssignmentReturnValue* numHelperStoryFunction(DreamMugenAssignment** tIndexAssignment, DreamPlayer* tPlayer, int* tIsStatic) { return evaluateNumHelperStoryArrayAssignment(evaluateAssignmentDependency(tIndexAssignment, tPlayer, tIsStatic), tIsStatic); }
 static AssignmentReturnValue* nameIDStoryFunction(DreamMugenAssignment** tIndexAssignment, DreamPlayer* tPlayer, int* tIsStatic) { return evaluateNameIDStoryArrayAssignment(evaluateAssignmentDependency(tIndexAssignment, tPlayer, tIsStatic), (StoryInstance*)tPlayer, tIsStatic); }
 
-static void setupStoryArrayAssignments() {
-	gVariableHandler.mArrays.clear();
-
-	gVariableHandler.mArrays["animtime"] = animTimeStoryFunction;
-	gVariableHandler.mArrays["rootanimtime"] = rootAnimTimeStoryFunction;
-	gVariableHandler.mArrays["x"] = animPosXStoryFunction;
-	gVariableHandler.mArrays["charx"] = charPosXStoryFunction;
-	gVariableHandler.mArrays["rootcharx"] = rootCharPosXStoryFunction;
-	gVariableHandler.mArrays["roottextx"] = rootTextPosXStoryFunction;
-	gVariableHandler.mArrays["roottexty"] = rootTextPosYStoryFunction;
-	gVariableHandler.mArrays["roottextvisible"] = rootTextVisibleStoryFunction;
-	gVariableHandler.mArrays["ifelse"] = ifElseFunction;
-	gVariableHandler.mArrays["charanim"] = charAnimStoryFunction;
-	gVariableHandler.mArrays["rootcharanim"] = rootCharAnimStoryFunction;
-	gVariableHandler.mArrays["charanimtime"] = charAnimTimeStoryFunction;
-	gVariableHandler.mArrays["rootcharanimtime"] = rootCharAnimTimeStoryFunction;
-	gVariableHandler.mArrays["svar"] = sVarStoryFunction;
-	gVariableHandler.mArrays["fvar"] = fVarStoryFunction;
-	gVariableHandler.mArrays["var"] = varStoryFunction;
-	gVariableHandler.mArrays["globalvar"] = globalVarStoryFunction;
-	gVariableHandler.mArrays["globalfvar"] = globalFVarStoryFunction;
-	gVariableHandler.mArrays["globalsvar"] = globalSVarStoryFunction;
-	gVariableHandler.mArrays["rootsvar"] = rootSVarStoryFunction;
-	gVariableHandler.mArrays["rootfvar"] = rootFVarStoryFunction;
-	gVariableHandler.mArrays["rootvar"] = rootVarStoryFunction;
-	gVariableHandler.mArrays["parentsvar"] = parentSVarStoryFunction;
-	gVariableHandler.mArrays["parentfvar"] = parentFVarStoryFunction;
-	gVariableHandler.mArrays["parentvar"] = parentVarStoryFunction;
-	gVariableHandler.mArrays["numhelper"] = numHelperStoryFunction;
-	gVariableHandler.mArrays["nameid"] = nameIDStoryFunction;
-}
+static const AssignmentSymbol gStoryArraySymbols[] = {
+	{ "animtime", (void*)animTimeStoryFunction },
+	{ "rootanimtime", (void*)rootAnimTimeStoryFunction },
+	{ "x", (void*)animPosXStoryFunction },
+	{ "charx", (void*)charPosXStoryFunction },
+	{ "rootcharx", (void*)rootCharPosXStoryFunction },
+	{ "roottextx", (void*)rootTextPosXStoryFunction },
+	{ "roottexty", (void*)rootTextPosYStoryFunction },
+	{ "roottextvisible", (void*)rootTextVisibleStoryFunction },
+	{ "ifelse", (void*)ifElseFunction },
+	{ "charanim", (void*)charAnimStoryFunction },
+	{ "rootcharanim", (void*)rootCharAnimStoryFunction },
+	{ "charanimtime", (void*)charAnimTimeStoryFunction },
+	{ "rootcharanimtime", (void*)rootCharAnimTimeStoryFunction },
+	{ "svar", (void*)sVarStoryFunction },
+	{ "fvar", (void*)fVarStoryFunction },
+	{ "var", (void*)varStoryFunction },
+	{ "globalvar", (void*)globalVarStoryFunction },
+	{ "globalfvar", (void*)globalFVarStoryFunction },
+	{ "globalsvar", (void*)globalSVarStoryFunction },
+	{ "rootsvar", (void*)rootSVarStoryFunction },
+	{ "rootfvar", (void*)rootFVarStoryFunction },
+	{ "rootvar", (void*)rootVarStoryFunction },
+	{ "parentsvar", (void*)parentSVarStoryFunction },
+	{ "parentfvar", (void*)parentFVarStoryFunction },
+	{ "parentvar", (void*)parentVarStoryFunction },
+	{ "numhelper", (void*)numHelperStoryFunction },
+	{ "nameid", (void*)nameIDStoryFunction },
+};
 
 static AssignmentReturnValue* evaluateStoryCommandAssignment(AssignmentReturnValue* tCommand, int* tIsStatic) {
 	string cstring;
@@ -2880,54 +4103,367 @@ static AssignmentReturnValue* evaluateStoryCommandAssignment(AssignmentReturnVal
 
 static AssignmentReturnValue* commandComparisonStoryFunction(AssignmentReturnValue* b, DreamPlayer* /*tPlayer*/, int* tIsStatic) { return evaluateStoryCommandAssignment(b, tIsStatic); }
 
-static void setupStoryComparisons() {
-	gVariableHandler.mComparisons.clear();
+static const AssignmentSymbol gStoryComparisonSymbols[] = {
+	{ "storycommand", (void*)commandComparisonStoryFunction },
+};
+
+static AssignmentSymbolTables gFightAssignmentSymbols;
+static AssignmentSymbolTables gStoryAssignmentSymbols;
 
-	gVariableHandler.mComparisons["storycommand"] = commandComparisonStoryFunction;
+static void buildAssignmentSymbolTable(AssignmentSymbolTable* oTable, const AssignmentSymbol* tSymbols, int tAmount);
 
-	gVariableHandler.mOrdinals.clear();
+#define ASSIGNMENT_SYMBOL_AMOUNT(x) int(sizeof(x) / sizeof(x[0]))
+
+static void setupFightAssignmentSymbols() {
+	if (!gFightAssignmentSymbols.mVariables.mAmount) {
+		buildAssignmentSymbolTable(&gFightAssignmentSymbols.mVariables, gFightVariableSymbols, ASSIGNMENT_SYMBOL_AMOUNT(gFightVariableSymbols));
+		buildAssignmentSymbolTable(&gFightAssignmentSymbols.mArrays, gFightArraySymbols, ASSIGNMENT_SYMBOL_AMOUNT(gFightArraySymbols));
+		buildAssignmentSymbolTable(&gFightAssignmentSymbols.mComparisons, gFightComparisonSymbols, ASSIGNMENT_SYMBOL_AMOUNT(gFightComparisonSymbols));
+		buildAssignmentSymbolTable(&gFightAssignmentSymbols.mOrdinals, gFightOrdinalSymbols, ASSIGNMENT_SYMBOL_AMOUNT(gFightOrdinalSymbols));
+	}
+	gVariableHandler.mSymbols = &gFightAssignmentSymbols;
+}
+
+static void setupStoryAssignmentSymbols() {
+	if (!gStoryAssignmentSymbols.mVariables.mAmount) {
+		buildAssignmentSymbolTable(&gStoryAssignmentSymbols.mVariables, gStoryVariableSymbols, ASSIGNMENT_SYMBOL_AMOUNT(gStoryVariableSymbols));
+		buildAssignmentSymbolTable(&gStoryAssignmentSymbols.mArrays, gStoryArraySymbols, ASSIGNMENT_SYMBOL_AMOUNT(gStoryArraySymbols));
+		buildAssignmentSymbolTable(&gStoryAssignmentSymbols.mComparisons, gStoryComparisonSymbols, ASSIGNMENT_SYMBOL_AMOUNT(gStoryComparisonSymbols));
+	}
+	gVariableHandler.mSymbols = &gStoryAssignmentSymbols;
 }
 
 void setupDreamStoryAssignmentEvaluator()
 {
 	initEvaluationStack();
-	setupStoryVariableAssignments();
-	setupStoryArrayAssignments();
-	setupStoryComparisons();
+	setupAssignmentProgramTypes();
+	setupStoryAssignmentSymbols();
+	gVariableHandler.mMemoSymbols.clear();
 }
 
 void shutdownDreamAssignmentEvaluator()
 {
-	gVariableHandler.mComparisons.clear();
-	gVariableHandler.mArrays.clear();
-	gVariableHandler.mVariables.clear();
+	clearEvaluationStack();
+	gVariableHandler.mSymbols = NULL;
+	gVariableHandler.mMemoSymbols.clear();
+}
+
+void setDreamAssignmentMemoizationActive(int tIsActive)
+{
+	gAssignmentMemo.mIsActive = tIsActive;
+	gAssignmentMemo.mGeneration++;
+}
+
+int isDreamAssignmentMemoizationActive()
+{
+	return gAssignmentMemo.mIsActive;
+}
+
+void beginDreamAssignmentMemoScope()
+{
+	gAssignmentMemo.mScopeDepth++;
+	gAssignmentMemo.mGeneration++;
+}
+
+void endDreamAssignmentMemoScope()
+{
+	gAssignmentMemo.mScopeDepth--;
+	gAssignmentMemo.mGeneration++;
+}
+
+void getDreamAssignmentMemoStatistics(uint32_t* oHits, uint32_t* oMisses)
+{
+	*oHits = gAssignmentMemo.mHits;
+	*oMisses = gAssignmentMemo.mMisses;
+}
+
+void resetDreamAssignmentMemoStatistics()
+{
+	gAssignmentMemo.mHits = 0;
+	gAssignmentMemo.mMisses = 0;
+}
+
+// hash and displace: buckets are placed largest first, each searching for a seed that moves all its symbols into free slots
+static int findAssignmentSymbolSeeds(const AssignmentSymbol* tSymbols, int tAmount, uint32_t tBucketAmount, uint32_t tSlotAmount, vector<uint16_t>& oSeeds, vector<uint16_t>& oSlots) {
+	vector<vector<int> > buckets(tBucketAmount);
+	for (int i = 0; i < tAmount; i++) {
+		buckets[hashAssignmentSymbolName(tSymbols[i].mName, 0) & (tBucketAmount - 1)].push_back(i);
+	}
+	vector<int> order;
+	for (uint32_t i = 0; i < tBucketAmount; i++) {
+		order.push_back(int(i));
+	}
+	stable_sort(order.begin(), order.end(), [&buckets](int a, int b) { return buckets[a].size() > buckets[b].size(); });
+
+	oSeeds.assign(tBucketAmount, 0);
+	oSlots.assign(tSlotAmount, ASSIGNMENT_SYMBOL_EMPTY_SLOT);
+	vector<uint32_t> slots;
+	for (int bucket : order) {
+		if (buckets[bucket].empty()) break;
+
+		uint32_t seed = 1;
+		for (; seed < ASSIGNMENT_SYMBOL_EMPTY_SLOT; seed++) {
+			slots.clear();
+			for (int i : buckets[bucket]) {
+				uint32_t slot = hashAssignmentSymbolName(tSymbols[i].mName, seed) & (tSlotAmount - 1);
+				if (oSlots[slot] != ASSIGNMENT_SYMBOL_EMPTY_SLOT || find(slots.begin(), slots.end(), slot) != slots.end()) break;
+				slots.push_back(slot);
+			}
+			if (slots.size() == buckets[bucket].size()) break;
+		}
+		if (seed == ASSIGNMENT_SYMBOL_EMPTY_SLOT) return 0;
+
+		oSeeds[bucket] = uint16_t(seed);
+		for (size_t i = 0; i < slots.size(); i++) {
+			oSlots[slots[i]] = uint16_t(buckets[bucket][i]);
+		}
+	}
+	return 1;
+}
+
+static uint32_t getAssignmentSymbolTableSize(int tMinimum) {
+	uint32_t size = 1;
+	while (size < uint32_t(tMinimum)) size <<= 1;
+	return size;
+}
+
+static void buildAssignmentSymbolTable(AssignmentSymbolTable* oTable, const AssignmentSymbol* tSymbols, int tAmount) {
+	uint32_t bucketAmount = getAssignmentSymbolTableSize(max(1, tAmount / 4));
+	uint32_t slotAmount = getAssignmentSymbolTableSize(tAmount);
+	while (!findAssignmentSymbolSeeds(tSymbols, tAmount, bucketAmount, slotAmount, oTable->mSeeds, oTable->mSlots)) {
+		slotAmount <<= 1;
+		if (slotAmount > ASSIGNMENT_SYMBOL_EMPTY_SLOT) {
+			logErrorFormat("Unable to build assignment symbol table for %d symbols.", tAmount);
+			recoverFromError();
+		}
+	}
+	oTable->mSymbols = tSymbols;
+	oTable->mAmount = uint16_t(tAmount);
+	oTable->mBucketMask = uint16_t(bucketAmount - 1);
+	oTable->mSlotMask = uint16_t(slotAmount - 1);
+
+	for (int i = 0; i < tAmount; i++) {
+		if (findAssignmentSymbolIndex(oTable, tSymbols[i].mName) != i) {
+			logErrorFormat("Assignment symbol %s does not resolve, check the symbol arrays for duplicates.", tSymbols[i].mName);
+			recoverFromError();
+		}
+	}
+}
+
+int isDreamAssignmentFreeOfSideEffects(DreamMugenAssignment* tAssignment)
+{
+	switch (tAssignment->mType) {
+	case MUGEN_ASSIGNMENT_TYPE_SET_VARIABLE:
+		return 0;
+	case MUGEN_ASSIGNMENT_TYPE_VARIABLE:
+		return ((DreamMugenVariableAssignment*)tAssignment)->mFunc != (void*)randomFunction;
+	case MUGEN_ASSIGNMENT_TYPE_UNARY_MINUS:
+	case MUGEN_ASSIGNMENT_TYPE_NEGATION:
+		return isDreamAssignmentFreeOfSideEffects(((DreamMugenDependOnOneAssignment*)tAssignment)->a);
+	case MUGEN_ASSIGNMENT_TYPE_AND:
+	case MUGEN_ASSIGNMENT_TYPE_OR:
+	case MUGEN_ASSIGNMENT_TYPE_COMPARISON:
+	case MUGEN_ASSIGNMENT_TYPE_INEQUALITY:
+	case MUGEN_ASSIGNMENT_TYPE_LESS_OR_EQUAL:
+	case MUGEN_ASSIGNMENT_TYPE_GREATER_OR_EQUAL:
+	case MUGEN_ASSIGNMENT_TYPE_EXPONENTIATION:
+	case MUGEN_ASSIGNMENT_TYPE_BITWISE_AND:
+	case MUGEN_ASSIGNMENT_TYPE_BITWISE_OR:
+	case MUGEN_ASSIGNMENT_TYPE_LESS:
+	case MUGEN_ASSIGNMENT_TYPE_GREATER:
+	case MUGEN_ASSIGNMENT_TYPE_ADDITION:
+	case MUGEN_ASSIGNMENT_TYPE_MULTIPLICATION:
+	case MUGEN_ASSIGNMENT_TYPE_MODULO:
+	case MUGEN_ASSIGNMENT_TYPE_SUBTRACTION:
+	case MUGEN_ASSIGNMENT_TYPE_DIVISION:
+	case MUGEN_ASSIGNMENT_TYPE_VECTOR:
+	case MUGEN_ASSIGNMENT_TYPE_OPERATOR_ARGUMENT:
+	{
+		DreamMugenDependOnTwoAssignment* e = (DreamMugenDependOnTwoAssignment*)tAssignment;
+		return isDreamAssignmentFreeOfSideEffects(e->a) && isDreamAssignmentFreeOfSideEffects(e->b);
+	}
+	case MUGEN_ASSIGNMENT_TYPE_ARRAY:
+		return isDreamAssignmentFreeOfSideEffects(((DreamMugenArrayAssignment*)tAssignment)->mIndex);
+	case MUGEN_ASSIGNMENT_TYPE_RANGE:
+		return isDreamAssignmentFreeOfSideEffects(((DreamMugenRangeAssignment*)tAssignment)->a);
+	case MUGEN_ASSIGNMENT_TYPE_REDIRECT:
+	{
+		DreamMugenRedirectAssignment* e = (DreamMugenRedirectAssignment*)tAssignment;
+		return !e->mIndex || isDreamAssignmentFreeOfSideEffects(e->mIndex);
+	}
+	case MUGEN_ASSIGNMENT_TYPE_CONDITIONAL:
+	{
+		DreamMugenConditionalAssignment* e = (DreamMugenConditionalAssignment*)tAssignment;
+		return isDreamAssignmentFreeOfSideEffects(e->mCondition) && isDreamAssignmentFreeOfSideEffects(e->mTrue) && isDreamAssignmentFreeOfSideEffects(e->mFalse);
+	}
+	case MUGEN_ASSIGNMENT_TYPE_STATIC:
+		return isDreamAssignmentFreeOfSideEffects(((DreamMugenStaticAssignment*)tAssignment)->mOriginal);
+	case MUGEN_ASSIGNMENT_TYPE_PROGRAM:
+		return isDreamAssignmentFreeOfSideEffects(((DreamMugenProgramAssignment*)tAssignment)->mTree);
+	default:
+		return 1;
+	}
+}
+
+static int doesAssignmentContainRedirect(DreamMugenAssignment* tAssignment) {
+	uint8_t target;
+	switch (tAssignment->mType) {
+	case MUGEN_ASSIGNMENT_TYPE_REDIRECT:
+		return 1;
+	case MUGEN_ASSIGNMENT_TYPE_RAW_VARIABLE:
+		return resolveMugenAssignmentRedirect(tAssignment, &target);
+	case MUGEN_ASSIGNMENT_TYPE_UNARY_MINUS:
+	case MUGEN_ASSIGNMENT_TYPE_NEGATION:
+		return doesAssignmentContainRedirect(((DreamMugenDependOnOneAssignment*)tAssignment)->a);
+	case MUGEN_ASSIGNMENT_TYPE_AND:
+	case MUGEN_ASSIGNMENT_TYPE_OR:
+	case MUGEN_ASSIGNMENT_TYPE_COMPARISON:
+	case MUGEN_ASSIGNMENT_TYPE_INEQUALITY:
+	case MUGEN_ASSIGNMENT_TYPE_LESS_OR_EQUAL:
+	case MUGEN_ASSIGNMENT_TYPE_GREATER_OR_EQUAL:
+	case MUGEN_ASSIGNMENT_TYPE_EXPONENTIATION:
+	case MUGEN_ASSIGNMENT_TYPE_BITWISE_AND:
+	case MUGEN_ASSIGNMENT_TYPE_BITWISE_OR:
+	case MUGEN_ASSIGNMENT_TYPE_LESS:
+	case MUGEN_ASSIGNMENT_TYPE_GREATER:
+	case MUGEN_ASSIGNMENT_TYPE_ADDITION:
+	case MUGEN_ASSIGNMENT_TYPE_MULTIPLICATION:
+	case MUGEN_ASSIGNMENT_TYPE_MODULO:
+	case MUGEN_ASSIGNMENT_TYPE_SUBTRACTION:
+	case MUGEN_ASSIGNMENT_TYPE_DIVISION:
+	case MUGEN_ASSIGNMENT_TYPE_VECTOR:
+	case MUGEN_ASSIGNMENT_TYPE_OPERATOR_ARGUMENT:
+	case MUGEN_ASSIGNMENT_TYPE_SET_VARIABLE:
+	{
+		DreamMugenDependOnTwoAssignment* e = (DreamMugenDependOnTwoAssignment*)tAssignment;
+		return doesAssignmentContainRedirect(e->a) || doesAssignmentContainRedirect(e->b);
+	}
+	case MUGEN_ASSIGNMENT_TYPE_ARRAY:
+		return resolveMugenAssignmentRedirect(tAssignment, &target) || doesAssignmentContainRedirect(((DreamMugenArrayAssignment*)tAssignment)->mIndex);
+	case MUGEN_ASSIGNMENT_TYPE_RANGE:
+		return doesAssignmentContainRedirect(((DreamMugenRangeAssignment*)tAssignment)->a);
+	case MUGEN_ASSIGNMENT_TYPE_CONDITIONAL:
+	{
+		DreamMugenConditionalAssignment* e = (DreamMugenConditionalAssignment*)tAssignment;
+		return doesAssignmentContainRedirect(e->mCondition) || doesAssignmentContainRedirect(e->mTrue) || doesAssignmentContainRedirect(e->mFalse);
+	}
+	case MUGEN_ASSIGNMENT_TYPE_STATIC:
+		return doesAssignmentContainRedirect(((DreamMugenStaticAssignment*)tAssignment)->mOriginal);
+	case MUGEN_ASSIGNMENT_TYPE_PROGRAM:
+		return doesAssignmentContainRedirect(((DreamMugenProgramAssignment*)tAssignment)->mTree);
+	default:
+		return 0;
+	}
+}
+
+// redirects usually rely on an earlier numhelper, ishelper or numtarget conjunct, so they keep their position
+int isDreamAssignmentReorderable(DreamMugenAssignment* tAssignment)
+{
+	return isDreamAssignmentFreeOfSideEffects(tAssignment) && !doesAssignmentContainRedirect(tAssignment);
+}
+
+static void checkAssignmentTypeOperands(DreamMugenDependOnTwoAssignment* tAssignment, const char* tText, const char* tOperation) {
+	AssignmentProgramType a = inferAssignmentProgramType(tAssignment->a);
+	AssignmentProgramType b = inferAssignmentProgramType(tAssignment->b);
+	if (a == ASSIGNMENT_PROGRAM_TYPE_STRING || b == ASSIGNMENT_PROGRAM_TYPE_STRING) {
+		logWarningFormat("Type error in assignment %s: %s with a non-numerical operand.", tText, tOperation);
+	}
+}
+
+static void checkAssignmentTypeEquality(DreamMugenDependOnTwoAssignment* tAssignment, const char* tText) {
+	if (isAssignmentProgramTriggerComparison(tAssignment->a)) return;
+
+	AssignmentProgramType a = inferAssignmentProgramType(tAssignment->a);
+	AssignmentProgramType b = inferAssignmentProgramType(tAssignment->b);
+	if ((a == ASSIGNMENT_PROGRAM_TYPE_STRING && isAssignmentProgramTypeNumerical(b)) || (isAssignmentProgramTypeNumerical(a) && b == ASSIGNMENT_PROGRAM_TYPE_STRING)) {
+		logWarningFormat("Type error in assignment %s: comparison of a number with a non-numerical operand.", tText);
+	}
+}
+
+void checkDreamAssignmentTypes(DreamMugenAssignment* tAssignment, const char* tText)
+{
+	switch (tAssignment->mType) {
+	case MUGEN_ASSIGNMENT_TYPE_UNARY_MINUS:
+	case MUGEN_ASSIGNMENT_TYPE_NEGATION:
+		checkDreamAssignmentTypes(((DreamMugenDependOnOneAssignment*)tAssignment)->a, tText);
+		break;
+	case MUGEN_ASSIGNMENT_TYPE_ADDITION:
+	case MUGEN_ASSIGNMENT_TYPE_SUBTRACTION:
+	case MUGEN_ASSIGNMENT_TYPE_MULTIPLICATION:
+	case MUGEN_ASSIGNMENT_TYPE_DIVISION:
+	case MUGEN_ASSIGNMENT_TYPE_MODULO:
+	case MUGEN_ASSIGNMENT_TYPE_EXPONENTIATION:
+	case MUGEN_ASSIGNMENT_TYPE_BITWISE_AND:
+	case MUGEN_ASSIGNMENT_TYPE_BITWISE_OR:
+		checkAssignmentTypeOperands((DreamMugenDependOnTwoAssignment*)tAssignment, tText, "arithmetic");
+		checkDreamAssignmentTypes(((DreamMugenDependOnTwoAssignment*)tAssignment)->a, tText);
+		checkDreamAssignmentTypes(((DreamMugenDependOnTwoAssignment*)tAssignment)->b, tText);
+		break;
+	case MUGEN_ASSIGNMENT_TYPE_LESS:
+	case MUGEN_ASSIGNMENT_TYPE_LESS_OR_EQUAL:
+	case MUGEN_ASSIGNMENT_TYPE_GREATER:
+	case MUGEN_ASSIGNMENT_TYPE_GREATER_OR_EQUAL:
+		if (!isAssignmentProgramTriggerComparison(((DreamMugenDependOnTwoAssignment*)tAssignment)->a)) {
+			checkAssignmentTypeOperands((DreamMugenDependOnTwoAssignment*)tAssignment, tText, "ordering comparison");
+		}
+		checkDreamAssignmentTypes(((DreamMugenDependOnTwoAssignment*)tAssignment)->a, tText);
+		checkDreamAssignmentTypes(((DreamMugenDependOnTwoAssignment*)tAssignment)->b, tText);
+		break;
+	case MUGEN_ASSIGNMENT_TYPE_COMPARISON:
+	case MUGEN_ASSIGNMENT_TYPE_INEQUALITY:
+		checkAssignmentTypeEquality((DreamMugenDependOnTwoAssignment*)tAssignment, tText);
+		checkDreamAssignmentTypes(((DreamMugenDependOnTwoAssignment*)tAssignment)->a, tText);
+		checkDreamAssignmentTypes(((DreamMugenDependOnTwoAssignment*)tAssignment)->b, tText);
+		break;
+	case MUGEN_ASSIGNMENT_TYPE_AND:
+	case MUGEN_ASSIGNMENT_TYPE_OR:
+	case MUGEN_ASSIGNMENT_TYPE_VECTOR:
+	case MUGEN_ASSIGNMENT_TYPE_SET_VARIABLE:
+	case MUGEN_ASSIGNMENT_TYPE_OPERATOR_ARGUMENT:
+		checkDreamAssignmentTypes(((DreamMugenDependOnTwoAssignment*)tAssignment)->a, tText);
+		checkDreamAssignmentTypes(((DreamMugenDependOnTwoAssignment*)tAssignment)->b, tText);
+		break;
+	case MUGEN_ASSIGNMENT_TYPE_ARRAY:
+		checkDreamAssignmentTypes(((DreamMugenArrayAssignment*)tAssignment)->mIndex, tText);
+		break;
+	case MUGEN_ASSIGNMENT_TYPE_RANGE:
+		checkDreamAssignmentTypes(((DreamMugenRangeAssignment*)tAssignment)->a, tText);
+		break;
+	case MUGEN_ASSIGNMENT_TYPE_CONDITIONAL:
+	{
+		DreamMugenConditionalAssignment* e = (DreamMugenConditionalAssignment*)tAssignment;
+		checkDreamAssignmentTypes(e->mCondition, tText);
+		checkDreamAssignmentTypes(e->mTrue, tText);
+		checkDreamAssignmentTypes(e->mFalse, tText);
+		break;
+	}
+	default:
+		break;
+	}
 }
 
 int evaluateDreamAssignment(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer)
 {
 	if (!(*tAssignment)) return 0;
 
-	int isStatic;
-	AssignmentReturnValue* ret = evaluateAssignmentStart(tAssignment, tPlayer, &isStatic);
-	return convertAssignmentReturnToBool(ret);
+	AssignmentProgramValue ret = evaluateAssignmentStart(tAssignment, tPlayer);
+	return convertProgramValueToBool(&ret);
 }
 
 double evaluateDreamAssignmentAndReturnAsFloat(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer)
 {
 	if (!(*tAssignment)) return 0;
 
-	int isStatic;
-	AssignmentReturnValue* ret = evaluateAssignmentStart(tAssignment, tPlayer, &isStatic);
-	return convertAssignmentReturnToFloat(ret);
+	AssignmentProgramValue ret = evaluateAssignmentStart(tAssignment, tPlayer);
+	return convertProgramValueToFloat(&ret);
 }
 
 int evaluateDreamAssignmentAndReturnAsInteger(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer)
 {
 	if (!(*tAssignment)) return 0;
 
-	int isStatic;
-	AssignmentReturnValue* ret = evaluateAssignmentStart(tAssignment, tPlayer, &isStatic);
-	return convertAssignmentReturnToNumber(ret);
+	AssignmentProgramValue ret = evaluateAssignmentStart(tAssignment, tPlayer);
+	return convertProgramValueToNumber(&ret);
 }
 
 void evaluateDreamAssignmentAndReturnAsString(string& oString, DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer)
@@ -2937,32 +4473,40 @@ void evaluateDreamAssignmentAndReturnAsString(string& oString, DreamMugenAssignm
 		return;
 	}
 
-	int isStatic;
-	AssignmentReturnValue* ret = evaluateAssignmentStart(tAssignment, tPlayer, &isStatic);
+	AssignmentProgramValue value = evaluateAssignmentStart(tAssignment, tPlayer);
+	AssignmentReturnValue* ret = makeAssignmentReturnFromProgramValue(&value);
 	convertAssignmentReturnToString(oString, ret);
 }
 
-Vector3D evaluateDreamAssignmentAndReturnAsVector3D(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer)
-{
-	if (!(*tAssignment)) return makePosition(0, 0, 0);
+static int flattenAssignmentReturnVector(AssignmentReturnValue* tReturn, AssignmentReturnValue** oElements, int tAmount) {
+	if (tAmount >= 3) return tAmount;
+	if (tReturn->mType != MUGEN_ASSIGNMENT_RETURN_TYPE_VECTOR) {
+		oElements[tAmount] = tReturn;
+		return tAmount + 1;
+	}
 
-	int isStatic;
-	AssignmentReturnValue* ret = evaluateAssignmentStart(tAssignment, tPlayer, &isStatic);
-	string test;
-	convertAssignmentReturnToString(test, ret);
+	tAmount = flattenAssignmentReturnVector(getVectorAssignmentReturnFirstDependency(tReturn), oElements, tAmount);
+	return flattenAssignmentReturnVector(getVectorAssignmentReturnSecondDependency(tReturn), oElements, tAmount);
+}
 
-	double x, y, z;
-	char tX[100], comma1[20], tY[100], comma2[20], tZ[100];
+static int evaluateAssignmentVectorElements(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer, AssignmentProgramValue* oValue, AssignmentReturnValue** oElements) {
+	*oValue = evaluateAssignmentStart(tAssignment, tPlayer);
+	if (isProgramValueScalar(oValue)) return 0;
+	return flattenAssignmentReturnVector(oValue->mReturn, oElements, 0);
+}
 
-	int items = sscanf(test.data(), "%99s %19s %99s %19s %99s", tX, comma1, tY, comma2, tZ);
+Vector3D evaluateDreamAssignmentAndReturnAsVector3D(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer)
+{
+	if (!(*tAssignment)) return makePosition(0, 0, 0);
 
-	if (items >= 1) x = atof(tX);
-	else x = 0;
-	if (items >= 3) y = atof(tY);
-	else y = 0;
-	if (items >= 5) z = atof(tZ);
-	else z = 0;
+	AssignmentProgramValue value;
+	AssignmentReturnValue* elements[3];
+	int amount = evaluateAssignmentVectorElements(tAssignment, tPlayer, &value, elements);
+	if (!amount) return makePosition(convertProgramValueToFloat(&value), 0, 0);
 
+	double x = convertAssignmentReturnToFloat(elements[0]);
+	double y = amount >= 2 ? convertAssignmentReturnToFloat(elements[1]) : 0;
+	double z = amount >= 3 ? convertAssignmentReturnToFloat(elements[2]) : 0;
 	return makePosition(x, y, z);
 }
 
@@ -2970,22 +4514,13 @@ Vector3DI evaluateDreamAssignmentAndReturnAsVector3DI(DreamMugenAssignment** tAs
 {
 	if (!(*tAssignment)) return makeVector3DI(0, 0, 0);
 
-	int isStatic;
-	AssignmentReturnValue* ret = evaluateAssignmentStart(tAssignment, tPlayer, &isStatic);
-	string test;
-	convertAssignmentReturnToString(test, ret);
-
-	int x, y, z;
-	char tX[100], comma1[20], tY[100], comma2[20], tZ[100];
-
-	int items = sscanf(test.data(), "%99s %19s %99s %19s %99s", tX, comma1, tY, comma2, tZ);
-
-	if (items >= 1) x = atoi(tX);
-	else x = 0;
-	if (items >= 3) y = atoi(tY);
-	else y = 0;
-	if (items >= 5) z = atoi(tZ);
-	else z = 0;
+	AssignmentProgramValue value;
+	AssignmentReturnValue* elements[3];
+	int amount = evaluateAssignmentVectorElements(tAssignment, tPlayer, &value, elements);
+	if (!amount) return makeVector3DI(convertProgramValueToNumber(&value), 0, 0);
 
+	int x = convertAssignmentReturnToNumber(elements[0]);
+	int y = amount >= 2 ? convertAssignmentReturnToNumber(elements[1]) : 0;
+	int z = amount >= 3 ? convertAssignmentReturnToNumber(elements[2]) : 0;
 	return makeVector3DI(x, y, z);
 }
@@ -9,6 +9,19 @@ void setupDreamAssignmentEvaluator();
 void setupDreamStoryAssignmentEvaluator();
 void shutdownDreamAssignmentEvaluator();
 
+void setDreamAssignmentMemoizationActive(int tIsActive);
+int isDreamAssignmentMemoizationActive();
+void beginDreamAssignmentMemoScope();
+void endDreamAssignmentMemoScope();
+void getDreamAssignmentMemoStatistics(uint32_t* oHits, uint32_t* oMisses);
+void resetDreamAssignmentMemoStatistics();
+
+
+int isDreamAssignmentFreeOfSideEffects(DreamMugenAssignment* tAssignment);
+int isDreamAssignmentReorderable(DreamMugenAssignment* tAssignment);
+void checkDreamAssignmentTypes(DreamMugenAssignment* tAssignment, const char* tText);
+void compileDreamAssignmentProgram(DreamMugenAssignment** tAssignment);
+
 int evaluateDreamAssignment(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer);
 double evaluateDreamAssignmentAndReturnAsFloat(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer);
 int evaluateDreamAssignmentAndReturnAsInteger(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer);
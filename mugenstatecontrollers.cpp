@@ -3,6 +3,7 @@
 #include <assert.h>
 #include <string.h>
 #include <stdio.h>
+#include <stdint.h>
 #include <string>
 
 #define LOGGER_WARNINGS_DISABLED
@@ -31,6 +32,8 @@
 #include "titlescreen.h"
 #include "intro.h"
 #include "mugensound.h"
+#include "mugentriggerprofile.h"
+#include "mugenstateprofiler.h"
 
 #define GAME_MAKE_ANIM_UNDER_Z 31
 #define GAME_MAKE_ANIM_OVER_Z 51
@@ -52,9 +55,26 @@ static struct {
 typedef struct {
 
 	char mName[100];
-	DreamMugenAssignment** mTriggerRoot;
+	uint16_t mGroup;
+	vector<DreamMugenTriggerConjunct>* mConjuncts;
+	uint64_t mTextHash;
 } TriggerParseCaller;
 
+static uint32_t hashTriggerText(const char* tText) {
+	uint32_t hash = 2166136261u;
+	while (*tText) {
+		hash = (hash ^ (uint8_t)*tText++) * 16777619u;
+	}
+	return hash;
+}
+
+static uint64_t hashTriggerTextWide(uint64_t tHash, const char* tText) {
+	do {
+		tHash = (tHash ^ (uint8_t)*tText) * 1099511628211ull;
+	} while (*tText++);
+	return tHash;
+}
+
 static void checkSingleElementForTrigger(void* tCaller, void* tData) {
 	TriggerParseCaller* caller = (TriggerParseCaller*)tCaller;
 	MugenDefScriptGroupElement* e = (MugenDefScriptGroupElement*)tData;
@@ -63,46 +83,141 @@ static void checkSingleElementForTrigger(void* tCaller, void* tData) {
 
 	char* text = getAllocatedMugenDefStringVariableAsElement(e);
 
-	DreamMugenAssignment* trigger = parseDreamMugenAssignmentFromString(text);
+	DreamMugenTriggerConjunct conjunct;
+	conjunct.mAssignment = parseDreamMugenAssignmentFromString(text);
+	conjunct.mHash = hashTriggerText(text);
+	caller->mTextHash = hashTriggerTextWide(caller->mTextHash, text);
+	conjunct.mGroup = caller->mGroup;
+	conjunct.mIndex = 0;
+	for (auto& other : *caller->mConjuncts) {
+		if (other.mGroup == caller->mGroup) conjunct.mIndex++;
+	}
+	conjunct.mIsFreeOfSideEffects = (uint8_t)isDreamAssignmentFreeOfSideEffects(conjunct.mAssignment);
+	conjunct.mIsReorderable = (uint8_t)isDreamAssignmentReorderable(conjunct.mAssignment);
 	freeMemory(text);
 
-	*caller->mTriggerRoot = makeDreamAndMugenAssignment(*caller->mTriggerRoot, trigger);
+	caller->mConjuncts->push_back(conjunct);
 }
 
-static int parseTriggerAndReturnIfFound(const char* tName, DreamMugenAssignment** tRoot, MugenDefScriptGroup* tGroup) {
+static int parseTriggerAndReturnIfFound(const char* tName, int tGroupIndex, vector<DreamMugenTriggerConjunct>& tConjuncts, MugenDefScriptGroup* tGroup, uint64_t* oTextHash) {
 	if (!stl_string_map_contains_array(tGroup->mElements, tName)) return 0;
 
-	DreamMugenAssignment* triggerRoot = NULL;
 	TriggerParseCaller caller;
 	strcpy(caller.mName, tName);
-	caller.mTriggerRoot = &triggerRoot;
+	caller.mGroup = (uint16_t)tGroupIndex;
+	caller.mConjuncts = &tConjuncts;
+	caller.mTextHash = 14695981039346656037ull;
 	list_map(&tGroup->mOrderedElementList, checkSingleElementForTrigger, &caller);
 
-	*tRoot = makeDreamOrMugenAssignment(*tRoot, triggerRoot);
-
+	*oTextHash = caller.mTextHash;
 	return 1;
 }
 
-static int parseNumberedTriggerAndReturnIfFound(int i, DreamMugenAssignment** tRoot, MugenDefScriptGroup* tGroup) {
+static int parseNumberedTriggerAndReturnIfFound(int i, vector<DreamMugenTriggerConjunct>& tConjuncts, MugenDefScriptGroup* tGroup) {
 	char name[100];
 	sprintf(name, "trigger%d", i);
 
-	return parseTriggerAndReturnIfFound(name, tRoot, tGroup);
+	uint64_t textHash;
+	return parseTriggerAndReturnIfFound(name, i, tConjuncts, tGroup, &textHash);
+}
+
+static int areTriggerConjunctsFreeOfSideEffects(vector<DreamMugenTriggerConjunct>& tConjuncts, int tIsGuard) {
+	for (auto& conjunct : tConjuncts) {
+		int isGuardConjunct = !conjunct.mGroup;
+		if (isGuardConjunct == tIsGuard && !conjunct.mIsFreeOfSideEffects) return 0;
+	}
+	return 1;
+}
+
+extern void* findMugenAssignmentVariableFunction(const char* tName);
+extern void* findMugenAssignmentArrayFunction(const char* tName);
+
+static int isTriggerComparisonWithName(DreamMugenAssignment* tAssignment, const char* tName) {
+	if (tAssignment->mType != MUGEN_ASSIGNMENT_TYPE_TRIGGER) return 0;
+	DreamMugenTriggerAssignment* trigger = (DreamMugenTriggerAssignment*)tAssignment;
+	return trigger->mKind == MUGEN_TRIGGER_KIND_COMPARISON && !strcmp(tName, trigger->mName);
+}
+
+static uint8_t getTriggerConjunctGate(DreamMugenTriggerConjunct* tConjunct, int* oValue) {
+	if (tConjunct->mAssignment->mType != MUGEN_ASSIGNMENT_TYPE_COMPARISON) return MUGEN_STATE_CONTROLLER_GATE_NONE;
+	DreamMugenDependOnTwoAssignment* comparison = (DreamMugenDependOnTwoAssignment*)tConjunct->mAssignment;
+	if (comparison->b->mType != MUGEN_ASSIGNMENT_TYPE_NUMBER) return MUGEN_STATE_CONTROLLER_GATE_NONE;
+	int value = ((DreamMugenNumberAssignment*)comparison->b)->mValue;
+
+	uint8_t kind = MUGEN_STATE_CONTROLLER_GATE_NONE;
+	DreamMugenAssignment* a = comparison->a;
+	if (isTriggerComparisonWithName(a, "command")) {
+		kind = MUGEN_STATE_CONTROLLER_GATE_COMMAND;
+	}
+	else if (isTriggerComparisonWithName(a, "animelem")) {
+		kind = MUGEN_STATE_CONTROLLER_GATE_ANIMATION_ELEMENT;
+	}
+	else if (a->mType == MUGEN_ASSIGNMENT_TYPE_VARIABLE && ((DreamMugenVariableAssignment*)a)->mFunc == findMugenAssignmentVariableFunction("time")) {
+		kind = MUGEN_STATE_CONTROLLER_GATE_TIME;
+	}
+	else if (a->mType == MUGEN_ASSIGNMENT_TYPE_ARRAY && ((DreamMugenArrayAssignment*)a)->mFunc == findMugenAssignmentArrayFunction("animelemtime") && ((DreamMugenArrayAssignment*)a)->mIndex->mType == MUGEN_ASSIGNMENT_TYPE_NUMBER && !value) {
+		kind = MUGEN_STATE_CONTROLLER_GATE_ANIMATION_ELEMENT_TIME;
+		value = ((DreamMugenNumberAssignment*)((DreamMugenArrayAssignment*)a)->mIndex)->mValue;
+	}
+
+	if (value < INT16_MIN || value > INT16_MAX) return MUGEN_STATE_CONTROLLER_GATE_NONE;
+	*oValue = value;
+	return kind;
+}
+
+// a gate conjunct gates the controller if everything evaluated before it is free of side effects, either in triggerall or in every trigger group
+static void parseStateControllerGate(DreamMugenStateController* tController, vector<DreamMugenTriggerConjunct>& tConjuncts) {
+	tController->mGateKind = MUGEN_STATE_CONTROLLER_GATE_NONE;
+	tController->mGateValue = 0;
+
+	int value = 0;
+	size_t i = 0;
+	for (; i < tConjuncts.size() && !tConjuncts[i].mGroup; i++) {
+		uint8_t kind = getTriggerConjunctGate(&tConjuncts[i], &value);
+		if (kind != MUGEN_STATE_CONTROLLER_GATE_NONE) {
+			tController->mGateKind = kind;
+			tController->mGateValue = (int16_t)value;
+			return;
+		}
+		if (!tConjuncts[i].mIsFreeOfSideEffects) return;
+	}
+	if (i == tConjuncts.size()) return;
+
+	uint8_t kind = MUGEN_STATE_CONTROLLER_GATE_NONE;
+	int kindValue = 0;
+	while (i < tConjuncts.size()) {
+		int group = tConjuncts[i].mGroup;
+		uint8_t groupKind = MUGEN_STATE_CONTROLLER_GATE_NONE;
+		int groupValue = 0;
+		for (; i < tConjuncts.size() && tConjuncts[i].mGroup == group; i++) {
+			if (groupKind != MUGEN_STATE_CONTROLLER_GATE_NONE) continue;
+			groupKind = getTriggerConjunctGate(&tConjuncts[i], &groupValue);
+			if (groupKind == MUGEN_STATE_CONTROLLER_GATE_NONE && !tConjuncts[i].mIsFreeOfSideEffects) return;
+		}
+		if (groupKind == MUGEN_STATE_CONTROLLER_GATE_NONE) return;
+		if (kind != MUGEN_STATE_CONTROLLER_GATE_NONE && (kind != groupKind || kindValue != groupValue)) return;
+		kind = groupKind;
+		kindValue = groupValue;
+	}
+	tController->mGateKind = kind;
+	tController->mGateValue = (int16_t)kindValue;
 }
 
 static void parseStateControllerTriggers(DreamMugenStateController* tController, MugenDefScriptGroup* tGroup) {
-	DreamMugenAssignment* allRoot = NULL;
-	parseTriggerAndReturnIfFound("triggerall", &allRoot, tGroup);
+	vector<DreamMugenTriggerConjunct> conjuncts;
+	tController->mTrigger.mGuardHash = 0;
+	parseTriggerAndReturnIfFound("triggerall", 0, conjuncts, tGroup, &tController->mTrigger.mGuardHash);
 
-	DreamMugenAssignment* root = NULL;
 	int i = 1;
-	while (parseNumberedTriggerAndReturnIfFound(i, &root, tGroup)) i++;
+	while (parseNumberedTriggerAndReturnIfFound(i, conjuncts, tGroup)) i++;
 
-	root = makeDreamAndMugenAssignment(allRoot, root);
-	if (!root) {
-		root = makeDreamTrueMugenAssignment();
-	}
-	tController->mTrigger.mAssignment = root;
+	tController->mTrigger.mIsGuardFreeOfSideEffects = (uint8_t)areTriggerConjunctsFreeOfSideEffects(conjuncts, 1);
+	tController->mTrigger.mIsFreeOfSideEffects = (uint8_t)areTriggerConjunctsFreeOfSideEffects(conjuncts, 0);
+	tController->mTrigger.mGuardRun = -1;
+	tController->mTrigger.mAssignment = makeDreamMugenTriggerFromConjuncts(conjuncts, &tController->mTrigger.mGuard, &tController->mTrigger.mProfile);
+	compileDreamAssignmentProgram(&tController->mTrigger.mGuard);
+	compileDreamAssignmentProgram(&tController->mTrigger.mAssignment);
+	parseStateControllerGate(tController, conjuncts);
 }
 
 static void* allocMemoryOnMemoryStackOrMemory(uint32_t tSize) {
@@ -180,6 +295,7 @@ static void fetchAssignmentFromGroupAndReturnWhetherItExistsDefaultString(const
 	if (!fetchDreamAssignmentFromGroupAndReturnWhetherItExists(tName, tGroup, tDst)) {
 		if (tDefault) {
 			*tDst = makeDreamStringMugenAssignment(tDefault);
+			compileDreamAssignmentProgram(tDst);
 		}
 		else {
 			*tDst = NULL;
@@ -2391,6 +2507,25 @@ static void parseStateControllerType(DreamMugenStateController* tController, Mug
 	freeMemory(type);
 }
 
+static int unrecognizedStateControllerHandleFunction(DreamMugenStateController* tController, DreamPlayer* /*tPlayer*/) {
+	logWarningFormat("Unrecognized state controller %d. Ignoring.", tController->mType);
+	return 0;
+}
+
+static void unrecognizedStateControllerUnloadFunction(DreamMugenStateController* /*tController*/) {}
+
+static void parseStateControllerFunctions(DreamMugenStateController* tController) {
+	auto handler = gMugenStateControllerVariableHandler.mStateControllerHandlers.find((int)tController->mType);
+	tController->mHandler = handler == gMugenStateControllerVariableHandler.mStateControllerHandlers.end() ? unrecognizedStateControllerHandleFunction : handler->second;
+
+	auto unloader = gMugenStateControllerVariableHandler.mStateControllerUnloaders.find((int)tController->mType);
+	if (unloader == gMugenStateControllerVariableHandler.mStateControllerUnloaders.end()) {
+		logWarningFormat("Unable to determine unloader for state controller type %d. Defaulting to null.", tController->mType);
+		unloader = gMugenStateControllerVariableHandler.mStateControllerUnloaders.find((int)MUGEN_STATE_CONTROLLER_TYPE_NULL);
+	}
+	tController->mUnloader = unloader == gMugenStateControllerVariableHandler.mStateControllerUnloaders.end() ? unrecognizedStateControllerUnloadFunction : unloader->second;
+}
+
 static void parseStateControllerPersistence(DreamMugenStateController* tController, MugenDefScriptGroup* tGroup) {
 	tController->mPersistence = (int16_t)getMugenDefIntegerOrDefaultAsGroup(tGroup, "persistent", 1);
 	tController->mAccessAmount = 0;
@@ -2398,30 +2533,30 @@ static void parseStateControllerPersistence(DreamMugenStateController* tControll
 
 int gDebugStateControllerAmount;
 
-DreamMugenStateController * parseDreamMugenStateControllerFromGroup(MugenDefScriptGroup* tGroup)
+void parseDreamMugenStateControllerFromGroup(DreamMugenStateController* oController, MugenDefScriptGroup* tGroup)
 {
-	DreamMugenStateController* ret = (DreamMugenStateController*)allocMemoryOnMemoryStackOrMemory(sizeof(DreamMugenStateController));
 	gDebugStateControllerAmount++;
-	parseStateControllerType(ret, tGroup);
-	parseStateControllerTriggers(ret, tGroup);
-	parseStateControllerPersistence(ret, tGroup);
-
-	return ret;
+	parseStateControllerType(oController, tGroup);
+	parseStateControllerFunctions(oController);
+	parseStateControllerTriggers(oController, tGroup);
+	parseStateControllerPersistence(oController, tGroup);
 }
 
 static void unloadStateControllerType(DreamMugenStateController* tController) {
-	if (!stl_map_contains(gMugenStateControllerVariableHandler.mStateControllerUnloaders, (int)tController->mType)) {
-		logWarningFormat("Unable to determine state controller type %d. Defaulting to null.", tController->mType);
-		tController->mType = MUGEN_STATE_CONTROLLER_TYPE_NULL;
-	}
-
-	StateControllerUnloadFunction func = gMugenStateControllerVariableHandler.mStateControllerUnloaders[tController->mType];
-	func(tController);
+	tController->mUnloader(tController);
 }
 
 void unloadDreamMugenStateController(DreamMugenStateController * tController)
 {
-	destroyDreamMugenAssignment(tController->mTrigger.mAssignment);
+	if (tController->mTrigger.mProfile) {
+		unloadDreamMugenTriggerProfile(tController->mTrigger.mProfile);
+	}
+	else {
+		if (tController->mTrigger.mGuard) {
+			destroyDreamMugenAssignment(tController->mTrigger.mGuard);
+		}
+		destroyDreamMugenAssignment(tController->mTrigger.mAssignment);
+	}
 	unloadStateControllerType(tController);
 }
 
@@ -4698,14 +4833,12 @@ static int handleProjectile(DreamMugenStateController* tController, DreamPlayer*
 
 int handleDreamMugenStateControllerAndReturnWhetherStateChanged(DreamMugenStateController * tController, DreamPlayer* tPlayer)
 {
+	if (!gIsDreamStateProfilerActive) return tController->mHandler(tController, tPlayer);
 
-	if (!stl_map_contains(gMugenStateControllerVariableHandler.mStateControllerHandlers, (int)tController->mType)) {
-		logWarningFormat("Unrecognized state controller %d. Ignoring.", tController->mType);
-		return 0;
-	}
-
-	StateControllerHandleFunction func = gMugenStateControllerVariableHandler.mStateControllerHandlers[tController->mType];
-	return func(tController, tPlayer);
+	DreamStateProfilerScope scope = beginDreamStateProfilerHandler();
+	int ret = tController->mHandler(tController, tPlayer);
+	endDreamStateProfilerHandler(scope);
+	return ret;
 }
 
 
@@ -6020,6 +6153,7 @@ static void parseSingleStoryVarSetControllerEntry(StoryVarSetControllerCaller* t
 	}
 	
 	e->mID = parseDreamMugenAssignmentFromString(value);
+	compileDreamAssignmentProgram(&e->mID);
 	fetchDreamAssignmentFromGroupAndReturnWhetherItExists(tName.data(), caller->mGroup, &e->mAssignment);
 
 	vector_push_back_owned(&caller->mController->mStoryVarSets, e);
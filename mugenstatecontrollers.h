@@ -7,7 +7,7 @@
 #include "playerdefinition.h"
 
 
-DreamMugenStateController* parseDreamMugenStateControllerFromGroup(MugenDefScriptGroup* tGroup);
+void parseDreamMugenStateControllerFromGroup(DreamMugenStateController* oController, MugenDefScriptGroup* tGroup);
 void unloadDreamMugenStateController(DreamMugenStateController* tController);
 int handleDreamMugenStateControllerAndReturnWhetherStateChanged(DreamMugenStateController* tController, DreamPlayer* tPlayer);
 
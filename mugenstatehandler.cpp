@@ -1,6 +1,8 @@
 #include "mugenstatehandler.h"
 
 #include <assert.h>
+#include <algorithm>
+#include <set>
 
 #include <prism/datastructures.h>
 #include <prism/system.h>
@@ -12,6 +14,8 @@
 #include "mugenassignmentevaluator.h"
 #include "mugenstatecontrollers.h"
 #include "playerhitdata.h"
+#include "mugentriggerprofile.h"
+#include "mugenstateprofiler.h"
 
 using namespace std;
 
@@ -34,9 +38,14 @@ typedef struct {
 	int mCurrentJugglePoints;
 } RegisteredState;
 
+#define MUGEN_STATE_VISIT_BUFFER_SIZE 64
+#define MUGEN_STATE_SCHEDULE_BUCKET_BUFFER_SIZE 32
+
 static struct {
 	map<int, RegisteredState> mRegisteredStates;
 	int mIsInStoryMode;
+	uint32_t mVisitGeneration;
+	set<pair<int, int> > mLoggedStateChangeCycles;
 
 	double mTimeDilatationNow;
 	double mTimeDilatation;
@@ -46,6 +55,7 @@ static void loadStateHandler(void* tData) {
 	(void)tData;
 	
 	gMugenStateHandlerData.mRegisteredStates.clear();
+	gMugenStateHandlerData.mLoggedStateChangeCycles.clear();
 	gMugenStateHandlerData.mTimeDilatationNow = 0.0;
 	gMugenStateHandlerData.mTimeDilatation = 1.0;
 }
@@ -53,26 +63,41 @@ static void loadStateHandler(void* tData) {
 static void unloadStateHandler(void* tData) {
 	(void)tData;
 	gMugenStateHandlerData.mRegisteredStates.clear();
+	gMugenStateHandlerData.mLoggedStateChangeCycles.clear();
 }
 
 typedef struct {
 	RegisteredState* mRegisteredState;
+	DreamMugenStates* mStates;
 	DreamMugenState* mState;
 
 	int mHasChangedState;
+	int mGuardRun;
+	int mGuardValue;
+	int mExecutedAmount;
 } MugenStateControllerCaller;
 
-static int evaluateTrigger(DreamMugenStateControllerTrigger* tTrigger, DreamPlayer* tPlayer) {
-	return evaluateDreamAssignment(&tTrigger->mAssignment, tPlayer);
+// a guard result stays valid for its run until something with side effects has been evaluated or executed
+static int evaluateTrigger(MugenStateControllerCaller* caller, DreamMugenStateControllerTrigger* tTrigger, DreamPlayer* tPlayer) {
+	if (tTrigger->mProfile) return evaluateDreamMugenTriggerProfile(tTrigger->mProfile, tPlayer);
+
+	if (tTrigger->mGuard) {
+		if (tTrigger->mGuardRun == -1 || tTrigger->mGuardRun != caller->mGuardRun) {
+			caller->mGuardValue = evaluateDreamAssignment(&tTrigger->mGuard, tPlayer);
+			caller->mGuardRun = tTrigger->mGuardRun;
+		}
+		if (!caller->mGuardValue) return 0;
+	}
+
+	int ret = evaluateDreamAssignment(&tTrigger->mAssignment, tPlayer);
+	if (!tTrigger->mIsFreeOfSideEffects) caller->mGuardRun = -1;
+	return ret;
 }
 
-static void updateSingleController(void* tCaller, void* tData) {
-	MugenStateControllerCaller* caller = (MugenStateControllerCaller*)tCaller;
-	DreamMugenStateController* controller = (DreamMugenStateController*)tData;
-	
+static void runSingleController(MugenStateControllerCaller* caller, DreamMugenStateController* controller) {
 	if (!gMugenStateHandlerData.mIsInStoryMode && caller->mRegisteredState->mPlayer && isPlayerDestroyed(caller->mRegisteredState->mPlayer)) return;
 	if (caller->mHasChangedState) return;
-	if (!evaluateTrigger(&controller->mTrigger, caller->mRegisteredState->mPlayer)) return;
+	if (!evaluateTrigger(caller, &controller->mTrigger, caller->mRegisteredState->mPlayer)) return;
 
 	controller->mAccessAmount++;
 	int testValue = controller->mAccessAmount - 1;
@@ -83,7 +108,105 @@ static void updateSingleController(void* tCaller, void* tData) {
 		if (testValue) return;
 	}
 
+	endDreamAssignmentMemoScope();
 	caller->mHasChangedState = handleDreamMugenStateControllerAndReturnWhetherStateChanged(controller, caller->mRegisteredState->mPlayer);
+	caller->mGuardRun = -1;
+	caller->mExecutedAmount++;
+	beginDreamAssignmentMemoScope();
+}
+
+static void updateSingleController(MugenStateControllerCaller* caller, DreamMugenStateController* controller) {
+	if (!gIsDreamStateProfilerActive) {
+		runSingleController(caller, controller);
+		return;
+	}
+
+	DreamStateProfilerScope scope = beginDreamStateProfilerController(caller->mStates, caller->mState->mID, int(controller - caller->mState->mControllers));
+	runSingleController(caller, controller);
+	endDreamStateProfilerController(scope);
+}
+
+static void updateControllersFrom(MugenStateControllerCaller* caller, DreamMugenState* tState, int tStart) {
+	for (int i = tStart; i < tState->mControllerAmount; i++) {
+		updateSingleController(caller, &tState->mControllers[i]);
+	}
+}
+
+static int isScheduleGateOpen(DreamPlayer* tPlayer, uint8_t tKind, int tValue) {
+	switch (tKind) {
+	case MUGEN_STATE_CONTROLLER_GATE_COMMAND:
+		return isPlayerCommandActiveWithLookup(tPlayer, tValue);
+	case MUGEN_STATE_CONTROLLER_GATE_TIME:
+		return getPlayerTimeInState(tPlayer) == tValue;
+	case MUGEN_STATE_CONTROLLER_GATE_ANIMATION_ELEMENT:
+		return isPlayerStartingAnimationElementWithID(tPlayer, tValue);
+	case MUGEN_STATE_CONTROLLER_GATE_ANIMATION_ELEMENT_TIME:
+		return !getPlayerTimeFromAnimationElement(tPlayer, tValue);
+	default:
+		return 1;
+	}
+}
+
+static int addScheduleBucket(DreamMugenStateControllerSchedule* tSchedule, int tBucket, int tPosition, int** oHeads, int** oEnds, int* oAmount) {
+	if (*oAmount == MUGEN_STATE_SCHEDULE_BUCKET_BUFFER_SIZE) return 0;
+	int* start = tSchedule->mControllerIndices + tSchedule->mBucketStarts[tBucket];
+	int* end = tSchedule->mControllerIndices + tSchedule->mBucketStarts[tBucket + 1];
+	oHeads[*oAmount] = lower_bound(start, end, tPosition);
+	oEnds[(*oAmount)++] = end;
+	return 1;
+}
+
+// collects the ungated bucket and the buckets whose gate is open now, starting at controller tPosition; returns -1 if they do not fit
+static int openScheduleBuckets(MugenStateControllerCaller* caller, DreamMugenStateControllerSchedule* tSchedule, int tPosition, int** oHeads, int** oEnds) {
+	DreamPlayer* player = caller->mRegisteredState->mPlayer;
+	int amount = 0;
+	addScheduleBucket(tSchedule, tSchedule->mBucketAmount, tPosition, oHeads, oEnds, &amount);
+	for (int i = 0; i < tSchedule->mBucketAmount; i++) {
+		if (i == tSchedule->mTimeBucketStart) i = tSchedule->mTimeBucketEnd;
+		if (i == tSchedule->mBucketAmount) break;
+		if (!isScheduleGateOpen(player, tSchedule->mGateKinds[i], tSchedule->mGateValues[i])) continue;
+		if (!addScheduleBucket(tSchedule, i, tPosition, oHeads, oEnds, &amount)) return -1;
+	}
+
+	int* timeStart = tSchedule->mGateValues + tSchedule->mTimeBucketStart;
+	int* timeEnd = tSchedule->mGateValues + tSchedule->mTimeBucketEnd;
+	int* time = lower_bound(timeStart, timeEnd, getPlayerTimeInState(player));
+	if (time != timeEnd && *time == getPlayerTimeInState(player)) {
+		if (!addScheduleBucket(tSchedule, int(time - tSchedule->mGateValues), tPosition, oHeads, oEnds, &amount)) return -1;
+	}
+	return amount;
+}
+
+// merges the open buckets in file order, a controller that ran may have changed the animation so the gates are opened again after it
+static void updateScheduledControllers(MugenStateControllerCaller* caller, DreamMugenState* tState) {
+	DreamMugenStateControllerSchedule* schedule = tState->mSchedule;
+	int* heads[MUGEN_STATE_SCHEDULE_BUCKET_BUFFER_SIZE];
+	int* ends[MUGEN_STATE_SCHEDULE_BUCKET_BUFFER_SIZE];
+	int bucketAmount = openScheduleBuckets(caller, schedule, 0, heads, ends);
+	if (bucketAmount == -1) {
+		updateControllersFrom(caller, tState, 0);
+		return;
+	}
+
+	while (!caller->mHasChangedState) {
+		int next = -1;
+		for (int i = 0; i < bucketAmount; i++) {
+			if (heads[i] == ends[i]) continue;
+			if (next == -1 || *heads[i] < *heads[next]) next = i;
+		}
+		if (next == -1) break;
+
+		int index = *heads[next]++;
+		int executedAmount = caller->mExecutedAmount;
+		updateSingleController(caller, &tState->mControllers[index]);
+		if (caller->mExecutedAmount == executedAmount || caller->mHasChangedState) continue;
+
+		bucketAmount = openScheduleBuckets(caller, schedule, index + 1, heads, ends);
+		if (bucketAmount == -1) {
+			updateControllersFrom(caller, tState, index + 1);
+			return;
+		}
+	}
 }
 
 static DreamMugenStates* getCurrentStateMachineStates(RegisteredState* tRegisteredState) {
@@ -95,27 +218,74 @@ static DreamMugenStates* getCurrentStateMachineStates(RegisteredState* tRegister
 	}
 }
 
+static void logStateChangeCycle(RegisteredState* tRegisteredState, int* tVisitedStates, int tVisitedAmount, int tState) {
+	// cycles usually repeat every tick (e.g. a ChangeState to the current state), so each one is only reported once
+	if (!gMugenStateHandlerData.mLoggedStateChangeCycles.insert(make_pair(tVisitedStates[tVisitedAmount - 1], tState)).second) return;
+
+	int start = 0;
+	while (start < tVisitedAmount && tVisitedStates[start] != tState) start++;
+
+	char text[1024];
+	int length = 0;
+	for (int i = start; i < tVisitedAmount && length < 1000; i++) {
+		length += sprintf(text + length, "%d -> ", tVisitedStates[i]);
+	}
+	sprintf(text + length, "%d", tState);
+
+	if (!tRegisteredState->mPlayer || gMugenStateHandlerData.mIsInStoryMode) {
+		logFormat("State change cycle %s stopped, further occurrences are not logged.", text);
+	}
+	else {
+		logFormat("Player %d %d state change cycle %s stopped, further occurrences are not logged.", tRegisteredState->mPlayer->mRootID, tRegisteredState->mPlayer->mID, text);
+	}
+}
+
+static void updateStateControllers(MugenStateControllerCaller* caller, DreamMugenState* tState) {
+	if (tState->mSchedule && !gMugenStateHandlerData.mIsInStoryMode && caller->mRegisteredState->mPlayer) {
+		updateScheduledControllers(caller, tState);
+	}
+	else {
+		updateControllersFrom(caller, tState, 0);
+	}
+}
+
 static void updateSingleState(RegisteredState* tRegisteredState, int tState, int tForceOwnStates) {
 	if (!gMugenStateHandlerData.mIsInStoryMode && tRegisteredState->mPlayer && (!isPlayer(tRegisteredState->mPlayer) || isPlayerDestroyed(tRegisteredState->mPlayer))) return;
 
-	set<int> visitedStates;
+	int visitedStates[MUGEN_STATE_VISIT_BUFFER_SIZE];
+	int visitedAmount = 0;
+	uint32_t generation = ++gMugenStateHandlerData.mVisitGeneration;
 	
 	int isEvaluating = 1;
 	while (isEvaluating) {
 		DreamMugenStates* states = tForceOwnStates ? tRegisteredState->mStates : getCurrentStateMachineStates(tRegisteredState);
-		if (!stl_map_contains(states->mStates, tState)) break;
-		visitedStates.insert(tState);
-		DreamMugenState* state = &states->mStates[tState];
+		DreamMugenState* state = getDreamMugenState(states, tState);
+		if (!state) break;
+		state->mVisitGeneration = generation;
+		visitedStates[visitedAmount++] = tState;
 		MugenStateControllerCaller caller;
 		caller.mRegisteredState = tRegisteredState;
+		caller.mStates = states;
 		caller.mState = state;
 		caller.mHasChangedState = 0;
-		vector_map(&state->mControllers, updateSingleController, &caller);
+		caller.mGuardRun = -1;
+		caller.mExecutedAmount = 0;
+		if (!gIsDreamStateProfilerActive) {
+			updateStateControllers(&caller, state);
+		}
+		else {
+			DreamStateProfilerScope scope = beginDreamStateProfilerState(states, tState);
+			updateStateControllers(&caller, state);
+			endDreamStateProfilerState(scope);
+		}
 		
 		if (!caller.mHasChangedState) break;
 		else {
 			if (tState < 0) break;
-			if (stl_set_contains(visitedStates, tRegisteredState->mState)) {
+			// nested state machine updates restamp shared states, the buffer bound keeps those cases finite
+			DreamMugenState* nextState = getDreamMugenState(getCurrentStateMachineStates(tRegisteredState), tRegisteredState->mState);
+			if ((nextState && nextState->mVisitGeneration == generation) || visitedAmount == MUGEN_STATE_VISIT_BUFFER_SIZE) {
+				logStateChangeCycle(tRegisteredState, visitedStates, visitedAmount, tRegisteredState->mState);
 				tRegisteredState->mTimeInState--;
 				break;
 			}
@@ -124,10 +294,7 @@ static void updateSingleState(RegisteredState* tRegisteredState, int tState, int
 	}
 }
 
-static int updateSingleStateMachineByReference(RegisteredState* tRegisteredState) {
-	if (tRegisteredState->mIsPaused) return 0;
-
-	tRegisteredState->mTimeInState++;
+static void updateStateMachineStates(RegisteredState* tRegisteredState) {
 	if (!tRegisteredState->mIsInHelperMode) {
 		if (!tRegisteredState->mIsUsingTemporaryOtherStateMachine) {
 			updateSingleState(tRegisteredState, -3, 1);
@@ -138,6 +305,22 @@ static int updateSingleStateMachineByReference(RegisteredState* tRegisteredState
 		updateSingleState(tRegisteredState, -1, 1);
 	}
 	updateSingleState(tRegisteredState, tRegisteredState->mState, 0);
+}
+
+static int updateSingleStateMachineByReference(RegisteredState* tRegisteredState) {
+	if (tRegisteredState->mIsPaused) return 0;
+
+	tRegisteredState->mTimeInState++;
+	beginDreamAssignmentMemoScope();
+	if (!gIsDreamStateProfilerActive) {
+		updateStateMachineStates(tRegisteredState);
+	}
+	else {
+		DreamStateProfilerScope scope = beginDreamStateProfilerMachine(tRegisteredState->mStates);
+		updateStateMachineStates(tRegisteredState);
+		endDreamStateProfilerMachine(scope);
+	}
+	endDreamAssignmentMemoScope();
 
 	return !gMugenStateHandlerData.mIsInStoryMode && tRegisteredState->mPlayer && isPlayerDestroyed(tRegisteredState->mPlayer);
 }
@@ -298,14 +481,14 @@ int hasDreamHandledStateMachineState(int tID, int tNewState)
 	RegisteredState* e = &gMugenStateHandlerData.mRegisteredStates[tID];
 	
 	DreamMugenStates* states = getCurrentStateMachineStates(e);
-	return stl_map_contains(states->mStates, tNewState);
+	return hasDreamMugenState(states, tNewState);
 }
 
 int hasDreamHandledStateMachineStateSelf(int tID, int tNewState)
 {
 	assert(stl_map_contains(gMugenStateHandlerData.mRegisteredStates, tID));
 	RegisteredState* e = &gMugenStateHandlerData.mRegisteredStates[tID];
-	return stl_map_contains(e->mStates->mStates, tNewState);
+	return hasDreamMugenState(e->mStates, tNewState);
 }
 
 int isInOwnStateMachine(int tID)
@@ -315,14 +498,10 @@ int isInOwnStateMachine(int tID)
 	return !e->mIsUsingTemporaryOtherStateMachine;
 }
 
-static void resetSingleStateController(void* tCaller, void* tData) {
-	(void)tCaller;
-	DreamMugenStateController* controller = (DreamMugenStateController*)tData;
-	controller->mAccessAmount = 0;
-}
-
 static void resetStateControllers(DreamMugenState* e) {
-	vector_map(&e->mControllers, resetSingleStateController, NULL);
+	for (int i = 0; i < e->mControllerAmount; i++) {
+		e->mControllers[i].mAccessAmount = 0;
+	}
 }
 
 void changeDreamHandledStateMachineState(int tID, int tNewState)
@@ -330,7 +509,8 @@ void changeDreamHandledStateMachineState(int tID, int tNewState)
 	assert(stl_map_contains(gMugenStateHandlerData.mRegisteredStates, tID));
 	RegisteredState* e = &gMugenStateHandlerData.mRegisteredStates[tID];
 	DreamMugenStates* states = getCurrentStateMachineStates(e);
-	if (!stl_map_contains(states->mStates, tNewState)) {
+	DreamMugenState* newState = getDreamMugenState(states, tNewState);
+	if (!newState) {
 		if (!e->mPlayer || gMugenStateHandlerData.mIsInStoryMode) {
 			logWarningFormat("ID %d trying to change into nonexistant state %d. Ignoring.", tID, tNewState);
 		}
@@ -347,7 +527,6 @@ void changeDreamHandledStateMachineState(int tID, int tNewState)
 	e->mPreviousState = e->mState;
 	e->mState = tNewState;
 	
-	DreamMugenState* newState = &states->mStates[e->mState];
 	resetStateControllers(newState);
 	
 	if (!e->mPlayer || gMugenStateHandlerData.mIsInStoryMode) return;
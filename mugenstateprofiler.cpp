@@ -0,0 +1,222 @@
+#include "mugenstateprofiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <sstream>
+#include <tuple>
+#include <vector>
+
+#include <prism/file.h>
+#include <prism/log.h>
+
+#include "playerdefinition.h"
+
+using namespace std;
+
+#define STATE_PROFILER_MACHINE_CONTROLLER -2
+#define STATE_PROFILER_STATE_CONTROLLER -1
+
+int gIsDreamStateProfilerActive;
+
+typedef struct {
+	int mCharacter;
+	int mState;
+	int mController;
+
+	uint32_t mCallAmount;
+	uint32_t mExecutionAmount;
+	uint64_t mNanoseconds;
+	uint64_t mMaximumNanoseconds;
+	uint64_t mHandlerNanoseconds;
+} StateProfilerEntry;
+
+typedef struct {
+	DreamMugenStates* mStates;
+	string mName;
+} StateProfilerCharacter;
+
+static struct {
+	vector<StateProfilerCharacter> mCharacters;
+	map<tuple<int, int, int>, StateProfilerEntry> mEntries;
+	StateProfilerEntry* mCurrentController;
+} gStateProfilerData;
+
+static uint64_t getStateProfilerTime() {
+	return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void setDreamStateProfilerActive(int tIsActive)
+{
+	gIsDreamStateProfilerActive = tIsActive;
+	gStateProfilerData.mCurrentController = NULL;
+}
+
+void resetDreamStateProfiler()
+{
+	gStateProfilerData.mCharacters.clear();
+	gStateProfilerData.mEntries.clear();
+	gStateProfilerData.mCurrentController = NULL;
+}
+
+// states are shared with helpers and custom states run in the owner's table, so the table decides who the cost belongs to
+static string getStateProfilerCharacterName(DreamMugenStates* tStates) {
+	for (int i = 0; i < 2; i++) {
+		DreamPlayer* p = getRootPlayer(i);
+		if (p && p->mHeader && &p->mHeader->mFiles.mConstants.mStates == tStates) return getPlayerName(p);
+	}
+	return "unknown";
+}
+
+static int getStateProfilerCharacter(DreamMugenStates* tStates) {
+	for (size_t i = 0; i < gStateProfilerData.mCharacters.size(); i++) {
+		if (gStateProfilerData.mCharacters[i].mStates == tStates) return int(i);
+	}
+
+	StateProfilerCharacter e;
+	e.mStates = tStates;
+	e.mName = getStateProfilerCharacterName(tStates);
+	gStateProfilerData.mCharacters.push_back(e);
+	return int(gStateProfilerData.mCharacters.size()) - 1;
+}
+
+static StateProfilerEntry* getStateProfilerEntry(DreamMugenStates* tStates, int tState, int tController) {
+	int character = getStateProfilerCharacter(tStates);
+	auto key = make_tuple(character, tState, tController);
+	auto it = gStateProfilerData.mEntries.find(key);
+	if (it != gStateProfilerData.mEntries.end()) return &it->second;
+
+	StateProfilerEntry& e = gStateProfilerData.mEntries[key];
+	e.mCharacter = character;
+	e.mState = tState;
+	e.mController = tController;
+	e.mCallAmount = 0;
+	e.mExecutionAmount = 0;
+	e.mNanoseconds = 0;
+	e.mMaximumNanoseconds = 0;
+	e.mHandlerNanoseconds = 0;
+	return &e;
+}
+
+static DreamStateProfilerScope beginStateProfilerScope(StateProfilerEntry* tEntry) {
+	DreamStateProfilerScope ret;
+	ret.mEntry = tEntry;
+	ret.mPreviousEntry = gStateProfilerData.mCurrentController;
+	ret.mStart = getStateProfilerTime();
+	return ret;
+}
+
+static uint64_t endStateProfilerScope(DreamStateProfilerScope tScope) {
+	uint64_t time = getStateProfilerTime() - tScope.mStart;
+	StateProfilerEntry* e = (StateProfilerEntry*)tScope.mEntry;
+	e->mCallAmount++;
+	e->mNanoseconds += time;
+	e->mMaximumNanoseconds = max(e->mMaximumNanoseconds, time);
+	return time;
+}
+
+DreamStateProfilerScope beginDreamStateProfilerMachine(DreamMugenStates* tStates)
+{
+	return beginStateProfilerScope(getStateProfilerEntry(tStates, 0, STATE_PROFILER_MACHINE_CONTROLLER));
+}
+
+void endDreamStateProfilerMachine(DreamStateProfilerScope tScope)
+{
+	endStateProfilerScope(tScope);
+}
+
+DreamStateProfilerScope beginDreamStateProfilerState(DreamMugenStates* tStates, int tState)
+{
+	return beginStateProfilerScope(getStateProfilerEntry(tStates, tState, STATE_PROFILER_STATE_CONTROLLER));
+}
+
+void endDreamStateProfilerState(DreamStateProfilerScope tScope)
+{
+	endStateProfilerScope(tScope);
+}
+
+DreamStateProfilerScope beginDreamStateProfilerController(DreamMugenStates* tStates, int tState, int tController)
+{
+	DreamStateProfilerScope ret = beginStateProfilerScope(getStateProfilerEntry(tStates, tState, tController));
+	gStateProfilerData.mCurrentController = (StateProfilerEntry*)ret.mEntry;
+	return ret;
+}
+
+void endDreamStateProfilerController(DreamStateProfilerScope tScope)
+{
+	endStateProfilerScope(tScope);
+	gStateProfilerData.mCurrentController = (StateProfilerEntry*)tScope.mPreviousEntry;
+}
+
+// handlers can update other state machines, so the controller that ran them is kept in the scope
+DreamStateProfilerScope beginDreamStateProfilerHandler()
+{
+	DreamStateProfilerScope ret;
+	ret.mEntry = gStateProfilerData.mCurrentController;
+	ret.mPreviousEntry = gStateProfilerData.mCurrentController;
+	ret.mStart = getStateProfilerTime();
+	return ret;
+}
+
+void endDreamStateProfilerHandler(DreamStateProfilerScope tScope)
+{
+	StateProfilerEntry* e = (StateProfilerEntry*)tScope.mEntry;
+	if (!e) return;
+	e->mExecutionAmount++;
+	e->mHandlerNanoseconds += getStateProfilerTime() - tScope.mStart;
+}
+
+static const char* getStateProfilerEntryKind(const StateProfilerEntry& e) {
+	if (e.mController == STATE_PROFILER_MACHINE_CONTROLLER) return "machine";
+	if (e.mController == STATE_PROFILER_STATE_CONTROLLER) return "state";
+	return "controller";
+}
+
+static vector<const StateProfilerEntry*> getSortedStateProfilerEntries() {
+	vector<const StateProfilerEntry*> ret;
+	for (auto& entry : gStateProfilerData.mEntries) {
+		ret.push_back(&entry.second);
+	}
+	sort(ret.begin(), ret.end(), [](const StateProfilerEntry* a, const StateProfilerEntry* b) { return a->mNanoseconds > b->mNanoseconds; });
+	return ret;
+}
+
+string getDreamStateProfilerReport(int tAmount)
+{
+	ostringstream ss;
+	ss << "stateprofile " << (gIsDreamStateProfilerActive ? "on" : "off") << ": " << gStateProfilerData.mEntries.size() << " entries";
+
+	vector<const StateProfilerEntry*> entries = getSortedStateProfilerEntries();
+	for (int i = 0; i < int(entries.size()) && i < tAmount; i++) {
+		const StateProfilerEntry& e = *entries[i];
+		ss << "\n" << gStateProfilerData.mCharacters[e.mCharacter].mName << " " << getStateProfilerEntryKind(e);
+		if (e.mController != STATE_PROFILER_MACHINE_CONTROLLER) ss << " " << e.mState;
+		if (e.mController >= 0) ss << "/" << e.mController;
+		ss << ": " << (e.mNanoseconds / 1000) << "us total, " << e.mCallAmount << " calls, " << (e.mNanoseconds / max(e.mCallAmount, 1u)) << "ns avg, " << e.mMaximumNanoseconds << "ns max";
+		if (e.mExecutionAmount) ss << ", " << e.mExecutionAmount << " executed in " << (e.mHandlerNanoseconds / 1000) << "us";
+	}
+	return ss.str();
+}
+
+int writeDreamStateProfile(const char* tPath)
+{
+	if (gStateProfilerData.mEntries.empty()) return 0;
+
+	ostringstream ss;
+	ss << "character,kind,state,controller,calls,executions,total_ns,max_ns,handler_ns\n";
+	vector<const StateProfilerEntry*> entries = getSortedStateProfilerEntries();
+	for (auto e : entries) {
+		ss << gStateProfilerData.mCharacters[e->mCharacter].mName << "," << getStateProfilerEntryKind(*e) << "," << e->mState << "," << e->mController << ",";
+		ss << e->mCallAmount << "," << e->mExecutionAmount << "," << e->mNanoseconds << "," << e->mMaximumNanoseconds << "," << e->mHandlerNanoseconds << "\n";
+	}
+	string text = ss.str();
+	bufferToFile(tPath, makeBuffer((void*)text.c_str(), text.size()));
+	return int(entries.size());
+}
+
+void saveDreamStateProfile()
+{
+	int amount = writeDreamStateProfile("debug/stateprofile.csv");
+	if (amount) logFormat("Wrote %d state profile entries to debug/stateprofile.csv.", amount);
+	resetDreamStateProfiler();
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+
+#include "mugenstatereader.h"
+
+extern int gIsDreamStateProfilerActive; // read inline at every site, so a disabled profiler costs one branch
+
+typedef struct {
+	void* mEntry;
+	void* mPreviousEntry;
+	uint64_t mStart;
+} DreamStateProfilerScope;
+
+void setDreamStateProfilerActive(int tIsActive);
+void resetDreamStateProfiler();
+
+DreamStateProfilerScope beginDreamStateProfilerMachine(DreamMugenStates* tStates);
+void endDreamStateProfilerMachine(DreamStateProfilerScope tScope);
+DreamStateProfilerScope beginDreamStateProfilerState(DreamMugenStates* tStates, int tState);
+void endDreamStateProfilerState(DreamStateProfilerScope tScope);
+DreamStateProfilerScope beginDreamStateProfilerController(DreamMugenStates* tStates, int tState, int tController);
+void endDreamStateProfilerController(DreamStateProfilerScope tScope);
+DreamStateProfilerScope beginDreamStateProfilerHandler();
+void endDreamStateProfilerHandler(DreamStateProfilerScope tScope);
+
+std::string getDreamStateProfilerReport(int tAmount);
+int writeDreamStateProfile(const char* tPath);
+void saveDreamStateProfile();
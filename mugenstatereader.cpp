@@ -1,7 +1,10 @@
 #include "mugenstatereader.h"
 
 #include <assert.h>
+#include <algorithm>
+#include <vector>
 
+#include <prism/file.h>
 #include <prism/log.h>
 #include <prism/system.h>
 #include <prism/memoryhandler.h>
@@ -10,6 +13,9 @@
 #include <prism/stlutil.h>
 
 #include "mugenstatecontrollers.h"
+#include "mugentriggerprofile.h"
+#include "mugenassignmentcache.h"
+#include "config.h"
 
 using namespace std;
 
@@ -35,7 +41,10 @@ static MugenDefScriptGroup* getFirstStateDefGroup(MugenDefScript* tScript) {
 
 static struct {
 	int mCurrentGroup;
+	int mCurrentState;
 
+	vector<DreamMugenState> mLoadedStates;
+	vector<vector<DreamMugenStateController> > mLoadedControllers;
 } gMugenStateDefParseState;
 
 static void handleMugenStateDefType(DreamMugenState* tState, MugenDefScriptGroupElement* tElement) {
@@ -228,20 +237,9 @@ static void handleSingleMugenStateDefElement(MugenStateDefCaller* tCaller, const
 	}
 }
 
-static void removeState(DreamMugenStates* tStates, int tState) {
-	// DreamMugenState* e = &tStates->mStates[tState];
-	// unloadSingleState(e); // TODO: reinsert (https://dev.azure.com/captdc/DogmaRnDA/_workitems/edit/132)
-	tStates->mStates.erase(tState);
-}
-
-static void handleMugenStateDef(DreamMugenStates* tStates, MugenDefScriptGroup* tGroup) {
-
+static DreamMugenState makeEmptyMugenState(int tID) {
 	DreamMugenState state;
-
-	char dummy[100];
-	sscanf(tGroup->mName.data(), "%s %d", dummy, &state.mID);
-	gMugenStateDefParseState.mCurrentGroup = state.mID;
-
+	state.mID = tID;
 	state.mType = MUGEN_STATE_TYPE_STANDING;
 	state.mMoveType = MUGEN_STATE_MOVE_TYPE_IDLE;
 	state.mPhysics = MUGEN_STATE_PHYSICS_NONE;
@@ -257,17 +255,32 @@ static void handleMugenStateDef(DreamMugenStates* tStates, MugenDefScriptGroup*
 	state.mHasFacePlayer2Info = 0;
 	state.mHasPriority = 0;
 
-	state.mControllers = new_vector();
+	state.mControllers = NULL;
+	state.mControllerAmount = 0;
+	state.mSchedule = NULL;
+	state.mVisitGeneration = 0;
+	state.mSource = NULL;
+	state.mSourceOffset = 0;
+	state.mSourceLength = 0;
+	state.mOwnsControllers = 0;
+	return state;
+}
+
+static void handleMugenStateDef(MugenDefScriptGroup* tGroup) {
+	char dummy[100];
+	int id = 0;
+	sscanf(tGroup->mName.data(), "%s %d", dummy, &id);
+	gMugenStateDefParseState.mCurrentGroup = id;
+	DreamMugenState state = makeEmptyMugenState(id);
 
 	MugenStateDefCaller caller;
 	caller.mState = &state;
 	caller.mGroup = tGroup;
 	stl_string_map_map(tGroup->mElements, handleSingleMugenStateDefElement, &caller);
 
-	if (stl_map_contains(tStates->mStates, state.mID)) {
-		removeState(tStates, state.mID); // TODO (https://dev.azure.com/captdc/DogmaRnDA/_workitems/edit/132)
-	}
-	tStates->mStates[state.mID] = state;
+	gMugenStateDefParseState.mCurrentState = int(gMugenStateDefParseState.mLoadedStates.size());
+	gMugenStateDefParseState.mLoadedStates.push_back(state);
+	gMugenStateDefParseState.mLoadedControllers.push_back(vector<DreamMugenStateController>());
 }
 
 static int isMugenStateController(const char* tName) {
@@ -277,20 +290,22 @@ static int isMugenStateController(const char* tName) {
 	return !strcmp("state", firstW);
 }
 
-static void handleMugenStateControllerInDefGroup(DreamMugenStates* tStates, MugenDefScriptGroup* tGroup) {
-	DreamMugenState* state = &tStates->mStates[gMugenStateDefParseState.mCurrentGroup];
+static void handleMugenStateControllerInDefGroup(MugenDefScriptGroup* tGroup) {
+	vector<DreamMugenStateController>& controllers = gMugenStateDefParseState.mLoadedControllers[gMugenStateDefParseState.mCurrentState];
 
-	DreamMugenStateController* controller = parseDreamMugenStateControllerFromGroup(tGroup);
+	setDreamTriggerProfileController(gMugenStateDefParseState.mCurrentGroup, int(controllers.size()));
+	DreamMugenStateController controller;
+	parseDreamMugenStateControllerFromGroup(&controller, tGroup);
 
-	vector_push_back_owned(&state->mControllers, controller);
+	controllers.push_back(controller);
 }
 
-static void handleSingleMugenStateDefGroup(DreamMugenStates* tStates, MugenDefScriptGroup* tGroup) {
+static void handleSingleMugenStateDefGroup(MugenDefScriptGroup* tGroup) {
 
 	if (isMugenStateDef(tGroup->mName.data())) {
-		handleMugenStateDef(tStates, tGroup);
+		handleMugenStateDef(tGroup);
 	} else if (isMugenStateController(tGroup->mName.data())) {
-		handleMugenStateControllerInDefGroup(tStates, tGroup);
+		handleMugenStateControllerInDefGroup(tGroup);
 	}
 	else {
 		logWarningFormat("Unable to determine state def group type %s. Ignoring.", tGroup->mName.data());
@@ -298,29 +313,362 @@ static void handleSingleMugenStateDefGroup(DreamMugenStates* tStates, MugenDefSc
 
 }
 
-static void loadMugenStateDefinitionsFromScript(DreamMugenStates* tStates, MugenDefScript* tScript) {
+static void loadMugenStateDefinitionsFromScript(MugenDefScript* tScript) {
 	MugenDefScriptGroup* current = getFirstStateDefGroup(tScript);
 
 	while (current != NULL) {
-		handleSingleMugenStateDefGroup(tStates, current);
+		handleSingleMugenStateDefGroup(current);
 		
 		current = current->mNext;
 	}
 }
 
+typedef struct DreamMugenStateSource {
+	char* mText;
+	int mReferenceAmount; // states of the file that have not been parsed yet
+	int mCommandID;
+	char* mDefinitionPath;
+} DreamMugenStateSource;
+
+static struct {
+	int mIsActive;
+	int mCommandID;
+	char mDefinitionPath[1024];
+} gMugenStateLazyLoadingData;
+
+void setDreamMugenStateLazyLoadingCharacter(const char* tDefinitionPath, int tCommandID)
+{
+	if (!isDreamLazyStateLoadingActive()) return;
+
+	gMugenStateLazyLoadingData.mIsActive = 1;
+	gMugenStateLazyLoadingData.mCommandID = tCommandID;
+	strcpy(gMugenStateLazyLoadingData.mDefinitionPath, tDefinitionPath);
+}
+
+void resetDreamMugenStateLazyLoadingCharacter()
+{
+	gMugenStateLazyLoadingData.mIsActive = 0;
+}
+
+static void releaseMugenStateSource(DreamMugenState* tState) {
+	DreamMugenStateSource* source = tState->mSource;
+	tState->mSource = NULL;
+	if (--source->mReferenceAmount) return;
+
+	freeMemory(source->mText);
+	freeMemory(source->mDefinitionPath);
+	freeMemory(source);
+}
+
+static int getMugenStateDefLineID(const char* tLine, const char* tEnd, int* oID) {
+	while (tLine < tEnd && (*tLine == ' ' || *tLine == '\t')) tLine++;
+	if (tLine == tEnd || *tLine != '[') return 0;
+
+	char header[100];
+	int length = 0;
+	for (tLine++; tLine < tEnd && *tLine != ']' && *tLine != '\n' && length < 99; tLine++) header[length++] = *tLine;
+	header[length] = '\0';
+
+	char firstW[100];
+	*oID = 0;
+	if (sscanf(header, "%s %d", firstW, oID) < 1) return 0;
+	turnStringLowercase(firstW);
+	return !strcmp("statedef", firstW);
+}
+
+// index only pass, the controllers of each state are parsed out of the kept file text once the state is first looked up
+static void indexMugenStateDefinitionsFromBuffer(Buffer b) {
+	DreamMugenStateSource* source = (DreamMugenStateSource*)allocMemory(sizeof(DreamMugenStateSource));
+	source->mText = (char*)allocMemory(b.mLength + 1);
+	memcpy(source->mText, b.mData, b.mLength);
+	source->mText[b.mLength] = '\0';
+	source->mReferenceAmount = 0;
+	source->mCommandID = gMugenStateLazyLoadingData.mCommandID;
+	source->mDefinitionPath = copyToAllocatedString(gMugenStateLazyLoadingData.mDefinitionPath);
+	const char* end = source->mText + b.mLength;
+	freeBuffer(b);
+
+	vector<DreamMugenState>& loadedStates = gMugenStateDefParseState.mLoadedStates;
+	size_t firstState = loadedStates.size();
+	for (const char* line = source->mText; line < end;) {
+		const char* next = line;
+		while (next < end && *next != '\n') next++;
+		if (next < end) next++;
+
+		int id;
+		if (getMugenStateDefLineID(line, next, &id)) {
+			if (loadedStates.size() > firstState) loadedStates.back().mSourceLength = int(line - source->mText) - loadedStates.back().mSourceOffset;
+			DreamMugenState state = makeEmptyMugenState(id);
+			state.mSource = source;
+			state.mSourceOffset = int(line - source->mText);
+			source->mReferenceAmount++;
+			loadedStates.push_back(state);
+			gMugenStateDefParseState.mLoadedControllers.push_back(vector<DreamMugenStateController>());
+		}
+		line = next;
+	}
+	if (loadedStates.size() > firstState) loadedStates.back().mSourceLength = int(end - source->mText) - loadedStates.back().mSourceOffset;
+
+	if (!source->mReferenceAmount) {
+		logWarningFormat("Unable to find first state definition in %s.", tPath);
+		freeMemory(source->mText);
+		freeMemory(source->mDefinitionPath);
+		freeMemory(source);
+	}
+}
+
+static uint32_t getMugenStateLookupSlot(int tID, uint32_t tMask) {
+	return (uint32_t(tID) * 2654435761u) & tMask;
+}
+
+static void buildMugenStateLookup(DreamMugenStates* tStates) {
+	uint32_t size = 1;
+	while (size < uint32_t(tStates->mStateAmount) * 2) size <<= 1;
+	tStates->mStateLookup = (int32_t*)allocMemory(sizeof(int32_t) * size);
+	tStates->mStateLookupMask = size - 1;
+	for (uint32_t i = 0; i < size; i++) {
+		tStates->mStateLookup[i] = -1;
+	}
+
+	for (int i = 0; i < tStates->mStateAmount; i++) {
+		uint32_t slot = getMugenStateLookupSlot(tStates->mStates[i].mID, tStates->mStateLookupMask);
+		while (tStates->mStateLookup[slot] != -1) slot = (slot + 1) & tStates->mStateLookupMask;
+		tStates->mStateLookup[slot] = i;
+	}
+}
+
+static void freeMugenStateTables(DreamMugenStates* tStates) {
+	if (tStates->mStates) freeMemory(tStates->mStates);
+	if (tStates->mStateLookup) freeMemory(tStates->mStateLookup);
+	if (tStates->mControllers) freeMemory(tStates->mControllers);
+}
+
+#define MUGEN_STATE_SCHEDULE_MINIMUM_GATED_AMOUNT 8
+
+// buckets controllers by the command, tick or animation element gating their trigger, so the handler only needs to evaluate the open buckets
+static DreamMugenStateControllerSchedule* buildMugenStateControllerSchedule(DreamMugenStateController* tControllers, int tControllerAmount) {
+	map<pair<int, int>, vector<int> > buckets;
+	vector<int> ungated;
+	for (int i = 0; i < tControllerAmount; i++) {
+		if (tControllers[i].mGateKind == MUGEN_STATE_CONTROLLER_GATE_NONE) ungated.push_back(i);
+		else buckets[make_pair(int(tControllers[i].mGateKind), int(tControllers[i].mGateValue))].push_back(i);
+	}
+	if (tControllerAmount - int(ungated.size()) < MUGEN_STATE_SCHEDULE_MINIMUM_GATED_AMOUNT) return NULL;
+
+	DreamMugenStateControllerSchedule* e = (DreamMugenStateControllerSchedule*)allocMemory(sizeof(DreamMugenStateControllerSchedule));
+	e->mBucketAmount = int(buckets.size());
+	e->mGateKinds = (uint8_t*)allocMemory(sizeof(uint8_t) * e->mBucketAmount);
+	e->mGateValues = (int*)allocMemory(sizeof(int) * e->mBucketAmount);
+	e->mBucketStarts = (int*)allocMemory(sizeof(int) * (e->mBucketAmount + 2));
+	e->mControllerIndices = (int*)allocMemory(sizeof(int) * tControllerAmount);
+	e->mTimeBucketStart = e->mTimeBucketEnd = 0;
+
+	int bucket = 0;
+	int index = 0;
+	for (auto& entry : buckets) {
+		if (entry.first.first < MUGEN_STATE_CONTROLLER_GATE_TIME) e->mTimeBucketStart = bucket + 1;
+		if (entry.first.first <= MUGEN_STATE_CONTROLLER_GATE_TIME) e->mTimeBucketEnd = bucket + 1;
+		e->mGateKinds[bucket] = (uint8_t)entry.first.first;
+		e->mGateValues[bucket] = entry.first.second;
+		e->mBucketStarts[bucket++] = index;
+		for (int controller : entry.second) e->mControllerIndices[index++] = controller;
+	}
+	e->mBucketStarts[bucket++] = index;
+	for (int controller : ungated) e->mControllerIndices[index++] = controller;
+	e->mBucketStarts[bucket] = index;
+	return e;
+}
+
+static void unloadMugenStateControllerSchedule(DreamMugenStateControllerSchedule* e) {
+	freeMemory(e->mGateKinds);
+	freeMemory(e->mGateValues);
+	freeMemory(e->mBucketStarts);
+	freeMemory(e->mControllerIndices);
+	freeMemory(e);
+}
+
+// consecutive controllers with the same side effect free triggerall share one evaluation of it
+static void linkMugenStateTriggerGuards(DreamMugenStateController* tControllers, int tControllerAmount) {
+	for (int i = 0; i < tControllerAmount; i++) {
+		DreamMugenStateControllerTrigger* trigger = &tControllers[i].mTrigger;
+		if (!trigger->mGuard || !trigger->mIsGuardFreeOfSideEffects) continue;
+
+		DreamMugenStateControllerTrigger* previous = i ? &tControllers[i - 1].mTrigger : NULL;
+		if (previous && previous->mGuardRun != -1 && previous->mGuardHash == trigger->mGuardHash) trigger->mGuardRun = previous->mGuardRun;
+		else trigger->mGuardRun = (int16_t)i;
+	}
+}
+
+typedef struct {
+	DreamMugenState* mState;
+	DreamMugenStateController* mControllers;
+	int mControllerAmount;
+} MugenStateMergeEntry;
+
+// states of the file that was just parsed replace the ones with the same number, then everything is repacked into the flat tables
+static void mergeLoadedMugenStates(DreamMugenStates* tStates) {
+	vector<DreamMugenState>& loadedStates = gMugenStateDefParseState.mLoadedStates;
+	vector<vector<DreamMugenStateController> >& loadedControllers = gMugenStateDefParseState.mLoadedControllers;
+
+	map<int, int> loadedIndices;
+	for (size_t i = 0; i < loadedStates.size(); i++) {
+		auto it = loadedIndices.find(loadedStates[i].mID);
+		if (it != loadedIndices.end() && loadedStates[it->second].mSource) releaseMugenStateSource(&loadedStates[it->second]);
+		loadedIndices[loadedStates[i].mID] = int(i);
+	}
+
+	vector<MugenStateMergeEntry> entries;
+	for (int i = 0; i < tStates->mStateAmount; i++) {
+		DreamMugenState* state = &tStates->mStates[i];
+		if (stl_map_contains(loadedIndices, state->mID)) {
+			if (state->mSource) releaseMugenStateSource(state);
+			continue; // TODO: unload replaced state (https://dev.azure.com/captdc/DogmaRnDA/_workitems/edit/132)
+		}
+		entries.push_back(MugenStateMergeEntry{ state, state->mControllers, state->mControllerAmount });
+	}
+	for (auto& loadedIndex : loadedIndices) {
+		vector<DreamMugenStateController>& controllers = loadedControllers[loadedIndex.second];
+		linkMugenStateTriggerGuards(controllers.data(), int(controllers.size()));
+		loadedStates[loadedIndex.second].mSchedule = buildMugenStateControllerSchedule(controllers.data(), int(controllers.size()));
+		entries.push_back(MugenStateMergeEntry{ &loadedStates[loadedIndex.second], controllers.data(), int(controllers.size()) });
+	}
+	sort(entries.begin(), entries.end(), [](const MugenStateMergeEntry& a, const MugenStateMergeEntry& b) { return a.mState->mID < b.mState->mID; });
+
+	int controllerAmount = 0;
+	for (auto& entry : entries) {
+		controllerAmount += entry.mControllerAmount;
+	}
+
+	DreamMugenStates ret;
+	ret.mStateAmount = int(entries.size());
+	ret.mPendingStateAmount = 0;
+	ret.mStates = ret.mStateAmount ? (DreamMugenState*)allocMemory(sizeof(DreamMugenState) * ret.mStateAmount) : NULL;
+	ret.mControllerAmount = controllerAmount;
+	ret.mControllers = controllerAmount ? (DreamMugenStateController*)allocMemory(sizeof(DreamMugenStateController) * controllerAmount) : NULL;
+	int controllerIndex = 0;
+	for (int i = 0; i < ret.mStateAmount; i++) {
+		ret.mStates[i] = *entries[i].mState;
+		ret.mPendingStateAmount += ret.mStates[i].mSource != NULL;
+		ret.mStates[i].mControllers = ret.mControllers + controllerIndex;
+		ret.mStates[i].mControllerAmount = entries[i].mControllerAmount;
+		for (int j = 0; j < entries[i].mControllerAmount; j++) {
+			ret.mControllers[controllerIndex++] = entries[i].mControllers[j];
+		}
+		if (ret.mStates[i].mOwnsControllers) {
+			// states loaded on demand have their own block, which is replaced by the arena copy
+			if (entries[i].mControllers) freeMemory(entries[i].mControllers);
+			ret.mStates[i].mOwnsControllers = 0;
+		}
+	}
+	buildMugenStateLookup(&ret);
+
+	freeMugenStateTables(tStates);
+	*tStates = ret;
+	loadedStates.clear();
+	loadedControllers.clear();
+}
+
 void loadDreamMugenStateDefinitionsFromFile(DreamMugenStates* tStates, char* tPath) {
-	MugenDefScript script; 
-	loadMugenDefScript(&script, tPath);
-	loadMugenStateDefinitionsFromScript(tStates, &script);
-	unloadMugenDefScript(script);
+	Buffer b = fileToBuffer(tPath);
+	setDreamAssignmentCacheSource(b.mData, b.mLength);
+	if (gMugenStateLazyLoadingData.mIsActive) {
+		indexMugenStateDefinitionsFromBuffer(b);
+	}
+	else {
+		MugenDefScript script; 
+		loadMugenDefScriptFromBufferAndFreeBuffer(&script, b);
+		loadMugenStateDefinitionsFromScript(&script);
+		unloadMugenDefScript(script);
+	}
+	mergeLoadedMugenStates(tStates);
 }
 
 DreamMugenStates createEmptyMugenStates() {
 	DreamMugenStates ret;
-	stl_new_map(ret.mStates);
+	ret.mStates = NULL;
+	ret.mStateAmount = 0;
+	ret.mStateLookup = NULL;
+	ret.mStateLookupMask = 0;
+	ret.mControllers = NULL;
+	ret.mControllerAmount = 0;
+	ret.mPendingStateAmount = 0;
 	return ret;
 }
 
+static DreamMugenState* findMugenState(DreamMugenStates* tStates, int tID) {
+	if (!tStates->mStateAmount) return NULL;
+
+	uint32_t slot = getMugenStateLookupSlot(tID, tStates->mStateLookupMask);
+	while (tStates->mStateLookup[slot] != -1) {
+		DreamMugenState* state = &tStates->mStates[tStates->mStateLookup[slot]];
+		if (state->mID == tID) return state;
+		slot = (slot + 1) & tStates->mStateLookupMask;
+	}
+	return NULL;
+}
+
+// fills the placeholder in place, so pointers to the state stay valid while its controllers get their own allocation
+static void loadPendingMugenState(DreamMugenStates* tStates, DreamMugenState* tState) {
+	DreamMugenStateSource* source = tState->mSource;
+	Buffer b = makeBuffer(allocMemory(tState->mSourceLength), tState->mSourceLength);
+	memcpy(b.mData, source->mText + tState->mSourceOffset, tState->mSourceLength);
+
+	setDreamAssignmentCommandLookupID(source->mCommandID);
+	setDreamTriggerProfileCharacter(source->mDefinitionPath);
+	MugenDefScript script;
+	loadMugenDefScriptFromBufferAndFreeBuffer(&script, b);
+	loadMugenStateDefinitionsFromScript(&script);
+	unloadMugenDefScript(script);
+	resetDreamTriggerProfileCharacter();
+	resetDreamAssignmentCommandLookupID();
+
+	vector<DreamMugenState>& loadedStates = gMugenStateDefParseState.mLoadedStates;
+	vector<vector<DreamMugenStateController> >& loadedControllers = gMugenStateDefParseState.mLoadedControllers;
+	DreamMugenState state = loadedStates.empty() ? makeEmptyMugenState(tState->mID) : loadedStates[0];
+	if (loadedStates.size() != 1 || state.mID != tState->mID) {
+		logWarningFormat("Unable to parse state %d from %s on demand.", tState->mID, source->mDefinitionPath);
+	}
+
+	vector<DreamMugenStateController> controllers;
+	if (!loadedControllers.empty()) controllers.swap(loadedControllers[0]);
+	state.mControllerAmount = int(controllers.size());
+	state.mControllers = state.mControllerAmount ? (DreamMugenStateController*)allocMemory(sizeof(DreamMugenStateController) * state.mControllerAmount) : NULL;
+	for (int i = 0; i < state.mControllerAmount; i++) {
+		state.mControllers[i] = controllers[i];
+	}
+	state.mOwnsControllers = 1;
+	linkMugenStateTriggerGuards(state.mControllers, state.mControllerAmount);
+	state.mSchedule = buildMugenStateControllerSchedule(state.mControllers, state.mControllerAmount);
+	state.mID = tState->mID;
+	state.mVisitGeneration = tState->mVisitGeneration;
+	state.mSource = NULL;
+	loadedStates.clear();
+	loadedControllers.clear();
+
+	releaseMugenStateSource(tState);
+	*tState = state;
+	tStates->mPendingStateAmount--;
+}
+
+DreamMugenState* getDreamMugenState(DreamMugenStates* tStates, int tID) {
+	DreamMugenState* state = findMugenState(tStates, tID);
+	if (state && state->mSource) loadPendingMugenState(tStates, state);
+	return state;
+}
+
+int hasDreamMugenState(DreamMugenStates* tStates, int tID) {
+	return findMugenState(tStates, tID) != NULL;
+}
+
+int warmUpDreamMugenStates(DreamMugenStates* tStates, int tMaximumAmount) {
+	for (int i = 0; i < tStates->mStateAmount && tStates->mPendingStateAmount && tMaximumAmount; i++) {
+		if (!tStates->mStates[i].mSource) continue;
+		loadPendingMugenState(tStates, &tStates->mStates[i]);
+		tMaximumAmount--;
+	}
+	return tStates->mPendingStateAmount;
+}
+
 static DreamMugenConstants makeEmptyMugenConstants() {
 	DreamMugenConstants ret;
 	ret.mStates = createEmptyMugenStates();
@@ -457,20 +805,16 @@ static void loadMugenConstantsFromScript(DreamMugenConstants* tConstants, MugenD
 
 DreamMugenConstants loadDreamMugenConstantsFile(char * tPath)
 {
+	Buffer b = fileToBuffer(tPath);
+	setDreamAssignmentCacheSource(b.mData, b.mLength);
 	MugenDefScript script; 
-	loadMugenDefScript(&script, tPath);
+	loadMugenDefScriptFromBufferAndFreeBuffer(&script, b);
 	DreamMugenConstants ret = makeEmptyMugenConstants();
 	loadMugenConstantsFromScript(&ret, &script);
 	unloadMugenDefScript(script);
 	return ret;
 }
 
-static void unloadSingleController(void* tCaller, void* tData) {
-	(void)tCaller;
-	DreamMugenStateController* e = (DreamMugenStateController*)tData;
-	unloadDreamMugenStateController(e);
-}
-
 static void unloadSingleState(DreamMugenState& e) {
 	if (e.mIsChangingAnimation) {
 		destroyDreamMugenAssignment(e.mAnimation);
@@ -497,24 +841,40 @@ static void unloadSingleState(DreamMugenState& e) {
 		destroyDreamMugenAssignment(e.mPriority);
 	}
 
-	vector_map(&e.mControllers, unloadSingleController, NULL);
-	delete_vector(&e.mControllers);
-}
-
-static int unloadSingleStateCB(void* tCaller, DreamMugenState& e) {
-	(void)tCaller;
-
-	unloadSingleState(e);
-
-	return 1;
+	for (int i = 0; i < e.mControllerAmount; i++) {
+		unloadDreamMugenStateController(&e.mControllers[i]);
+	}
+	if (e.mSchedule) {
+		unloadMugenStateControllerSchedule(e.mSchedule);
+	}
+	if (e.mOwnsControllers && e.mControllers) {
+		freeMemory(e.mControllers);
+	}
+	if (e.mSource) {
+		releaseMugenStateSource(&e);
+	}
 }
 
 static void unloadMugenStates(DreamMugenStates* tStates) {
-	stl_int_map_remove_predicate(tStates->mStates, unloadSingleStateCB);
-	stl_delete_map(tStates->mStates);
+	for (int i = 0; i < tStates->mStateAmount; i++) {
+		unloadSingleState(tStates->mStates[i]);
+	}
+	freeMugenStateTables(tStates);
+	*tStates = createEmptyMugenStates();
 }
 
 void unloadDreamMugenConstantsFile(DreamMugenConstants * tConstants)
 {
 	unloadMugenStates(&tConstants->mStates);
 }
+
+void flushDreamMugenStateTriggerProfiles(DreamMugenStates* tStates)
+{
+	for (int i = 0; i < tStates->mStateAmount; i++) {
+		DreamMugenState* state = &tStates->mStates[i];
+		for (int j = 0; j < state->mControllerAmount; j++) {
+			DreamMugenTriggerProfile* profile = state->mControllers[j].mTrigger.mProfile;
+			if (profile) flushDreamMugenTriggerProfile(profile);
+		}
+	}
+}
@@ -157,17 +157,38 @@ enum DreamMugenStoryStateControllerType : uint8_t {
 };
 
 
+struct DreamMugenTriggerProfile;
+struct DreamPlayer;
+
+enum DreamMugenStateControllerGateKind : uint8_t {
+	MUGEN_STATE_CONTROLLER_GATE_NONE,
+	MUGEN_STATE_CONTROLLER_GATE_COMMAND,
+	MUGEN_STATE_CONTROLLER_GATE_TIME,
+	MUGEN_STATE_CONTROLLER_GATE_ANIMATION_ELEMENT,
+	MUGEN_STATE_CONTROLLER_GATE_ANIMATION_ELEMENT_TIME,
+};
+
 typedef struct {
+	DreamMugenAssignment* mGuard; // triggerall, evaluated once before the trigger groups
 	DreamMugenAssignment* mAssignment;
+	struct DreamMugenTriggerProfile* mProfile;
 
+	uint64_t mGuardHash;
+	int16_t mGuardRun; // first controller of the consecutive ones sharing this guard, -1 if the guard is never shared
+	uint8_t mIsGuardFreeOfSideEffects;
+	uint8_t mIsFreeOfSideEffects;
 } DreamMugenStateControllerTrigger;
 
-typedef struct {
+typedef struct DreamMugenStateController {
 	DreamMugenStateControllerTrigger mTrigger;
 	void* mData;
+	int(*mHandler)(struct DreamMugenStateController*, struct DreamPlayer*); // resolved from mType at parse time
+	void(*mUnloader)(struct DreamMugenStateController*);
 
 	int16_t mPersistence;
 	int16_t mAccessAmount;
+	int16_t mGateValue;
+	uint8_t mGateKind; // the trigger can only pass while this gate is open, see DreamMugenStateControllerGateKind
 	uint8_t mType;
 } DreamMugenStateController;
 
@@ -293,7 +314,19 @@ typedef enum {
 } DreamMugenStatePhysics;
 
 typedef struct {
-	Vector mControllers;
+	int mBucketAmount;
+	uint8_t* mGateKinds; // buckets are sorted by gate kind and value
+	int* mGateValues;
+	int* mBucketStarts; // bucket i holds the controllers behind gate i, bucket mBucketAmount the ungated ones
+	int* mControllerIndices; // ascending within each bucket
+	int mTimeBucketStart;
+	int mTimeBucketEnd;
+} DreamMugenStateControllerSchedule;
+
+typedef struct {
+	DreamMugenStateController* mControllers;
+	int mControllerAmount;
+	DreamMugenStateControllerSchedule* mSchedule; // NULL unless enough controllers are gated
 	int mID;
 	DreamMugenStateType mType;
 	DreamMugenStateMoveType mMoveType;
@@ -331,10 +364,24 @@ typedef struct {
 
 	int mHasPriority;
 	DreamMugenAssignment* mPriority;
+
+	uint32_t mVisitGeneration;
+
+	struct DreamMugenStateSource* mSource; // set while only the position of the state in its file is known, parsed on first lookup
+	int mSourceOffset;
+	int mSourceLength;
+	int mOwnsControllers;
 } DreamMugenState;
 
 typedef struct {
-	std::map<int, DreamMugenState> mStates;
+	DreamMugenState* mStates; // sorted by mID
+	int mStateAmount;
+	int32_t* mStateLookup; // open addressed, state number to index into mStates
+	uint32_t mStateLookupMask;
+
+	DreamMugenStateController* mControllers; // single arena, contiguous per state, lazily parsed states own theirs
+	int mControllerAmount;
+	int mPendingStateAmount;
 } DreamMugenStates;
 
 typedef struct {
@@ -348,5 +395,12 @@ typedef struct {
 
 DreamMugenConstants loadDreamMugenConstantsFile(char* tPath);
 void unloadDreamMugenConstantsFile(DreamMugenConstants* tConstants);
+void flushDreamMugenStateTriggerProfiles(DreamMugenStates* tStates);
 void loadDreamMugenStateDefinitionsFromFile(DreamMugenStates* tStates, char* tPath);
-DreamMugenStates createEmptyMugenStates();
\ No newline at end of file
+DreamMugenStates createEmptyMugenStates();
+DreamMugenState* getDreamMugenState(DreamMugenStates* tStates, int tID);
+int hasDreamMugenState(DreamMugenStates* tStates, int tID);
+
+void setDreamMugenStateLazyLoadingCharacter(const char* tDefinitionPath, int tCommandID);
+void resetDreamMugenStateLazyLoadingCharacter();
+int warmUpDreamMugenStates(DreamMugenStates* tStates, int tMaximumAmount);
\ No newline at end of file
@@ -0,0 +1,362 @@
+#include "mugentriggerprofile.h"
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <sstream>
+#include <string>
+#include <math.h>
+
+#include <prism/file.h>
+#include <prism/log.h>
+#include <prism/memoryhandler.h>
+
+#include "mugenassignmentevaluator.h"
+#include "config.h"
+
+using namespace std;
+
+#define TRIGGER_PROFILE_MINIMUM_EVALUATION_AMOUNT 32
+
+typedef struct {
+	uint32_t mEvaluationAmount;
+	uint32_t mTrueAmount;
+	uint64_t mNanoseconds;
+} TriggerProfileEntry;
+
+typedef struct {
+	string mPath;
+	map<string, TriggerProfileEntry> mEntries;
+	int mHasChanged;
+} TriggerProfileCharacter;
+
+static struct {
+	vector<TriggerProfileCharacter> mCharacters;
+	int mActiveCharacter = -1;
+	int mActiveState;
+	int mActiveController;
+} gTriggerProfileData;
+
+static string getTriggerProfilePath(const char* tDefinitionPath) {
+	string path = tDefinitionPath;
+	size_t dot = path.find_last_of('.');
+	size_t slash = path.find_last_of("/\\");
+	if (dot != string::npos && (slash == string::npos || dot > slash)) {
+		path = path.substr(0, dot);
+	}
+	return path + ".tprof";
+}
+
+static string getTriggerProfileKey(int tState, int tController, int tGroup, int tIndex, uint32_t tHash) {
+	char key[100];
+	sprintf(key, "%d %d %d %d %08x", tState, tController, tGroup, tIndex, tHash);
+	return key;
+}
+
+static void loadTriggerProfileFile(TriggerProfileCharacter* tCharacter) {
+	if (!isFile(tCharacter->mPath.data())) return;
+
+	Buffer b = fileToBuffer(tCharacter->mPath.data());
+	string content((char*)b.mData, b.mLength);
+	freeBuffer(b);
+
+	istringstream ss(content);
+	string line;
+	while (getline(ss, line)) {
+		int state, controller, group, index;
+		unsigned int hash, evaluationAmount, trueAmount;
+		unsigned long long nanoseconds;
+		if (sscanf(line.data(), "%d %d %d %d %x %u %u %llu", &state, &controller, &group, &index, &hash, &evaluationAmount, &trueAmount, &nanoseconds) != 8) {
+			logWarningFormat("Unable to parse trigger profile line %s in %s. Ignoring.", line.data(), tCharacter->mPath.data());
+			continue;
+		}
+
+		TriggerProfileEntry& e = tCharacter->mEntries[getTriggerProfileKey(state, controller, group, index, hash)];
+		e.mEvaluationAmount = evaluationAmount;
+		e.mTrueAmount = trueAmount;
+		e.mNanoseconds = nanoseconds;
+	}
+}
+
+void setDreamTriggerProfileCharacter(const char* tDefinitionPath)
+{
+	if (!isDreamTriggerProfileRecordingActive() && !isDreamTriggerProfileUseActive()) return;
+
+	string path = getTriggerProfilePath(tDefinitionPath);
+	for (size_t i = 0; i < gTriggerProfileData.mCharacters.size(); i++) {
+		if (gTriggerProfileData.mCharacters[i].mPath == path) {
+			gTriggerProfileData.mActiveCharacter = int(i);
+			return;
+		}
+	}
+
+	TriggerProfileCharacter character;
+	character.mPath = path;
+	character.mHasChanged = 0;
+	loadTriggerProfileFile(&character);
+	gTriggerProfileData.mCharacters.push_back(character);
+	gTriggerProfileData.mActiveCharacter = int(gTriggerProfileData.mCharacters.size()) - 1;
+}
+
+void resetDreamTriggerProfileCharacter()
+{
+	gTriggerProfileData.mActiveCharacter = -1;
+}
+
+void setDreamTriggerProfileController(int tState, int tControllerIndex)
+{
+	gTriggerProfileData.mActiveState = tState;
+	gTriggerProfileData.mActiveController = tControllerIndex;
+}
+
+static TriggerProfileEntry* findTriggerProfileEntry(TriggerProfileCharacter* tCharacter, int tState, int tController, DreamMugenTriggerConjunct* tConjunct) {
+	auto it = tCharacter->mEntries.find(getTriggerProfileKey(tState, tController, tConjunct->mGroup, tConjunct->mIndex, tConjunct->mHash));
+	if (it == tCharacter->mEntries.end()) return NULL;
+	return &it->second;
+}
+
+// expected cost of a conjunct per rejection, ordering by it minimizes the expected cost of the whole chain
+static double getTriggerProfileEntryRank(TriggerProfileEntry* e) {
+	double cost = e->mNanoseconds / double(e->mEvaluationAmount);
+	double falseRate = 1.0 - e->mTrueAmount / double(e->mEvaluationAmount);
+	if (falseRate <= 0) return HUGE_VAL;
+	return cost / falseRate;
+}
+
+static int rankTriggerConjunctRun(vector<DreamMugenTriggerConjunct>& tConjuncts, size_t tStart, size_t tEnd, vector<pair<double, DreamMugenTriggerConjunct> >& oRun) {
+	TriggerProfileCharacter* character = &gTriggerProfileData.mCharacters[gTriggerProfileData.mActiveCharacter];
+
+	oRun.clear();
+	for (size_t i = tStart; i < tEnd; i++) {
+		TriggerProfileEntry* e = findTriggerProfileEntry(character, gTriggerProfileData.mActiveState, gTriggerProfileData.mActiveController, &tConjuncts[i]);
+		if (!e || e->mEvaluationAmount < TRIGGER_PROFILE_MINIMUM_EVALUATION_AMOUNT) return 0;
+		oRun.push_back(make_pair(getTriggerProfileEntryRank(e), tConjuncts[i]));
+	}
+	return 1;
+}
+
+static void reorderTriggerConjuncts(vector<DreamMugenTriggerConjunct>& tConjuncts) {
+	vector<pair<double, DreamMugenTriggerConjunct> > run;
+	size_t i = 0;
+	while (i < tConjuncts.size()) {
+		size_t end = i;
+		while (end < tConjuncts.size() && tConjuncts[end].mGroup == tConjuncts[i].mGroup && tConjuncts[end].mIsReorderable) end++;
+		if (end - i < 2 || !rankTriggerConjunctRun(tConjuncts, i, end, run)) {
+			i = max(i + 1, end);
+			continue;
+		}
+
+		stable_sort(run.begin(), run.end(), [](const pair<double, DreamMugenTriggerConjunct>& a, const pair<double, DreamMugenTriggerConjunct>& b) { return a.first < b.first; });
+		for (size_t j = 0; j < run.size(); j++) {
+			tConjuncts[i + j] = run[j].second;
+		}
+		i = end;
+	}
+}
+
+static DreamMugenAssignment* makeTriggerAssignmentFromConjuncts(vector<DreamMugenTriggerConjunct>& tConjuncts, DreamMugenAssignment** oGuard) {
+	DreamMugenAssignment* allRoot = NULL;
+	size_t i = 0;
+	while (i < tConjuncts.size() && !tConjuncts[i].mGroup) {
+		allRoot = makeDreamAndMugenAssignment(allRoot, tConjuncts[i++].mAssignment);
+	}
+	*oGuard = allRoot;
+
+	DreamMugenAssignment* root = NULL;
+	while (i < tConjuncts.size()) {
+		DreamMugenAssignment* groupRoot = NULL;
+		int group = tConjuncts[i].mGroup;
+		while (i < tConjuncts.size() && tConjuncts[i].mGroup == group) {
+			groupRoot = makeDreamAndMugenAssignment(groupRoot, tConjuncts[i++].mAssignment);
+		}
+		root = makeDreamOrMugenAssignment(root, groupRoot);
+	}
+
+	if (!root) {
+		root = makeDreamTrueMugenAssignment();
+	}
+	return root;
+}
+
+static DreamMugenTriggerProfile* makeTriggerProfileFromConjuncts(vector<DreamMugenTriggerConjunct>& tConjuncts) {
+	DreamMugenTriggerProfile* e = (DreamMugenTriggerProfile*)allocMemory(sizeof(DreamMugenTriggerProfile));
+	e->mCharacter = gTriggerProfileData.mActiveCharacter;
+	e->mState = gTriggerProfileData.mActiveState;
+	e->mController = gTriggerProfileData.mActiveController;
+	e->mConjunctAmount = int(tConjuncts.size());
+	e->mConjuncts = (DreamMugenTriggerConjunct*)allocMemory(sizeof(DreamMugenTriggerConjunct) * tConjuncts.size());
+	for (size_t i = 0; i < tConjuncts.size(); i++) {
+		e->mConjuncts[i] = tConjuncts[i];
+		e->mConjuncts[i].mEvaluationAmount = 0;
+		e->mConjuncts[i].mTrueAmount = 0;
+		e->mConjuncts[i].mNanoseconds = 0;
+		compileDreamAssignmentProgram(&e->mConjuncts[i].mAssignment);
+	}
+	return e;
+}
+
+DreamMugenAssignment* makeDreamMugenTriggerFromConjuncts(vector<DreamMugenTriggerConjunct>& tConjuncts, DreamMugenAssignment** oGuard, DreamMugenTriggerProfile** oProfile)
+{
+	*oGuard = NULL;
+	*oProfile = NULL;
+	if (gTriggerProfileData.mActiveCharacter == -1) return makeTriggerAssignmentFromConjuncts(tConjuncts, oGuard);
+
+	if (isDreamTriggerProfileUseActive()) {
+		reorderTriggerConjuncts(tConjuncts);
+	}
+
+	if (isDreamTriggerProfileRecordingActive() && !tConjuncts.empty()) {
+		*oProfile = makeTriggerProfileFromConjuncts(tConjuncts);
+		return NULL;
+	}
+
+	return makeTriggerAssignmentFromConjuncts(tConjuncts, oGuard);
+}
+
+static int evaluateTriggerProfileConjunct(DreamMugenTriggerConjunct* tConjunct, DreamPlayer* tPlayer) {
+	auto start = chrono::steady_clock::now();
+	int ret = evaluateDreamAssignment(&tConjunct->mAssignment, tPlayer);
+	auto end = chrono::steady_clock::now();
+
+	tConjunct->mEvaluationAmount++;
+	tConjunct->mTrueAmount += ret ? 1 : 0;
+	tConjunct->mNanoseconds += chrono::duration_cast<chrono::nanoseconds>(end - start).count();
+	return ret;
+}
+
+int evaluateDreamMugenTriggerProfile(DreamMugenTriggerProfile* tProfile, DreamPlayer* tPlayer)
+{
+	DreamMugenTriggerConjunct* conjuncts = tProfile->mConjuncts;
+	int i = 0;
+	for (; i < tProfile->mConjunctAmount && !conjuncts[i].mGroup; i++) {
+		if (!evaluateTriggerProfileConjunct(&conjuncts[i], tPlayer)) return 0;
+	}
+	if (i == tProfile->mConjunctAmount) return 1;
+
+	while (i < tProfile->mConjunctAmount) {
+		int group = conjuncts[i].mGroup;
+		int isTrue = 1;
+		for (; i < tProfile->mConjunctAmount && conjuncts[i].mGroup == group; i++) {
+			if (!isTrue) continue;
+			isTrue = evaluateTriggerProfileConjunct(&conjuncts[i], tPlayer);
+		}
+		if (isTrue) return 1;
+	}
+
+	return 0;
+}
+
+void flushDreamMugenTriggerProfile(DreamMugenTriggerProfile* tProfile)
+{
+	TriggerProfileCharacter* character = &gTriggerProfileData.mCharacters[tProfile->mCharacter];
+	for (int i = 0; i < tProfile->mConjunctAmount; i++) {
+		DreamMugenTriggerConjunct* conjunct = &tProfile->mConjuncts[i];
+		if (!conjunct->mEvaluationAmount) continue;
+
+		TriggerProfileEntry& e = character->mEntries[getTriggerProfileKey(tProfile->mState, tProfile->mController, conjunct->mGroup, conjunct->mIndex, conjunct->mHash)];
+		e.mEvaluationAmount += conjunct->mEvaluationAmount;
+		e.mTrueAmount += conjunct->mTrueAmount;
+		e.mNanoseconds += conjunct->mNanoseconds;
+		character->mHasChanged = 1;
+
+		conjunct->mEvaluationAmount = 0;
+		conjunct->mTrueAmount = 0;
+		conjunct->mNanoseconds = 0;
+	}
+}
+
+void unloadDreamMugenTriggerProfile(DreamMugenTriggerProfile* tProfile)
+{
+	// conjunct assignments may be shared with other controllers through interning, so they're left to the tree owner
+	flushDreamMugenTriggerProfile(tProfile);
+	freeMemory(tProfile->mConjuncts);
+	freeMemory(tProfile);
+}
+
+void saveDreamMugenTriggerProfiles()
+{
+	for (auto& character : gTriggerProfileData.mCharacters) {
+		if (!character.mHasChanged) continue;
+
+		ostringstream ss;
+		for (auto& entry : character.mEntries) {
+			ss << entry.first << " " << entry.second.mEvaluationAmount << " " << entry.second.mTrueAmount << " " << entry.second.mNanoseconds << "\n";
+		}
+		string text = ss.str();
+		bufferToFile(character.mPath.data(), makeBuffer((void*)text.c_str(), text.size()));
+		character.mHasChanged = 0;
+	}
+}
+
+typedef struct {
+	const char* mText;
+	uint16_t mGroup;
+	uint32_t mEvaluationAmount;
+	uint32_t mTrueAmount;
+	uint64_t mNanoseconds;
+} TriggerProfileSelfCheckCase;
+
+// fixed counters with a known best order: ranked runs are sorted, side effects and redirects split runs and under-sampled runs stay as they are
+int checkDreamMugenTriggerProfileReordering()
+{
+	static const TriggerProfileSelfCheckCase cases[] = {
+		{ "var(3) > 10", 0, 100, 90, 1000 },
+		{ "var(1) = 2", 0, 100, 10, 1000 },
+		{ "(var(2) := 1) || 1", 0, 0, 0, 0 },
+		{ "var(4) > 0", 0, 100, 50, 1000 },
+		{ "var(5) = 200", 0, 100, 50, 100 },
+		{ "var(6) > 100", 1, 100, 0, 5000 },
+		{ "var(7) > 1000", 1, 10, 0, 1 },
+		{ "numhelper(1000) > 0", 2, 100, 90, 5000 },
+		{ "helper(1000), var(0) = 1", 2, 100, 10, 100 },
+	};
+	static const uint16_t expectedOrder[] = { 1, 0, 2, 4, 3, 5, 6, 7, 8 };
+
+	TriggerProfileCharacter character;
+	character.mHasChanged = 0;
+	vector<DreamMugenTriggerConjunct> conjuncts;
+	for (uint16_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+		DreamMugenTriggerConjunct conjunct;
+		conjunct.mAssignment = parseDreamMugenAssignmentFromString(cases[i].mText);
+		conjunct.mHash = i;
+		conjunct.mGroup = cases[i].mGroup;
+		conjunct.mIndex = i;
+		conjunct.mIsFreeOfSideEffects = (uint8_t)isDreamAssignmentFreeOfSideEffects(conjunct.mAssignment);
+		conjunct.mIsReorderable = (uint8_t)isDreamAssignmentReorderable(conjunct.mAssignment);
+		conjunct.mEvaluationAmount = 0;
+		conjunct.mTrueAmount = 0;
+		conjunct.mNanoseconds = 0;
+		conjuncts.push_back(conjunct);
+		if (!cases[i].mEvaluationAmount) continue;
+
+		TriggerProfileEntry& e = character.mEntries[getTriggerProfileKey(0, 0, conjunct.mGroup, conjunct.mIndex, conjunct.mHash)];
+		e.mEvaluationAmount = cases[i].mEvaluationAmount;
+		e.mTrueAmount = cases[i].mTrueAmount;
+		e.mNanoseconds = cases[i].mNanoseconds;
+	}
+
+	int previousCharacter = gTriggerProfileData.mActiveCharacter;
+	int previousState = gTriggerProfileData.mActiveState;
+	int previousController = gTriggerProfileData.mActiveController;
+	gTriggerProfileData.mCharacters.push_back(character);
+	gTriggerProfileData.mActiveCharacter = int(gTriggerProfileData.mCharacters.size()) - 1;
+	gTriggerProfileData.mActiveState = 0;
+	gTriggerProfileData.mActiveController = 0;
+	reorderTriggerConjuncts(conjuncts);
+	gTriggerProfileData.mCharacters.pop_back();
+	gTriggerProfileData.mActiveCharacter = previousCharacter;
+	gTriggerProfileData.mActiveState = previousState;
+	gTriggerProfileData.mActiveController = previousController;
+
+	int ret = 1;
+	for (size_t i = 0; i < conjuncts.size(); i++) {
+		if (conjuncts[i].mIndex != expectedOrder[i]) ret = 0;
+		destroyDreamMugenAssignment(conjuncts[i].mAssignment);
+	}
+	if (!ret) {
+		ostringstream ss;
+		for (auto& conjunct : conjuncts) ss << conjunct.mIndex << " ";
+		logWarningFormat("Trigger reordering self check produced order %s.", ss.str().data());
+	}
+	return ret;
+}
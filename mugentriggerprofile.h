@@ -0,0 +1,39 @@
+#pragma once
+
+#include <vector>
+
+#include "mugenassignment.h"
+#include "playerdefinition.h"
+
+typedef struct {
+	DreamMugenAssignment* mAssignment;
+	uint32_t mHash;
+	uint16_t mGroup; // 0 is triggerall, n is triggern
+	uint16_t mIndex;
+	uint8_t mIsFreeOfSideEffects;
+	uint8_t mIsReorderable; // free of side effects and not relying on an earlier guard like numhelper
+
+	uint32_t mEvaluationAmount;
+	uint32_t mTrueAmount;
+	uint64_t mNanoseconds;
+} DreamMugenTriggerConjunct;
+
+typedef struct DreamMugenTriggerProfile {
+	int mCharacter;
+	int mState;
+	int mController;
+	int mConjunctAmount;
+	DreamMugenTriggerConjunct* mConjuncts;
+} DreamMugenTriggerProfile;
+
+void setDreamTriggerProfileCharacter(const char* tDefinitionPath);
+void resetDreamTriggerProfileCharacter();
+void setDreamTriggerProfileController(int tState, int tControllerIndex);
+
+DreamMugenAssignment* makeDreamMugenTriggerFromConjuncts(std::vector<DreamMugenTriggerConjunct>& tConjuncts, DreamMugenAssignment** oGuard, DreamMugenTriggerProfile** oProfile);
+int evaluateDreamMugenTriggerProfile(DreamMugenTriggerProfile* tProfile, DreamPlayer* tPlayer);
+void flushDreamMugenTriggerProfile(DreamMugenTriggerProfile* tProfile);
+void unloadDreamMugenTriggerProfile(DreamMugenTriggerProfile* tProfile);
+
+void saveDreamMugenTriggerProfiles();
+int checkDreamMugenTriggerProfileReordering();
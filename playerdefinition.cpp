@@ -38,6 +38,8 @@
 #include "pausecontrollers.h"
 #include "config.h"
 #include "mugenassignmentevaluator.h"
+#include "mugentriggerprofile.h"
+#include "mugenassignmentcache.h"
 
 using namespace std;
 
@@ -134,6 +136,9 @@ static void loadPlayerFiles(char* tPath, DreamPlayer* tPlayer, MugenDefScript* t
 	logMemoryPlatform();
 
 	setDreamAssignmentCommandLookupID(tPlayer->mCommandID);
+	setDreamAssignmentCacheCharacter(tPath, scriptPath);
+	setDreamMugenStateLazyLoadingCharacter(tPath, tPlayer->mCommandID);
+	setDreamTriggerProfileCharacter(tPath);
 	getMugenDefStringOrDefault(file, tScript, "Files", "cns", "");
 	assert(strcmp("", file));
 	sprintf(scriptPath, "%s%s", path, file);
@@ -167,6 +172,9 @@ static void loadPlayerFiles(char* tPath, DreamPlayer* tPlayer, MugenDefScript* t
 	sprintf(scriptPath, "%s%s", path, file);
 	loadDreamMugenStateDefinitionsFromFile(&tPlayer->mHeader->mFiles.mConstants.mStates, scriptPath);
 
+	resetDreamTriggerProfileCharacter();
+	resetDreamAssignmentCacheCharacter();
+	resetDreamMugenStateLazyLoadingCharacter();
 	resetDreamAssignmentCommandLookupID();
 
 	getMugenDefStringOrDefault(file, tScript, "Files", "anim", "");
@@ -470,7 +478,9 @@ static void unloadSinglePlayer(DreamPlayer* /*p*/, DreamPlayerHeader* tHeader) {
 }
 
 static void unloadPlayerHeader(int i) {
-	gPlayerDefinition.mPlayerHeader[i].mFiles.mConstants.mStates.mStates = std::map<int, DreamMugenState>();
+	// the states below are dropped without being unloaded, so recorded trigger counters have to be merged first
+	flushDreamMugenStateTriggerProfiles(&gPlayerDefinition.mPlayerHeader[i].mFiles.mConstants.mStates);
+	gPlayerDefinition.mPlayerHeader[i].mFiles.mConstants.mStates = createEmptyMugenStates();
 
 	gPlayerDefinition.mPlayerHeader[i].mCustomOverrides.mHasCustomDisplayName = 0;
 }
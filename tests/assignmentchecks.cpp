@@ -0,0 +1,136 @@
+#include <stdio.h>
+#include <string>
+
+#include <prism/log.h>
+
+#include "mugenassignment.h"
+#include "mugenassignmentevaluator.h"
+#include "mugentriggerprofile.h"
+#include "playerdefinition.h"
+
+#include "stubplayer.h"
+
+using namespace std;
+
+typedef struct {
+	const char* mFoldedText;
+	const char* mRuntimeText; // same computation behind abs() so it can't be folded at parse time
+	const char* mExpected;
+} AssignmentCheckCase;
+
+static const AssignmentCheckCase gAssignmentCheckCases[] = {
+	{ "1 + 2 * 3", "abs(1) + abs(2) * abs(3)", "7" },
+	{ "(1 + 2) * 3", "(abs(1) + abs(2)) * abs(3)", "9" },
+	{ "7 / 2", "abs(7) / abs(2)", "3" },
+	{ "7.0 / 2", "abs(7.0) / abs(2)", "3.5" },
+	{ "7 % 3", "abs(7) % abs(3)", "1" },
+	{ "2 ** -1", "abs(2) ** -abs(1)", "0.5" },
+	{ "-(2.5)", "-abs(2.5)", "-2.5" },
+	{ "6 & 3", "abs(6) & abs(3)", "2" },
+	{ "6 | 3", "abs(6) | abs(3)", "7" },
+	{ "3 > 2.5", "abs(3) > abs(2.5)", "1" },
+	{ "1 = 1.0", "abs(1) = abs(1.0)", "1" },
+	{ "5 != 5", "abs(5) != abs(5)", "0" },
+	{ "!3", "!abs(3)", "0" },
+	{ "0 && 1", "abs(0) && abs(1)", "0" },
+};
+
+static int isAssignmentCheckConstant(DreamMugenAssignment* tAssignment) {
+	return tAssignment->mType == MUGEN_ASSIGNMENT_TYPE_FIXED_BOOLEAN || tAssignment->mType == MUGEN_ASSIGNMENT_TYPE_NUMBER || tAssignment->mType == MUGEN_ASSIGNMENT_TYPE_FLOAT || tAssignment->mType == MUGEN_ASSIGNMENT_TYPE_STRING;
+}
+
+// evaluates the text through the tree evaluator and the compiled program, both have to return the expected value
+static int checkAssignmentText(const char* tText, const char* tExpected, int tMustFold, DreamPlayer* tPlayer) {
+	DreamMugenAssignment* assignment = parseDreamMugenAssignmentFromString(tText);
+	int isFolded = isAssignmentCheckConstant(assignment);
+	string treeResult, programResult;
+	evaluateDreamAssignmentAndReturnAsString(treeResult, &assignment, tPlayer);
+	compileDreamAssignmentProgram(&assignment);
+	evaluateDreamAssignmentAndReturnAsString(programResult, &assignment, tPlayer);
+	destroyDreamMugenAssignment(assignment);
+
+	int ret = 1;
+	if (tMustFold != isFolded) {
+		logWarningFormat("%s was %s at parse time.", tText, isFolded ? "folded" : "not folded");
+		ret = 0;
+	}
+	if (treeResult != tExpected || programResult != tExpected) {
+		logWarningFormat("%s expected %s, tree returned %s, program returned %s", tText, tExpected, treeResult.data(), programResult.data());
+		ret = 0;
+	}
+	return ret;
+}
+
+typedef struct {
+	const char* mText;
+	const char* mExpected; // NULL if only the side effect is checked
+	int mExpectedVariable;
+} AssignmentSideEffectCase;
+
+#define ASSIGNMENT_CHECK_VARIABLE 1
+
+// var(1) starts at 0 for every evaluation, the expected value shows whether the side effect branch ran
+static const AssignmentSideEffectCase gAssignmentSideEffectCases[] = {
+	{ "cond(1, 2, (var(1) := 5))", "2", 0 },
+	{ "cond(0, (var(1) := 5), 3)", "3", 0 },
+	{ "cond(abs(1), 2, (var(1) := 5))", "2", 0 },
+	{ "ifelse(1, 2, (var(1) := 5))", "2", 5 },
+	{ "ifelse(abs(0), (var(1) := 5), 3)", "3", 5 },
+	{ "0 && (var(1) := 5)", "0", 0 },
+	{ "abs(0) && (var(1) := 5)", "0", 0 },
+	{ "abs(1) || (var(1) := 5)", "1", 0 },
+	{ "abs(1) && (var(1) := 5)", NULL, 5 },
+	{ "abs(0) || (var(1) := 5)", NULL, 5 },
+};
+
+static int checkAssignmentSideEffectCase(const AssignmentSideEffectCase& tCase, DreamPlayer* tPlayer) {
+	DreamMugenAssignment* assignment = parseDreamMugenAssignmentFromString(tCase.mText);
+	string results[2];
+	int variables[2];
+	for (int i = 0; i < 2; i++) {
+		if (i) compileDreamAssignmentProgram(&assignment);
+		setPlayerVariable(tPlayer, ASSIGNMENT_CHECK_VARIABLE, 0);
+		evaluateDreamAssignmentAndReturnAsString(results[i], &assignment, tPlayer);
+		variables[i] = getPlayerVariable(tPlayer, ASSIGNMENT_CHECK_VARIABLE);
+	}
+	destroyDreamMugenAssignment(assignment);
+
+	int ret = 1;
+	for (int i = 0; i < 2; i++) {
+		if ((tCase.mExpected && results[i] != tCase.mExpected) || variables[i] != tCase.mExpectedVariable) {
+			logWarningFormat("%s through the %s expected %s and var(1) = %d, got %s and var(1) = %d", tCase.mText, i ? "program" : "tree", tCase.mExpected ? tCase.mExpected : "any", tCase.mExpectedVariable, results[i].data(), variables[i]);
+			ret = 0;
+		}
+	}
+	return ret;
+}
+
+int main(int argc, char** argv) {
+	(void)argc;
+	(void)argv;
+
+	setMinimumLogType(LOG_TYPE_NORMAL);
+	setupDreamAssignmentEvaluator();
+	DreamPlayer* p = getStubDreamPlayer();
+
+	int caseAmount = 0;
+	int failureAmount = 0;
+	for (size_t i = 0; i < sizeof(gAssignmentCheckCases) / sizeof(gAssignmentCheckCases[0]); i++) {
+		const AssignmentCheckCase& e = gAssignmentCheckCases[i];
+		failureAmount += !checkAssignmentText(e.mFoldedText, e.mExpected, 1, p);
+		failureAmount += !checkAssignmentText(e.mRuntimeText, e.mExpected, 0, p);
+		caseAmount += 2;
+	}
+
+	for (size_t i = 0; i < sizeof(gAssignmentSideEffectCases) / sizeof(gAssignmentSideEffectCases[0]); i++) {
+		failureAmount += !checkAssignmentSideEffectCase(gAssignmentSideEffectCases[i], p);
+		caseAmount++;
+	}
+
+	failureAmount += !checkDreamMugenTriggerProfileReordering();
+	caseAmount++;
+
+	shutdownDreamAssignmentEvaluator();
+	printf("%d checks, %d failed\n", caseAmount, failureAmount);
+	return failureAmount ? 1 : 0;
+}
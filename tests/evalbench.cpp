@@ -0,0 +1,94 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <prism/log.h>
+
+#include "mugenassignment.h"
+#include "mugenassignmentevaluator.h"
+#include "playerdefinition.h"
+
+#include "stubplayer.h"
+
+using namespace std;
+
+typedef struct {
+	string mText;
+	string mExpected;
+	DreamMugenAssignment* mAssignment;
+	uint64_t mTreeNanoseconds;
+	uint64_t mProgramNanoseconds;
+} EvalBenchmarkExpression;
+
+// golden lines are the expected result and the trigger text separated by a tab
+static int loadEvalBenchmarkGolden(vector<EvalBenchmarkExpression>& oExpressions, const char* tPath) {
+	ifstream file(tPath);
+	if (!file) return 0;
+
+	string line;
+	while (getline(file, line)) {
+		size_t tab = line.find('\t');
+		if (line.empty() || tab == string::npos) continue;
+		EvalBenchmarkExpression e;
+		e.mExpected = line.substr(0, tab);
+		e.mText = line.substr(tab + 1);
+		oExpressions.push_back(e);
+	}
+	return 1;
+}
+
+static uint64_t timeEvalBenchmarkAssignment(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer, int tIterations) {
+	auto start = chrono::steady_clock::now();
+	for (int i = 0; i < tIterations; i++) {
+		evaluateDreamAssignment(tAssignment, tPlayer);
+	}
+	auto end = chrono::steady_clock::now();
+	return chrono::duration_cast<chrono::nanoseconds>(end - start).count() / tIterations;
+}
+
+int main(int argc, char** argv) {
+	if (argc < 2) {
+		printf("usage: evalbench <golden file> [iterations]\n");
+		return 2;
+	}
+	int iterations = argc >= 3 ? max(1, atoi(argv[2])) : 10000;
+
+	setMinimumLogType(LOG_TYPE_NORMAL);
+	setupDreamAssignmentEvaluator();
+	DreamPlayer* p = getStubDreamPlayer();
+
+	vector<EvalBenchmarkExpression> expressions;
+	if (!loadEvalBenchmarkGolden(expressions, argv[1])) {
+		printf("Unable to open %s\n", argv[1]);
+		return 2;
+	}
+
+	int mismatchAmount = 0;
+	uint64_t treeTotal = 0, programTotal = 0;
+	for (auto& e : expressions) {
+		e.mAssignment = parseDreamMugenAssignmentFromString(e.mText.data());
+		string treeResult, programResult;
+		evaluateDreamAssignmentAndReturnAsString(treeResult, &e.mAssignment, p);
+		e.mTreeNanoseconds = timeEvalBenchmarkAssignment(&e.mAssignment, p, iterations);
+
+		compileDreamAssignmentProgram(&e.mAssignment);
+		evaluateDreamAssignmentAndReturnAsString(programResult, &e.mAssignment, p);
+		e.mProgramNanoseconds = timeEvalBenchmarkAssignment(&e.mAssignment, p, iterations);
+		destroyDreamMugenAssignment(e.mAssignment);
+
+		if (treeResult != e.mExpected || programResult != e.mExpected) {
+			logWarningFormat("%s expected %s, tree returned %s, program returned %s", e.mText.data(), e.mExpected.data(), treeResult.data(), programResult.data());
+			mismatchAmount++;
+		}
+		treeTotal += e.mTreeNanoseconds;
+		programTotal += e.mProgramNanoseconds;
+		printf("%8llu ns tree %8llu ns program  %s\n", (unsigned long long)e.mTreeNanoseconds, (unsigned long long)e.mProgramNanoseconds, e.mText.data());
+	}
+
+	shutdownDreamAssignmentEvaluator();
+	printf("%d triggers: %llu ns tree, %llu ns program, %d mismatches against the golden results\n", int(expressions.size()), (unsigned long long)treeTotal, (unsigned long long)programTotal, mismatchAmount);
+	return mismatchAmount ? 1 : 0;
+}
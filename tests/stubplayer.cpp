@@ -0,0 +1,49 @@
+#include "stubplayer.h"
+
+#include <prism/datastructures.h>
+
+char romdisk_buffer[1];
+int romdisk_buffer_length;
+
+static struct {
+	int mIsLoaded;
+	DreamPlayerHeader mHeader;
+	DreamPlayer mPlayer;
+} gStubPlayerData;
+
+// only the fields read by the plain player getters are set, triggers that reach into stage, animation or state handlers are not supported
+void resetStubDreamPlayer()
+{
+	DreamPlayer* p = &gStubPlayerData.mPlayer;
+	if (!gStubPlayerData.mIsLoaded) {
+		p->mHeader = &gStubPlayerData.mHeader;
+		p->mRoot = p;
+		p->mOtherPlayer = p;
+		p->mHelpers = new_list();
+		p->mReceivedHitData = new_list();
+		p->mProjectiles = new_int_map();
+		p->mBoundHelpers = new_list();
+		gStubPlayerData.mIsLoaded = 1;
+	}
+
+	gStubPlayerData.mHeader.mFiles.mConstants.mHeader.mLife = 1000;
+	gStubPlayerData.mHeader.mFiles.mConstants.mHeader.mPower = 3000;
+	p->mLife = 750;
+	p->mPower = 1500;
+	p->mIsAlive = 1;
+	p->mIsInControl = 1;
+	p->mAILevel = 0;
+	p->mFaceDirection = FACE_DIRECTION_RIGHT;
+	for (int i = 0; i < 100; i++) {
+		p->mVars[i] = i * 10;
+		p->mSystemVars[i] = i;
+		p->mFloatVars[i] = i * 0.5;
+		p->mSystemFloatVars[i] = 0.0;
+	}
+}
+
+DreamPlayer* getStubDreamPlayer()
+{
+	if (!gStubPlayerData.mIsLoaded) resetStubDreamPlayer();
+	return &gStubPlayerData.mPlayer;
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+#include "playerdefinition.h"
+
+DreamPlayer* getStubDreamPlayer();
+void resetStubDreamPlayer();